@@ -18,6 +18,11 @@ CALL build.bat
 POPD
 IF %ERRORLEVEL% NEQ 0 (echo Error:%ERRORLEVEL% && exit)
 
+PUSHD packer
+CALL build.bat
+POPD
+IF %ERRORLEVEL% NEQ 0 (echo Error:%ERRORLEVEL% && exit)
+
 @REM REM engine
 @REM make -f "Makefile.engine.windows.mak" all
 @REM IF %ERRORLEVEL% NEQ 0 (echo Error: %ERRORLEVEL% && exit)
@@ -0,0 +1,23 @@
+#!/bin/bash
+# Build Everything
+set -e
+
+echo "Building everything..."
+
+pushd engine
+bash build.sh
+popd
+
+pushd testbed
+bash build.sh
+popd
+
+pushd tests
+bash build.sh
+popd
+
+pushd packer
+bash build.sh
+popd
+
+echo "All assemblies built successfully."
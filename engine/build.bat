@@ -15,7 +15,7 @@ SET assembly=engine
 SET compilerFlags=-g -shared -Wvarargs -Wall -Werror -Wno-c++11-compat-deprecated-writable-strings -Wno-writable-strings -Wno-missing-braces
 REM -Wall - Werror
 SET includeFlags=-Isrc -I%VULKAN_SDK%/Include
-SET linkerFlags=-luser32 -lvulkan-1 -L%VULKAN_SDK%/Lib
+SET linkerFlags=-luser32 -lsynchronization -lvulkan-1 -L%VULKAN_SDK%/Lib
 SET defines=-D_DEBUG -DDEXPORT -D_CRT_SECURE_NO_WARNINGS
 
 ECHO "Building %assembly%..."
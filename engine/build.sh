@@ -0,0 +1,18 @@
+#!/bin/bash
+# Build script for engine
+set -e
+
+mkdir -p ../bin
+
+# Get a list of all .cpp files
+cFilenames=$(find src -type f -name "*.cpp")
+
+assembly="engine"
+compilerFlags="-g -shared -fPIC -pthread -Wvarargs -Wall -Werror -Wno-c++11-compat-deprecated-writable-strings -Wno-writable-strings -Wno-missing-braces"
+# -Wall -Werror
+includeFlags="-Isrc -I$VULKAN_SDK/include"
+linkerFlags="-lvulkan -lxcb -lX11 -lX11-xcb -L$VULKAN_SDK/lib"
+defines="-D_DEBUG -DDEXPORT"
+
+echo "Building $assembly..."
+clang++ $cFilenames $compilerFlags -o ../bin/lib$assembly.so $defines $includeFlags $linkerFlags
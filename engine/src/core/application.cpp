@@ -5,9 +5,15 @@
 #include "core/dmemory.h"
 #include "core/event.h"
 #include "core/input.h"
+#include "core/input_recording.h"
+#include "core/input_actions.h"
 #include "core/clock.h"
+#include "core/frame_limiter.h"
 #include "memory/linear_allocator.h"
+#include "platform/async_io.h"
+#include "platform/filesystem.h"
 #include "renderer/renderer_frontend.h"
+#include "renderer/null/null_backend.h"
 
 struct ApplicationState{
     Game* gameInst;
@@ -17,6 +23,7 @@ struct ApplicationState{
     i16 height;
     Clock clock;
     f64 lastTime;
+    FrameLimiter frameLimiter;
     LinearAllocator systemsAllocator;
 
     u64 eventSystemMemoryRequirement;
@@ -31,9 +38,18 @@ struct ApplicationState{
     u64 inputSystemMemoryRequirement;
     void* inputSystemState;
 
+    u64 inputActionsMemoryRequirement;
+    void* inputActionsState;
+
+    u64 inputRecordingMemoryRequirement;
+    void* inputRecordingState;
+
     u64 platformSystemMemoryRequirement;
     void* platformSystemState;
 
+    u64 asyncIoMemoryRequirement;
+    void* asyncIoState;
+
     u64 rendererSystemMemoryRequirement;
     void* rendererSystemState;
 };
@@ -56,47 +72,82 @@ b8 ApplicationCreate(Game* gameInst){
     appState->gameInst = gameInst;
     appState->isRunning = false;
     appState->isSuspended = false;
+    //resizes are queued now, so start from the configured size rather than waiting for the first dispatch
+    appState->width = gameInst->appConfig.startWidth;
+    appState->height = gameInst->appConfig.startHeight;
 
+    //system states are placed back to back, aligned so ones holding SIMD math types are safe wherever they land
     u64 systemsAllocatorTotalSize = MegaBytes(64);
     AllocatorCreate(systemsAllocatorTotalSize, 0, &appState->systemsAllocator);
 
     EventSystemInitialize(&appState->eventSystemMemoryRequirement, 0);
-    appState->eventSystemState = AllocatorAllocate(&appState->systemsAllocator, appState->eventSystemMemoryRequirement);
+    appState->eventSystemState = AllocatorAllocateAligned(&appState->systemsAllocator, appState->eventSystemMemoryRequirement, 16);
     EventSystemInitialize(&appState->eventSystemMemoryRequirement, appState->eventSystemState);
 
     MemorySystemInitialize(&appState->memorySystemMemoryRequirement, 0);
-    appState->memorySystemState = AllocatorAllocate(&appState->systemsAllocator, appState->memorySystemMemoryRequirement);
+    appState->memorySystemState = AllocatorAllocateAligned(&appState->systemsAllocator, appState->memorySystemMemoryRequirement, 16);
     MemorySystemInitialize(&appState->memorySystemMemoryRequirement, appState->memorySystemState);
 
     //init subsystems
     InitializeLogging(&appState->loggingSystemMemoryRequirement, 0);
-    appState->loggingSystemState = AllocatorAllocate(&appState->systemsAllocator, appState->loggingSystemMemoryRequirement);
+    appState->loggingSystemState = AllocatorAllocateAligned(&appState->systemsAllocator, appState->loggingSystemMemoryRequirement, 16);
     if(!InitializeLogging(&appState->loggingSystemMemoryRequirement, appState->loggingSystemState)){
         DERROR("Failed to initialize logging system. Shutting down.");
         return false;
     }
+    //before anything holds on to ticks, the source can change here
+    ClockCalibrateTicks();
 
     InputSystemInitialize(&appState->inputSystemMemoryRequirement, 0);
-    appState->inputSystemState = AllocatorAllocate(&appState->systemsAllocator, appState->inputSystemMemoryRequirement);
+    appState->inputSystemState = AllocatorAllocateAligned(&appState->systemsAllocator, appState->inputSystemMemoryRequirement, 16);
     InputSystemInitialize(&appState->inputSystemMemoryRequirement, appState->inputSystemState);
+    InputActionsInitialize(&appState->inputActionsMemoryRequirement, 0);
+    appState->inputActionsState = AllocatorAllocateAligned(&appState->systemsAllocator, appState->inputActionsMemoryRequirement, 16);
+    InputActionsInitialize(&appState->inputActionsMemoryRequirement, appState->inputActionsState);
+    InputRecordingInitialize(&appState->inputRecordingMemoryRequirement, 0);
+    appState->inputRecordingState = AllocatorAllocateAligned(&appState->systemsAllocator, appState->inputRecordingMemoryRequirement, 16);
+    InputRecordingInitialize(&appState->inputRecordingMemoryRequirement, appState->inputRecordingState);
+    if(gameInst->appConfig.inputPlaybackPath){
+        if(!InputPlaybackStart(gameInst->appConfig.inputPlaybackPath)){
+            return false;
+        }
+    } else if(gameInst->appConfig.inputRecordPath){
+        InputRecordingStart(gameInst->appConfig.inputRecordPath);
+    }
 
-    EventRegister(EVENT_CODE_APPLICATION_QUIT, 0, ApplicationOnEvent);
-    EventRegister(EVENT_CODE_KEY_PRESSED, 0, ApplicationOnKey);
-    EventRegister(EVENT_CODE_KEY_RELEASED, 0, ApplicationOnKey);
-    EventRegister(EVENT_CODE_RESIZED, 0, ApplicationOnResized);
+    EventRegister(EVENT_CODE_APPLICATION_QUIT, 0, ApplicationOnEvent, EVENT_PRIORITY_NORMAL);
+    EventRegister(EVENT_CODE_KEY_PRESSED, 0, ApplicationOnKey, EVENT_PRIORITY_NORMAL);
+    EventRegister(EVENT_CODE_KEY_RELEASED, 0, ApplicationOnKey, EVENT_PRIORITY_NORMAL);
+    EventRegister(EVENT_CODE_RESIZED, 0, ApplicationOnResized, EVENT_PRIORITY_NORMAL);
 
-    PlatformSystemStartup(&appState->platformSystemMemoryRequirement, 0, 0, 0, 0, 0, 0);
-    appState->platformSystemState = AllocatorAllocate(&appState->systemsAllocator, appState->platformSystemMemoryRequirement);
-    PlatformSystemStartup(
+    PlatformSystemStartup(&appState->platformSystemMemoryRequirement, 0, 0, 0, 0, 0, 0, false);
+    appState->platformSystemState = AllocatorAllocateAligned(&appState->systemsAllocator, appState->platformSystemMemoryRequirement, 16);
+    if(!PlatformSystemStartup(
         &appState->platformSystemMemoryRequirement,
         appState->platformSystemState, 
         gameInst->appConfig.name, 
         gameInst->appConfig.startPosX, gameInst->appConfig.startPosY, 
-        gameInst->appConfig.startWidth, gameInst->appConfig.startHeight);
+        gameInst->appConfig.startWidth, gameInst->appConfig.startHeight,
+        gameInst->appConfig.headless)){
+        DFATAL("Failed to start the platform layer. aborting application");
+        return false;
+    }
 
-    RendererSystemInitialize(&appState->rendererSystemMemoryRequirement, 0, 0);
-    appState->rendererSystemState = AllocatorAllocate(&appState->systemsAllocator, appState->rendererSystemMemoryRequirement);
-    if(!RendererSystemInitialize(&appState->rendererSystemMemoryRequirement, appState->rendererSystemState, gameInst->appConfig.name)){
+    AsyncIoInitialize(&appState->asyncIoMemoryRequirement, 0, ASYNC_IO_BACKEND_AUTO);
+    appState->asyncIoState = AllocatorAllocateAligned(&appState->systemsAllocator, appState->asyncIoMemoryRequirement, 16);
+    AsyncIoInitialize(&appState->asyncIoMemoryRequirement, appState->asyncIoState, ASYNC_IO_BACKEND_AUTO);
+
+    char* packPath = gameInst->appConfig.assetPackPath;
+    if(packPath && FileSystemExists(packPath)){
+        FileSystemMountPack(packPath);
+    } else if(packPath){
+        DINFO("No asset pack at '%s', loading loose asset files.", packPath);
+    }
+
+    RendererBackendType rendererType = gameInst->appConfig.headless ? RENDERER_BACKEND_TYPE_NULL : RENDERER_BACKEND_TYPE_VULKAN;
+    RendererSystemInitialize(&appState->rendererSystemMemoryRequirement, 0, 0, rendererType);
+    appState->rendererSystemState = AllocatorAllocateAligned(&appState->systemsAllocator, appState->rendererSystemMemoryRequirement, 16);
+    if(!RendererSystemInitialize(&appState->rendererSystemMemoryRequirement, appState->rendererSystemState, gameInst->appConfig.name, rendererType)){
         DFATAL("Failed to initialize renderer. aborting application");
         return false;
     }
@@ -117,21 +168,55 @@ b8 ApplicationRun(){
     ClockStart(&appState->clock);
     ClockUpdate(&appState->clock);
     appState->lastTime = appState->clock.elapsed;
-    f64 runningTime = 0;
-    u8 frameCount = 0;
-    f64 targetFrameSeconds = 1.0f / 60.0f;
+    FrameLimiterInit(&appState->frameLimiter, appState->gameInst->appConfig.targetFrameRate);
+#if DEVENT_INSTRUMENTATION
+    f64 eventStatsTimer = 0;
+#endif
+
+    u32 frameNumber = 0;
+    f64 playbackDelta = 0;
+    f64 playbackFrameMin = 1000.0;
+    f64 playbackFrameMax = 0;
+    f64 playbackFrameTotal = 0;
+    u32 playbackFrames = 0;
 
     DINFO(GetMemoryUsageStr());
     while(appState->isRunning){
+        //playback still pumps so the window keeps responding, but only the recorded input gets through
+        b8 playbackActive = InputPlaybackIsActive();
+        InputSetMuted(playbackActive);
         if(!PlatformPumpMessages()){
             appState->isRunning = false;
         }
+        InputSetMuted(false);
+        if(playbackActive){
+            if(!InputPlaybackFrame(&playbackDelta)){
+                if(playbackFrames){
+                    DINFO("Input playback finished: %u frames, frame time avg %.3f ms, min %.3f ms, max %.3f ms",
+                          playbackFrames, playbackFrameTotal / playbackFrames * 1000.0,
+                          playbackFrameMin * 1000.0, playbackFrameMax * 1000.0);
+                }
+                appState->isRunning = false;
+                break;
+            }
+        }
+        //reads that finished since last frame post their events in time for this dispatch
+        AsyncIoUpdate();
+        //everything posted since last frame, including input gathered by the pump above
+        EventDispatchQueued();
 
         if(!appState->isSuspended){
             ClockUpdate(&appState->clock);
             f64 currentTime = appState->clock.elapsed;
             f64 delta = currentTime - appState->lastTime;
-            f64 frameStartTime = PlatformGetAbsoluteTime();
+            b8 playingBack = InputPlaybackIsActive();
+            if(playingBack){
+                delta = playbackDelta;
+            }
+            u64 frameStartTicks = ClockGetTicks();
+
+            //actions see the input pumped and dispatched this frame, gameplay reads them during Update
+            InputActionsUpdate();
 
             if(!appState->gameInst->Update(appState->gameInst, (f32)delta)){
                 DFATAL("Game update failed, shutting down.");
@@ -148,34 +233,62 @@ b8 ApplicationRun(){
             packet.delta_time = delta;
             RendererDrawFrame(&packet);
 
-            f64 frameEndTime = PlatformGetAbsoluteTime();
-            f64 frameElapsedTime = frameEndTime - frameStartTime;
-            runningTime += frameElapsedTime;
-            f64 remainingSeconds = targetFrameSeconds - frameElapsedTime;
-
-            if(remainingSeconds > 0){
-                u64 remainingMs = remainingSeconds * 1000;
-                b8 limitFrames = false;
-                if(remainingMs > 0 && limitFrames){
-                    PlatformSleep(remainingMs - 1);
-                }
-                frameCount++;
+            f64 frameElapsedTime = ClockTicksToSeconds(ClockGetTicks() - frameStartTicks);
+            if(playingBack){
+                playbackFrameTotal += frameElapsedTime;
+                playbackFrameMin = Minimum(playbackFrameMin, frameElapsedTime);
+                playbackFrameMax = Maximum(playbackFrameMax, frameElapsedTime);
+                playbackFrames++;
             }
 
+            FrameLimiterWait(&appState->frameLimiter);
+
             //Input update/state copying should be handled after any input should be recorded (before this line)
             //As a safety input is the last thing to be updated before frame flip
+            InputRecordFrame(frameNumber++, delta);
             InputUpdate(delta);
 
+            if(appState->gameInst->appConfig.maxFrames && frameNumber >= appState->gameInst->appConfig.maxFrames){
+                appState->isRunning = false;
+            }
+
+#if DEVENT_INSTRUMENTATION
+            eventStatsTimer += delta;
+            if(eventStatsTimer >= EVENT_STATS_LOG_INTERVAL){
+                EventLogStats();
+                eventStatsTimer = 0;
+            }
+#endif
+
             appState->lastTime = currentTime;
         }
     }
 
     appState->isRunning = false;
+    FrameLimiterStats frameStats;
+    FrameLimiterGetStats(&appState->frameLimiter, &frameStats);
+    if(frameStats.frames){
+        DINFO("Frame pacing (target %.1f Hz): frame time avg %.3f ms, max %.3f ms, jitter %.3f ms, %u missed, worst wake %.3f ms late, %.1f s slept, %.1f s spun",
+              appState->gameInst->appConfig.targetFrameRate, frameStats.mean_frame_seconds * 1000.0,
+              frameStats.max_frame_seconds * 1000.0, frameStats.jitter_seconds * 1000.0, frameStats.missed_deadlines,
+              frameStats.max_pacing_error_seconds * 1000.0, frameStats.sleep_seconds, frameStats.spin_seconds);
+    }
+    if(appState->gameInst->appConfig.headless){
+        NullRendererStats rendererStats;
+        NullRendererGetStats(&rendererStats);
+        DINFO("Headless run finished after %u frames: %llu frames drawn, %llu objects, %llu textures created, %llu renderer validation errors",
+              frameNumber, rendererStats.end_frame_calls, rendererStats.update_object_calls,
+              rendererStats.create_texture_calls, rendererStats.validation_errors);
+    }
+    InputRecordingShutdown(&appState->inputRecordingState);
     EventUnregister(EVENT_CODE_APPLICATION_QUIT, 0, ApplicationOnEvent);
     EventUnregister(EVENT_CODE_KEY_PRESSED, 0, ApplicationOnKey);
     EventUnregister(EVENT_CODE_KEY_RELEASED, 0, ApplicationOnKey);
     EventUnregister(EVENT_CODE_RESIZED, 0, ApplicationOnResized);
+    AsyncIoShutdown(&appState->asyncIoState);
+    FileSystemUnmountPacks();
     EventSystemShutdown(&appState->eventSystemState);
+    InputActionsShutdown(&appState->inputActionsState);
     InputSystemShutdown(&appState->inputSystemState);
     RendererSystemShutdown(&appState->rendererSystemState);
     PlatformSystemShutdown(&appState->platformSystemState);
@@ -205,7 +318,7 @@ b8 ApplicationOnKey(u16 code, void* sender, void* listenerInst, EventContext con
         switch(keyCode){
             case KEY_ESCAPE:{
                 EventContext data = {};
-                EventFire(EVENT_CODE_APPLICATION_QUIT, 0, data);
+                EventPost(EVENT_CODE_APPLICATION_QUIT, 0, data);
                 return true;
             }
             case KEY_A: {
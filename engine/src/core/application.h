@@ -10,6 +10,17 @@ struct ApplicationConfig{
     i16 startWidth;
     i16 startHeight;
     char* name;
+    //input session to write, or to replay instead of pumping platform messages. 0 for neither
+    char* inputRecordPath;
+    char* inputPlaybackPath;
+    //no window and the null renderer, for running the frame loop on machines with no display or GPU
+    b8 headless;
+    //stop after this many frames, 0 runs until quit
+    u32 maxFrames;
+    //frames per second the loop is paced to, 0 runs unlimited
+    f32 targetFrameRate;
+    //asset pack searched before loose files, 0 or a missing file loads everything loose
+    char* assetPackPath;
 };
 
 DAPI b8 ApplicationCreate(Game* gameInst);
@@ -1,17 +1,115 @@
 #include "clock.h"
+#include "core/logger.h"
 #include "platform/platform.h"
 
+#if defined(__x86_64__) || defined(_M_X64)
+    #define DCLOCK_TSC 1
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+    #else
+        #include <x86intrin.h>
+        #include <cpuid.h>
+    #endif
+#else
+    #define DCLOCK_TSC 0
+#endif
+
+//how long calibration compares the two clocks for, the error is the OS clock's read jitter over this
+#define CLOCK_CALIBRATION_SECONDS 0.02
+
+struct TickState{
+    b8 useTsc;
+    u64 ticksPerSecond;
+    f64 secondsPerTick;
+};
+
+static TickState tickState;
+
+#if DCLOCK_TSC
+static b8 TscIsInvariant(){
+    u32 regs[4] = {};
+#if defined(_MSC_VER) && !defined(__clang__)
+    __cpuid((int*)regs, 0x80000000);
+    if(regs[0] < 0x80000007){
+        return false;
+    }
+    __cpuid((int*)regs, 0x80000007);
+#else
+    if(!__get_cpuid(0x80000007, &regs[0], &regs[1], &regs[2], &regs[3])){
+        return false;
+    }
+#endif
+    //edx bit 8, the TSC ticks at a constant rate in every P/C state and is synced between cores
+    return (regs[3] >> 8) & 1;
+}
+#endif
+
 void ClockUpdate(Clock* clock){
-    if(clock->startTime != 0){
-        clock->elapsed = PlatformGetAbsoluteTime() - clock->startTime;
+    if(clock->startTicks != 0){
+        clock->elapsed = ClockTicksToSeconds(ClockGetTicks() - clock->startTicks);
     }
 }
 
 void ClockStart(Clock* clock){
-    clock->startTime = PlatformGetAbsoluteTime();
+    clock->startTicks = ClockGetTicks();
     clock->elapsed = 0;
 }
 
 void ClockStop(Clock* clock){
-    clock->startTime = 0;
-}
\ No newline at end of file
+    clock->startTicks = 0;
+}
+
+void ClockCalibrateTicks(){
+    tickState.useTsc = false;
+    tickState.ticksPerSecond = PlatformGetOsTickFrequency();
+#if DCLOCK_TSC
+    if(TscIsInvariant()){
+        u64 osFrequency = tickState.ticksPerSecond;
+        u64 osStart = PlatformGetOsTicks();
+        u64 tscStart = __rdtsc();
+        u64 osTarget = osStart + (u64)(CLOCK_CALIBRATION_SECONDS * osFrequency);
+        u64 osEnd;
+        u64 tscEnd;
+        //spin rather than sleep so both reads at the end are back to back
+        do{
+            osEnd = PlatformGetOsTicks();
+            tscEnd = __rdtsc();
+        } while(osEnd < osTarget);
+        u64 tscFrequency = (u64)((f64)(tscEnd - tscStart) * osFrequency / (f64)(osEnd - osStart));
+        if(tscFrequency > 0){
+            tickState.useTsc = true;
+            tickState.ticksPerSecond = tscFrequency;
+        }
+    }
+#endif
+    tickState.secondsPerTick = 1.0 / (f64)tickState.ticksPerSecond;
+    DINFO("Tick clock: %s at %llu ticks per second", tickState.useTsc ? "invariant TSC" : "OS counter", tickState.ticksPerSecond);
+}
+
+u64 ClockGetTicks(){
+#if DCLOCK_TSC
+    if(tickState.useTsc){
+        return __rdtsc();
+    }
+#endif
+    return PlatformGetOsTicks();
+}
+
+u64 ClockTicksPerSecond(){
+    if(!tickState.ticksPerSecond){
+        //not calibrated, ticks are the OS counter's
+        return PlatformGetOsTickFrequency();
+    }
+    return tickState.ticksPerSecond;
+}
+
+f64 ClockTicksToSeconds(u64 ticks){
+    if(!tickState.secondsPerTick){
+        return (f64)ticks / (f64)PlatformGetOsTickFrequency();
+    }
+    return (f64)ticks * tickState.secondsPerTick;
+}
+
+b8 ClockTicksUseTsc(){
+    return tickState.useTsc;
+}
@@ -3,7 +3,7 @@
 #include "defines.h"
 
 struct Clock{
-    f64 startTime;
+    u64 startTicks;
     f64 elapsed;
 };
 
@@ -14,4 +14,19 @@ DAPI void ClockUpdate(Clock* clock);
 DAPI void ClockStart(Clock* clock);
 
 //doesnt reset elapsed time
-DAPI void ClockStop(Clock* clock);
\ No newline at end of file
+DAPI void ClockStop(Clock* clock);
+
+/*
+Raw ticks for timing things that happen too often to pay for PlatformGetAbsoluteTime. On x86 with an invariant
+TSC (constant rate across power states and cores) a tick is one rdtsc count, roughly 20 cycles to read, otherwise
+it falls back to the OS monotonic counter. Only differences between ticks mean anything, convert those to
+seconds when reporting.
+ClockCalibrateTicks measures the TSC against the OS clock (about 20ms) and picks the source. Call it once at
+startup, ticks taken before it are OS counter ticks and can't be mixed with ticks taken after.
+*/
+DAPI void ClockCalibrateTicks();
+DAPI u64 ClockGetTicks();
+DAPI u64 ClockTicksPerSecond();
+DAPI f64 ClockTicksToSeconds(u64 ticks);
+//True when ticks come from the TSC
+DAPI b8 ClockTicksUseTsc();
@@ -0,0 +1,517 @@
+#include "core/compression.h"
+
+#include "core/datomic.h"
+#include "core/dmemory.h"
+#include "core/logger.h"
+#include "platform/threading.h"
+
+#include <string.h>
+
+//positions remembered by the match finder, 16KiB of table, small enough to stay in L1 while a block is compressed
+#define LZ_HASH_BITS 12
+#define LZ_MIN_MATCH 4
+//the format's end of block rules, kept so other LZ4 decoders can read these blocks: the last 5 bytes are always
+//literals and no match starts within 12 bytes of the end
+#define LZ_LAST_LITERALS 5
+#define LZ_MATCH_FIND_LIMIT 12
+#define LZ_MAX_OFFSET 65535
+//how far past the end of a copy WildCopy16 may read and write
+#define LZ_WILDCOPY_MARGIN 16
+//threads the stream functions will start, no matter what they are asked for
+#define COMPRESSION_MAX_THREADS 16
+
+DINLINE u32 Read32(u8* p) {
+    u32 value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+DINLINE u64 Read64(u8* p) {
+    u64 value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+DINLINE u32 HashSequence(u32 sequence) {
+    return (sequence * 2654435761U) >> (32 - LZ_HASH_BITS);
+}
+
+//The 15 in the token is already counted, the rest follows as bytes of 255 and a final smaller one
+static u8* WriteLength(u8* out, u64 length) {
+    length -= 15;
+    while (length >= 255) {
+        *out++ = 255;
+        length -= 255;
+    }
+    *out++ = (u8)length;
+    return out;
+}
+
+DINLINE b8 ReadLength(u8** in, u8* in_end, u64* length) {
+    u8 byte;
+    do {
+        if (*in >= in_end) {
+            return false;
+        }
+        byte = *(*in)++;
+        *length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+//Copies at least 16 bytes and up to 15 past dest_end. Reading what an earlier chunk just wrote is fine, that's
+//what an overlapping match means, as long as a single chunk never overlaps itself (src at least 16 bytes back)
+DINLINE void WildCopy16(u8* dest, u8* src, u8* dest_end) {
+    do {
+        memcpy(dest, src, 16);
+        dest += 16;
+        src += 16;
+    } while (dest < dest_end);
+}
+
+u64 CompressBlockBound(u64 size) {
+    return size + size / 255 + 16;
+}
+
+u64 CompressBlock(void* source, u64 size, void* destination, u64 capacity) {
+    u8* src = (u8*)source;
+    u8* end = src + size;
+    u8* anchor = src;
+    u8* out = (u8*)destination;
+    u8* out_end = out + capacity;
+
+    if (size > LZ_MATCH_FIND_LIMIT) {
+        u32 table[1 << LZ_HASH_BITS];
+        memset(table, 0, sizeof(table));
+        u8* match_start_limit = end - LZ_MATCH_FIND_LIMIT;
+        u8* match_end_limit = end - LZ_LAST_LITERALS;
+        u8* ip = src + 1;
+        while (ip <= match_start_limit) {
+            u32 sequence = Read32(ip);
+            u32 hash = HashSequence(sequence);
+            u8* ref = src + table[hash];
+            table[hash] = (u32)(ip - src);
+            if (ip - ref > LZ_MAX_OFFSET || Read32(ref) != sequence) {
+                //step faster through data that isn't matching, it is probably not going to start now
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+            while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+                ip--;
+                ref--;
+            }
+            u8* match_end = ip + LZ_MIN_MATCH;
+            u8* ref_end = ref + LZ_MIN_MATCH;
+            while (match_end + 8 <= match_end_limit) {
+                u64 difference = Read64(match_end) ^ Read64(ref_end);
+                if (difference) {
+                    match_end += __builtin_ctzll(difference) >> 3;
+                    goto match_found;
+                }
+                match_end += 8;
+                ref_end += 8;
+            }
+            while (match_end < match_end_limit && *match_end == *ref_end) {
+                match_end++;
+                ref_end++;
+            }
+        match_found:
+            u64 literal_length = ip - anchor;
+            u64 match_length = match_end - ip - LZ_MIN_MATCH;
+            if ((u64)(out_end - out) < 1 + literal_length / 255 + 1 + literal_length + 2 + match_length / 255 + 1) {
+                return 0;
+            }
+            u8* token = out++;
+            *token = (u8)((literal_length >= 15 ? 15 : literal_length) << 4);
+            if (literal_length >= 15) {
+                out = WriteLength(out, literal_length);
+            }
+            memcpy(out, anchor, literal_length);
+            out += literal_length;
+            u64 offset = ip - ref;
+            out[0] = (u8)offset;
+            out[1] = (u8)(offset >> 8);
+            out += 2;
+            *token |= (u8)(match_length >= 15 ? 15 : match_length);
+            if (match_length >= 15) {
+                out = WriteLength(out, match_length);
+            }
+            ip = match_end;
+            anchor = ip;
+            //the end of a match is a likely start of the next one's source
+            if (ip <= match_start_limit) {
+                table[HashSequence(Read32(ip - 2))] = (u32)(ip - 2 - src);
+            }
+        }
+    }
+
+    u64 literal_length = end - anchor;
+    if ((u64)(out_end - out) < 1 + literal_length / 255 + 1 + literal_length) {
+        return 0;
+    }
+    u8* token = out++;
+    *token = (u8)((literal_length >= 15 ? 15 : literal_length) << 4);
+    if (literal_length >= 15) {
+        out = WriteLength(out, literal_length);
+    }
+    memcpy(out, anchor, literal_length);
+    out += literal_length;
+    return out - (u8*)destination;
+}
+
+//Copies a match that may overlap its own output. Chunked copies run past the match but stop short of op_end,
+//whatever they can't reach is done a byte at a time
+DINLINE void CopyMatch(u8* op, u64 offset, u64 match_length, u8* op_end) {
+    u8* match = op - offset;
+    u8* match_op_end = op + match_length;
+    if (offset >= 16 && (u64)(op_end - match_op_end) >= LZ_WILDCOPY_MARGIN) {
+        WildCopy16(op, match, match_op_end);
+        return;
+    }
+    if (op_end - op >= 16) {
+        //copies go 8 bytes at a time and may run past the match, up to 8 bytes short of the end of the output
+        u8* wild_end = match_op_end < op_end - 8 ? match_op_end : op_end - 8;
+        if (offset < 8) {
+            //overlapping, the match repeats with period offset. The first 8 bytes go through the tables,
+            //which also move match back far enough that 8 byte copies read a whole period
+            static const u32 increment[8] = {0, 1, 2, 1, 0, 4, 4, 4};
+            static const i32 decrement[8] = {0, 0, 0, -1, -4, 1, 2, 3};
+            op[0] = match[0];
+            op[1] = match[1];
+            op[2] = match[2];
+            op[3] = match[3];
+            match += increment[offset];
+            memcpy(op + 4, match, 4);
+            match -= decrement[offset];
+        } else {
+            memcpy(op, match, 8);
+            match += 8;
+        }
+        op += 8;
+        if (op - match == 8) {
+            //a period of 1, 2, 4 or 8, runs of one color or pixel. The 8 bytes just written repeat, storing them
+            //from a register skips waiting on each store to read it back
+            u64 pattern = Read64(match);
+            while (op < wild_end) {
+                memcpy(op, &pattern, 8);
+                op += 8;
+            }
+            match = op - 8;
+        } else {
+            while (op < wild_end) {
+                memcpy(op, match, 8);
+                op += 8;
+                match += 8;
+            }
+        }
+    }
+    while (op < match_op_end) {
+        *op++ = *match++;
+    }
+}
+
+b8 DecompressBlock(void* source, u64 source_size, void* destination, u64 size) {
+    u8* ip = (u8*)source;
+    u8* ip_end = ip + source_size;
+    u8* dst = (u8*)destination;
+    u8* op = dst;
+    u8* op_end = op + size;
+
+    while (ip < ip_end) {
+        u32 token = *ip++;
+        u64 literal_length = token >> 4;
+        u64 match_length = token & 15;
+        if (literal_length < 15 && match_length < 15 && ip_end - ip >= 16 && op_end - op >= 32) {
+            //the usual sequence, a few literals then a short match, away from both ends. At most 14 literals and the
+            //offset fit in the 16 bytes of input, the 14 literals and an 18 byte match in the 32 of output, so fixed
+            //size copies replace the length checks. What they write past the sequence gets overwritten by the next
+            memcpy(op, ip, 16);
+            op += literal_length;
+            ip += literal_length;
+            u64 offset = ip[0] | ((u64)ip[1] << 8);
+            ip += 2;
+            if (offset == 0 || offset > (u64)(op - dst)) {
+                return false;
+            }
+            match_length += LZ_MIN_MATCH;
+            if (offset >= 8) {
+                //8 bytes at a time never reads what the same copy writes
+                u8* match = op - offset;
+                memcpy(op, match, 8);
+                memcpy(op + 8, match + 8, 8);
+                memcpy(op + 16, match + 16, 2);
+            } else {
+                CopyMatch(op, offset, match_length, op_end);
+            }
+            op += match_length;
+            continue;
+        }
+
+        if (literal_length == 15 && !ReadLength(&ip, ip_end, &literal_length)) {
+            return false;
+        }
+        if (literal_length > (u64)(ip_end - ip) || literal_length > (u64)(op_end - op)) {
+            return false;
+        }
+        //long runs copy in whole chunks too unless they are near the end of either buffer, where the last
+        //literals are
+        if ((u64)(ip_end - ip) - literal_length >= LZ_WILDCOPY_MARGIN &&
+            (u64)(op_end - op) - literal_length >= LZ_WILDCOPY_MARGIN) {
+            WildCopy16(op, ip, op + literal_length);
+        } else {
+            memcpy(op, ip, literal_length);
+        }
+        ip += literal_length;
+        op += literal_length;
+        if (ip == ip_end) {
+            //the last sequence is literals only
+            break;
+        }
+
+        if (ip_end - ip < 2) {
+            return false;
+        }
+        u64 offset = ip[0] | ((u64)ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (u64)(op - dst)) {
+            return false;
+        }
+        if (match_length == 15 && !ReadLength(&ip, ip_end, &match_length)) {
+            return false;
+        }
+        match_length += LZ_MIN_MATCH;
+        if (match_length > (u64)(op_end - op)) {
+            return false;
+        }
+        CopyMatch(op, offset, match_length, op_end);
+        op += match_length;
+    }
+    return op == op_end;
+}
+
+DINLINE u64 BlockCount(u64 size) {
+    return (size + COMPRESSION_BLOCK_SIZE - 1) / COMPRESSION_BLOCK_SIZE;
+}
+
+u64 CompressStreamBound(u64 size) {
+    return sizeof(CompressionStreamHeader) + BlockCount(size) * sizeof(u32) + size;
+}
+
+static b8 StreamHeaderValid(void* source, u64 source_size) {
+    CompressionStreamHeader* header = (CompressionStreamHeader*)source;
+    return source_size >= sizeof(CompressionStreamHeader) && header->magic == COMPRESSION_STREAM_MAGIC &&
+           header->block_size == COMPRESSION_BLOCK_SIZE;
+}
+
+u64 CompressStreamContentSize(void* source, u64 source_size) {
+    return StreamHeaderValid(source, source_size) ? ((CompressionStreamHeader*)source)->content_size : 0;
+}
+
+//Shared by the threads working on one stream, each takes the next block until there are none left
+struct CompressionJob {
+    u8* source;
+    u8* destination;
+    u64 content_size;
+    //where each block's stored header starts in the compressed stream
+    u64* block_offsets;
+    u32 block_count;
+    u32 next_block;
+    u32 failed;
+    b8 compress;
+};
+
+static void CompressStreamBlock(CompressionJob* job, u32 block) {
+    u64 start = (u64)block * COMPRESSION_BLOCK_SIZE;
+    u64 length = job->content_size - start < COMPRESSION_BLOCK_SIZE ? job->content_size - start : COMPRESSION_BLOCK_SIZE;
+    u8* out = job->destination + job->block_offsets[block];
+    //only worth keeping when it shrinks, otherwise the block is stored as is
+    u64 stored = CompressBlock(job->source + start, length, out + sizeof(u32), length - 1);
+    u32 block_header = (u32)stored;
+    if (stored == 0) {
+        memcpy(out + sizeof(u32), job->source + start, length);
+        block_header = (u32)length | COMPRESSION_BLOCK_UNCOMPRESSED;
+    }
+    memcpy(out, &block_header, sizeof(u32));
+}
+
+static b8 DecompressStreamBlock(u8* block, u64 available, u8* destination, u64 length) {
+    u32 block_header = Read32(block);
+    u64 stored = block_header & ~COMPRESSION_BLOCK_UNCOMPRESSED;
+    if (stored > available - sizeof(u32)) {
+        return false;
+    }
+    if (block_header & COMPRESSION_BLOCK_UNCOMPRESSED) {
+        if (stored != length) {
+            return false;
+        }
+        memcpy(destination, block + sizeof(u32), length);
+        return true;
+    }
+    return DecompressBlock(block + sizeof(u32), stored, destination, length);
+}
+
+static void CompressionJobRun(CompressionJob* job) {
+    for (;;) {
+        u32 block = AtomicFetchAddU32(&job->next_block, 1);
+        if (block >= job->block_count || AtomicLoadU32(&job->failed)) {
+            return;
+        }
+        if (job->compress) {
+            CompressStreamBlock(job, block);
+        } else {
+            u64 start = (u64)block * COMPRESSION_BLOCK_SIZE;
+            u64 length = job->content_size - start < COMPRESSION_BLOCK_SIZE ? job->content_size - start : COMPRESSION_BLOCK_SIZE;
+            u64 available = job->block_offsets[block + 1] - job->block_offsets[block];
+            if (!DecompressStreamBlock(job->source + job->block_offsets[block], available, job->destination + start, length)) {
+                AtomicStoreU32(&job->failed, 1);
+            }
+        }
+    }
+}
+
+static u32 CompressionJobThreadStart(void* params) {
+    CompressionJobRun((CompressionJob*)params);
+    return 0;
+}
+
+//Runs the job on the calling thread and up to thread_count - 1 helpers. A helper that can't be started only
+//means fewer hands, the calling thread finishes whatever is left
+static void CompressionJobExecute(CompressionJob* job, u32 thread_count) {
+    if (thread_count > COMPRESSION_MAX_THREADS) {
+        thread_count = COMPRESSION_MAX_THREADS;
+    }
+    if (thread_count > job->block_count) {
+        thread_count = job->block_count;
+    }
+    Thread helpers[COMPRESSION_MAX_THREADS];
+    u32 helper_count = 0;
+    for (u32 i = 1; i < thread_count; i++) {
+        if (ThreadCreate(CompressionJobThreadStart, job, false, &helpers[helper_count])) {
+            helper_count++;
+        }
+    }
+    CompressionJobRun(job);
+    for (u32 i = 0; i < helper_count; i++) {
+        ThreadJoin(&helpers[i], 0);
+    }
+}
+
+u64 CompressStream(void* source, u64 size, void* destination, u64 capacity, u32 thread_count) {
+    if (capacity < CompressStreamBound(size)) {
+        DERROR("CompressStream - destination holds %llu bytes, it needs %llu.", capacity, CompressStreamBound(size));
+        return 0;
+    }
+    u8* dst = (u8*)destination;
+    CompressionStreamHeader header = {};
+    header.magic = COMPRESSION_STREAM_MAGIC;
+    header.block_size = COMPRESSION_BLOCK_SIZE;
+    header.content_size = size;
+    memcpy(dst, &header, sizeof(header));
+
+    CompressionJob job = {};
+    job.source = (u8*)source;
+    job.destination = dst;
+    job.content_size = size;
+    job.block_count = (u32)BlockCount(size);
+    job.compress = true;
+    //every block is compressed in place at its worst case position, which only depends on the blocks before it,
+    //so the threads never wait on each other. Then the stream is closed up front to back
+    u64 offsets_size = sizeof(u64) * (job.block_count + 1);
+    job.block_offsets = (u64*)DAllocate(offsets_size, MEMORY_TAG_ARRAY);
+    for (u32 i = 0; i <= job.block_count; i++) {
+        job.block_offsets[i] = sizeof(CompressionStreamHeader) + (u64)i * (sizeof(u32) + COMPRESSION_BLOCK_SIZE);
+    }
+    CompressionJobExecute(&job, thread_count);
+
+    u64 written = sizeof(CompressionStreamHeader);
+    for (u32 i = 0; i < job.block_count; i++) {
+        u8* block = dst + job.block_offsets[i];
+        u64 block_size = sizeof(u32) + (Read32(block) & ~COMPRESSION_BLOCK_UNCOMPRESSED);
+        memmove(dst + written, block, block_size);
+        written += block_size;
+    }
+    DFree(job.block_offsets, offsets_size, MEMORY_TAG_ARRAY);
+    return written;
+}
+
+b8 DecompressStream(void* source, u64 source_size, void* destination, u64 size, u32 thread_count) {
+    if (!StreamHeaderValid(source, source_size) || ((CompressionStreamHeader*)source)->content_size != size) {
+        DERROR("DecompressStream - not a stream of %llu bytes.", size);
+        return false;
+    }
+    CompressionJob job = {};
+    job.source = (u8*)source;
+    job.destination = (u8*)destination;
+    job.content_size = size;
+    job.block_count = (u32)BlockCount(size);
+    //blocks can only be found by walking the headers, that part is serial but touches 4 bytes per block
+    u64 offsets_size = sizeof(u64) * (job.block_count + 1);
+    job.block_offsets = (u64*)DAllocate(offsets_size, MEMORY_TAG_ARRAY);
+    u64 position = sizeof(CompressionStreamHeader);
+    b8 result = true;
+    for (u32 i = 0; i < job.block_count; i++) {
+        if (source_size - position < sizeof(u32)) {
+            result = false;
+            break;
+        }
+        job.block_offsets[i] = position;
+        position += sizeof(u32) + (Read32(job.source + position) & ~COMPRESSION_BLOCK_UNCOMPRESSED);
+        if (position > source_size) {
+            result = false;
+            break;
+        }
+    }
+    if (result) {
+        job.block_offsets[job.block_count] = position;
+        CompressionJobExecute(&job, thread_count);
+        result = !job.failed;
+    }
+    DFree(job.block_offsets, offsets_size, MEMORY_TAG_ARRAY);
+    if (!result) {
+        DERROR("DecompressStream - the stream is corrupt.");
+    }
+    return result;
+}
+
+b8 DecompressStreamBegin(void* source, u64 source_size, DecompressStreamState* out_state) {
+    DZeroMemory(out_state, sizeof(DecompressStreamState));
+    if (!StreamHeaderValid(source, source_size)) {
+        DERROR("DecompressStreamBegin - not a compressed stream.");
+        return false;
+    }
+    CompressionStreamHeader* header = (CompressionStreamHeader*)source;
+    out_state->source = (u8*)source;
+    out_state->source_size = source_size;
+    out_state->position = sizeof(CompressionStreamHeader);
+    out_state->content_size = header->content_size;
+    out_state->block_size = header->block_size;
+    return true;
+}
+
+b8 DecompressStreamNext(DecompressStreamState* state, void* destination, u64 capacity, u64* out_written) {
+    u8* dst = (u8*)destination;
+    u64 written = 0;
+    while (state->produced < state->content_size) {
+        u64 remaining = state->content_size - state->produced;
+        u64 length = remaining < state->block_size ? remaining : state->block_size;
+        u64 available = state->source_size - state->position;
+        if (length > capacity - written || available < sizeof(u32)) {
+            break;
+        }
+        u64 stored = Read32(state->source + state->position) & ~COMPRESSION_BLOCK_UNCOMPRESSED;
+        if (available - sizeof(u32) < stored) {
+            //the rest of the block hasn't arrived yet
+            break;
+        }
+        if (!DecompressStreamBlock(state->source + state->position, available, dst + written, length)) {
+            DERROR("DecompressStreamNext - block at %llu is corrupt.", state->position);
+            *out_written = written;
+            return false;
+        }
+        state->position += sizeof(u32) + stored;
+        state->produced += length;
+        written += length;
+    }
+    *out_written = written;
+    return true;
+}
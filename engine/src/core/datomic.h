@@ -0,0 +1,88 @@
+#pragma once
+
+#include "defines.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <immintrin.h>
+#endif
+
+/*
+Thin wrappers over the compiler's atomic builtins. Loads acquire, stores release and the read-modify-write
+operations are sequentially consistent (a locked instruction on x86 either way). Code that needs other
+orderings, like the event queues, uses the builtins directly.
+*/
+
+DINLINE u32 AtomicLoadU32(u32* target) {
+    return __atomic_load_n(target, __ATOMIC_ACQUIRE);
+}
+
+DINLINE void AtomicStoreU32(u32* target, u32 value) {
+    __atomic_store_n(target, value, __ATOMIC_RELEASE);
+}
+
+//Each of these returns the value from before the operation
+DINLINE u32 AtomicFetchAddU32(u32* target, u32 value) {
+    return __atomic_fetch_add(target, value, __ATOMIC_SEQ_CST);
+}
+
+DINLINE u32 AtomicFetchSubU32(u32* target, u32 value) {
+    return __atomic_fetch_sub(target, value, __ATOMIC_SEQ_CST);
+}
+
+DINLINE u32 AtomicExchangeU32(u32* target, u32 value) {
+    return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST);
+}
+
+//On failure expected is updated to the current value
+DINLINE b8 AtomicCompareExchangeU32(u32* target, u32* expected, u32 desired) {
+    return __atomic_compare_exchange_n(target, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+DINLINE u64 AtomicLoadU64(u64* target) {
+    return __atomic_load_n(target, __ATOMIC_ACQUIRE);
+}
+
+DINLINE void AtomicStoreU64(u64* target, u64 value) {
+    __atomic_store_n(target, value, __ATOMIC_RELEASE);
+}
+
+DINLINE u64 AtomicFetchAddU64(u64* target, u64 value) {
+    return __atomic_fetch_add(target, value, __ATOMIC_SEQ_CST);
+}
+
+DINLINE u64 AtomicFetchSubU64(u64* target, u64 value) {
+    return __atomic_fetch_sub(target, value, __ATOMIC_SEQ_CST);
+}
+
+DINLINE u64 AtomicExchangeU64(u64* target, u64 value) {
+    return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST);
+}
+
+DINLINE b8 AtomicCompareExchangeU64(u64* target, u64* expected, u64 desired) {
+    return __atomic_compare_exchange_n(target, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+DINLINE void* AtomicLoadPtr(void** target) {
+    return __atomic_load_n(target, __ATOMIC_ACQUIRE);
+}
+
+DINLINE void AtomicStorePtr(void** target, void* value) {
+    __atomic_store_n(target, value, __ATOMIC_RELEASE);
+}
+
+DINLINE b8 AtomicCompareExchangePtr(void** target, void** expected, void* desired) {
+    return __atomic_compare_exchange_n(target, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+DINLINE void AtomicThreadFence() {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+//Spin-wait hint, lets the other hyperthread on the core run and saves power while spinning
+DINLINE void CpuPause() {
+#if defined(__x86_64__) || defined(_M_X64)
+    _mm_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
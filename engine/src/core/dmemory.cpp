@@ -1,5 +1,6 @@
 #include "dmemory.h"
 #include "core/logger.h"
+#include "core/dstring.h"
 #include "platform/platform.h"
 #include <string.h>
 #include <stdio.h>
@@ -98,8 +99,10 @@ char* GetMemoryUsageStr(){
     u64 mib = 1024 * 1024;
     u64 gib = 1024 * 1024* 1024;
 
-    char buffer[8000] = "System memory use (tagged):\n";
-    u64 offset = strlen(buffer);
+    char buffer[8000];
+    StringBuilder builder;
+    StringBuilderCreateFromBuffer(buffer, sizeof(buffer), &builder);
+    StringBuilderAppend(&builder, "System memory use (tagged):\n");
     for(u32 i = 0; i < MEMORY_TAG_MAX_TAGS; i++){
         char unit[] = "XiB";
         float amount = 1.0f;
@@ -119,10 +122,14 @@ char* GetMemoryUsageStr(){
             amount = (float)memory_state_ptr->stats.tagged_allocations[i];
         } 
 
-        i32 length = snprintf(buffer + offset, 8000, " %s: %.2f%s\n", memory_tag_strings[i], amount, unit);
-        offset += length;
+        StringBuilderAppendChar(&builder, ' ');
+        StringBuilderAppend(&builder, memory_tag_strings[i]);
+        StringBuilderAppend(&builder, ": ");
+        StringBuilderAppendF64Fixed(&builder, amount, 2);
+        StringBuilderAppend(&builder, unit);
+        StringBuilderAppendChar(&builder, '\n');
     }
-    char* outString = _strdup(buffer);
+    char* outString = StringDuplicate(buffer);
     return outString;
 }
 
@@ -1,10 +1,173 @@
 #include "core/dstring.h"
 #include "core/dmemory.h"
+#include "core/logger.h"
+#include "memory/linear_allocator.h"
 
 #include <string.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdlib.h>
 
+#if DPLATFORM_WINDOWS
+    #define STRING_COMPARE_I _stricmp
+#else
+    #include <strings.h>
+    #define STRING_COMPARE_I strcasecmp
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define DSTRING_SIMD 1
+    #include <immintrin.h>
+    #include <cpuid.h>
+#else
+    #define DSTRING_SIMD 0
+#endif
+
+#if DSTRING_SIMD
+enum SimdLevels {
+    SIMD_LEVEL_UNKNOWN,
+    SIMD_LEVEL_SSE2,
+    SIMD_LEVEL_AVX2
+};
+
+static u32 simd_level = SIMD_LEVEL_UNKNOWN;
+
+static u32 DetectSimdLevel() {
+    u32 eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return SIMD_LEVEL_SSE2; //baseline on x64
+    }
+    //AVX2 needs the OS to save ymm state (OSXSAVE + XCR0 bits 1 and 2) as well as the cpu flag
+    b8 os_saves_ymm = false;
+    if (ecx & (1 << 27)) {
+        u32 xcr0_lo, xcr0_hi;
+        __asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+        os_saves_ymm = (xcr0_lo & 0x6) == 0x6;
+    }
+    if (os_saves_ymm && __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & (1 << 5))) {
+        return SIMD_LEVEL_AVX2;
+    }
+    return SIMD_LEVEL_SSE2;
+}
+
+//Threads racing on the first call all detect the same level, relaxed atomics keep that from being a data race
+DINLINE u32 SimdLevel() {
+    u32 level = __atomic_load_n(&simd_level, __ATOMIC_RELAXED);
+    if (level == SIMD_LEVEL_UNKNOWN) {
+        level = DetectSimdLevel();
+        __atomic_store_n(&simd_level, level, __ATOMIC_RELAXED);
+    }
+    return level;
+}
+
+static i64 StringFindCharSse2(char* str, u64 length, char c) {
+    __m128i needle = _mm_set1_epi8(c);
+    u64 i = 0;
+    for (; i + 16 <= length; i += 16) {
+        u32 mask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((__m128i*)(str + i)), needle));
+        if (mask) {
+            return (i64)(i + __builtin_ctz(mask));
+        }
+    }
+    for (; i < length; i++) {
+        if (str[i] == c) {
+            return (i64)i;
+        }
+    }
+    return -1;
+}
+
+__attribute__((target("avx2")))
+static i64 StringFindCharAvx2(char* str, u64 length, char c) {
+    __m256i needle = _mm256_set1_epi8(c);
+    u64 i = 0;
+    for (; i + 32 <= length; i += 32) {
+        u32 mask = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((__m256i*)(str + i)), needle));
+        if (mask) {
+            return (i64)(i + __builtin_ctz(mask));
+        }
+    }
+    i64 tail = StringFindCharSse2(str + i, length - i, c);
+    return tail < 0 ? -1 : tail + (i64)i;
+}
+
+//Whitespace is ' ' or 0x09-0x0D, so it's one compare plus a range check instead of a compare per character
+static i64 StringFindWhitespaceSse2(char* str, u64 length) {
+    __m128i space = _mm_set1_epi8(' ');
+    __m128i tab = _mm_set1_epi8('\t');
+    __m128i range = _mm_set1_epi8('\r' - '\t');
+    u64 i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i block = _mm_loadu_si128((__m128i*)(str + i));
+        __m128i offset = _mm_sub_epi8(block, tab);
+        __m128i in_range = _mm_cmpeq_epi8(_mm_min_epu8(offset, range), offset);
+        u32 mask = (u32)_mm_movemask_epi8(_mm_or_si128(in_range, _mm_cmpeq_epi8(block, space)));
+        if (mask) {
+            return (i64)(i + __builtin_ctz(mask));
+        }
+    }
+    for (; i < length; i++) {
+        if (str[i] == ' ' || (u8)(str[i] - '\t') <= '\r' - '\t') {
+            return (i64)i;
+        }
+    }
+    return -1;
+}
+
+#define STRING_SIMD_MAX_SET 16
+
+//One compare per set character per block, so only used for small sets like whitespace or delimiters
+static i64 StringFindAnyOfSse2(char* str, u64 length, char* set, u32 set_length) {
+    __m128i needles[STRING_SIMD_MAX_SET];
+    for (u32 s = 0; s < set_length; s++) {
+        needles[s] = _mm_set1_epi8(set[s]);
+    }
+    u64 i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i block = _mm_loadu_si128((__m128i*)(str + i));
+        __m128i hits = _mm_setzero_si128();
+        for (u32 s = 0; s < set_length; s++) {
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, needles[s]));
+        }
+        u32 mask = (u32)_mm_movemask_epi8(hits);
+        if (mask) {
+            return (i64)(i + __builtin_ctz(mask));
+        }
+    }
+    for (; i < length; i++) {
+        for (u32 s = 0; s < set_length; s++) {
+            if (str[i] == set[s]) {
+                return (i64)i;
+            }
+        }
+    }
+    return -1;
+}
+
+__attribute__((target("avx2")))
+static i64 StringFindAnyOfAvx2(char* str, u64 length, char* set, u32 set_length) {
+    __m256i needles[STRING_SIMD_MAX_SET];
+    for (u32 s = 0; s < set_length; s++) {
+        needles[s] = _mm256_set1_epi8(set[s]);
+    }
+    u64 i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i block = _mm256_loadu_si256((__m256i*)(str + i));
+        __m256i hits = _mm256_setzero_si256();
+        for (u32 s = 0; s < set_length; s++) {
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(block, needles[s]));
+        }
+        u32 mask = (u32)_mm256_movemask_epi8(hits);
+        if (mask) {
+            return (i64)(i + __builtin_ctz(mask));
+        }
+    }
+    i64 tail = StringFindAnyOfSse2(str + i, length - i, set, set_length);
+    return tail < 0 ? -1 : tail + (i64)i;
+}
+#endif
+
+//libc's strlen, strcmp and strcasecmp are already vectorized and measured faster than hand written SSE2/AVX2 scans
 u64 StringLength(char* str) {
     return strlen(str);
 }
@@ -20,6 +183,10 @@ b8 StringsEqual(char* str0, char* str1) {
     return strcmp(str0, str1) == 0;
 }
 
+b8 StringsEqualI(char* str0, char* str1) {
+    return STRING_COMPARE_I(str0, str1) == 0;
+}
+
 i32 StringFormat(char* dest, char* format, ...) {
     if (dest) {
         __builtin_va_list arg_ptr;
@@ -33,13 +200,748 @@ i32 StringFormat(char* dest, char* format, ...) {
 
 i32 StringFormatV(char* dest, char* format, __builtin_va_list va_listp) {
     if (dest) {
-        // Big, but can fit on the stack.
-        char buffer[32000];
-        i32 written = vsnprintf(buffer, 32000, format, va_listp);
+        //Same limit the old stack buffer had, but written in place. Only the bytes produced are touched.
+        i32 written = StringFormatNV(dest, 32000, format, va_listp);
+        return Minimum(written, 32000 - 1);
+    }
+    return -1;
+}
+
+i32 StringFormatN(char* dest, u64 capacity, char* format, ...) {
+    __builtin_va_list arg_ptr;
+    va_start(arg_ptr, format);
+    i32 needed = StringFormatNV(dest, capacity, format, arg_ptr);
+    va_end(arg_ptr);
+    return needed;
+}
+
+i32 StringFormatNV(char* dest, u64 capacity, char* format, __builtin_va_list va_listp) {
+    if (!format || (!dest && capacity)) {
+        return -1;
+    }
+    //dest = 0, capacity = 0 is allowed to just measure
+    return vsnprintf(dest, capacity, format, va_listp);
+}
+
+//Makes room for at least extra more characters plus the terminator. Returns false if the builder can't grow
+static b8 StringBuilderReserve(StringBuilder* builder, u64 extra) {
+    u64 required = builder->length + extra + 1;
+    if (required <= builder->capacity) {
+        return true;
+    }
+    LinearAllocator* allocator = builder->allocator;
+    if (!allocator) {
+        return false;
+    }
+
+    u64 new_capacity = Maximum(builder->capacity * 2, required);
+    u8* arena_top = (u8*)allocator->memory + allocator->allocated;
+    if ((u8*)builder->buffer + builder->capacity == arena_top) {
+        //still the last allocation in the arena so it can grow in place
+        u64 grow_by = new_capacity - builder->capacity;
+        if (allocator->allocated + grow_by <= allocator->totalSize) {
+            allocator->allocated += grow_by;
+            builder->capacity = new_capacity;
+            return true;
+        }
+    }
+
+    char* new_buffer = (char*)AllocatorAllocate(allocator, new_capacity);
+    if (!new_buffer) {
+        return false;
+    }
+    DCopyMemory(new_buffer, builder->buffer, builder->length + 1);
+    builder->buffer = new_buffer;
+    builder->capacity = new_capacity;
+    return true;
+}
+
+b8 StringBuilderCreate(LinearAllocator* allocator, u64 initial_capacity, StringBuilder* out_builder) {
+    if (!allocator || !out_builder) {
+        return false;
+    }
+    initial_capacity = Maximum(initial_capacity, 16);
+    out_builder->buffer = (char*)AllocatorAllocate(allocator, initial_capacity);
+    if (!out_builder->buffer) {
+        return false;
+    }
+    out_builder->buffer[0] = 0;
+    out_builder->length = 0;
+    out_builder->capacity = initial_capacity;
+    out_builder->allocator = allocator;
+    out_builder->truncated = false;
+    return true;
+}
+
+void StringBuilderCreateFromBuffer(char* buffer, u64 capacity, StringBuilder* out_builder) {
+    out_builder->buffer = buffer;
+    out_builder->length = 0;
+    out_builder->capacity = capacity;
+    out_builder->allocator = 0;
+    out_builder->truncated = false;
+    if (capacity) {
+        buffer[0] = 0;
+    }
+}
+
+void StringBuilderAppendN(StringBuilder* builder, char* str, u64 length) {
+    if (!builder->capacity) {
+        builder->truncated = true;
+        return;
+    }
+    if (!StringBuilderReserve(builder, length)) {
+        builder->truncated = true;
+        length = builder->capacity - builder->length - 1;
+    }
+    DCopyMemory(builder->buffer + builder->length, str, length);
+    builder->length += length;
+    builder->buffer[builder->length] = 0;
+}
+
+void StringBuilderAppend(StringBuilder* builder, char* str) {
+    StringBuilderAppendN(builder, str, StringLength(str));
+}
+
+void StringBuilderAppendChar(StringBuilder* builder, char c) {
+    StringBuilderAppendN(builder, &c, 1);
+}
+
+void StringBuilderAppendFormat(StringBuilder* builder, char* format, ...) {
+    __builtin_va_list arg_ptr;
+    va_start(arg_ptr, format);
+    StringBuilderAppendFormatV(builder, format, arg_ptr);
+    va_end(arg_ptr);
+}
+
+void StringBuilderAppendFormatV(StringBuilder* builder, char* format, __builtin_va_list va_listp) {
+    if (!builder->capacity) {
+        builder->truncated = true;
+        return;
+    }
+    //format straight into the tail, only growing and formatting again if it didn't fit
+    __builtin_va_list retry_list;
+    __builtin_va_copy(retry_list, va_listp);
+
+    u64 remaining = builder->capacity - builder->length;
+    i32 needed = StringFormatNV(builder->buffer + builder->length, remaining, format, va_listp);
+    if (needed < 0) {
+        builder->buffer[builder->length] = 0;
+    } else if ((u64)needed < remaining) {
+        builder->length += needed;
+    } else if (StringBuilderReserve(builder, needed)) {
+        StringFormatNV(builder->buffer + builder->length, needed + 1, format, retry_list);
+        builder->length += needed;
+    } else {
+        //fixed buffer, keep what vsnprintf managed to write
+        builder->length = builder->capacity - 1;
+        builder->truncated = true;
+    }
+    va_end(retry_list);
+}
+
+void StringBuilderClear(StringBuilder* builder) {
+    builder->length = 0;
+    builder->truncated = false;
+    if (builder->capacity) {
+        builder->buffer[0] = 0;
+    }
+}
+
+//Number formatting
+
+static const char digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const u32 pow10_u32[10] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+static u32 CountDigits(u64 value) {
+    u32 digits = 1;
+    for (;;) {
+        if (value < 10) return digits;
+        if (value < 100) return digits + 1;
+        if (value < 1000) return digits + 2;
+        if (value < 10000) return digits + 3;
+        value /= 10000;
+        digits += 4;
+    }
+}
+
+//Writes exactly digit_count digits (zero padded on the left) ending at dest + digit_count
+static void WriteDigits(char* dest, u64 value, u32 digit_count) {
+    char* p = dest + digit_count;
+    while (value >= 100) {
+        u32 index = (u32)(value % 100) * 2;
+        value /= 100;
+        *--p = digit_pairs[index + 1];
+        *--p = digit_pairs[index];
+    }
+    if (value >= 10) {
+        *--p = digit_pairs[value * 2 + 1];
+        *--p = digit_pairs[value * 2];
+    } else {
+        *--p = (char)('0' + value);
+    }
+    while (p > dest) {
+        *--p = '0';
+    }
+}
+
+u32 StringFromU64(char* dest, u64 value) {
+    u32 length = CountDigits(value);
+    WriteDigits(dest, value, length);
+    dest[length] = 0;
+    return length;
+}
+
+u32 StringFromI64(char* dest, i64 value) {
+    if (value < 0) {
+        *dest = '-';
+        //negate as unsigned so I64 min doesn't overflow
+        return StringFromU64(dest + 1, 0 - (u64)value) + 1;
+    }
+    return StringFromU64(dest, (u64)value);
+}
+
+/*
+Grisu3 (Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers").
+Gives the shortest, closest digits or reports that it can't be sure, which happens for roughly half a percent
+of inputs. Those take an exact snprintf/strtod search instead.
+*/
+struct DiyFp {
+    u64 f;
+    i32 e;
+};
+
+static DiyFp DiyFpSub(DiyFp a, DiyFp b) {
+    return {a.f - b.f, a.e};
+}
+
+static DiyFp DiyFpMul(DiyFp x, DiyFp y) {
+    const u64 M32 = 0xFFFFFFFF;
+    u64 a = x.f >> 32;
+    u64 b = x.f & M32;
+    u64 c = y.f >> 32;
+    u64 d = y.f & M32;
+    u64 ac = a * c;
+    u64 bc = b * c;
+    u64 ad = a * d;
+    u64 bd = b * d;
+    u64 tmp = (bd >> 32) + (ad & M32) + (bc & M32);
+    tmp += 1U << 31; //round
+    return {ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64};
+}
+
+static DiyFp DiyFpNormalize(DiyFp v) {
+    u32 shift = __builtin_clzll(v.f);
+    return {v.f << shift, v.e - (i32)shift};
+}
+
+//10^k for k = -348 + 8 * i, normalized to a 64 bit significand
+static const u64 cached_powers_f[87] = {
+    0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL, 0xcf42894a5dce35eaULL,
+    0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL, 0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL,
+    0xbe5691ef416bd60cULL, 0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+    0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL, 0xc21094364dfb5637ULL,
+    0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL, 0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL,
+    0xb23867fb2a35b28eULL, 0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+    0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL, 0xb5b5ada8aaff80b8ULL,
+    0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL, 0x964e858c91ba2655ULL, 0xdff9772470297ebdULL,
+    0xa6dfbd9fb8e5b88fULL, 0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+    0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL, 0xaa242499697392d3ULL,
+    0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL, 0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL,
+    0x9c40000000000000ULL, 0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+    0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL, 0x9f4f2726179a2245ULL,
+    0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL, 0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL,
+    0x924d692ca61be758ULL, 0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+    0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL, 0x952ab45cfa97a0b3ULL,
+    0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL, 0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL,
+    0x88fcf317f22241e2ULL, 0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+    0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL, 0x8bab8eefb6409c1aULL,
+    0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL, 0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL,
+    0x80444b5e7aa7cf85ULL, 0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+    0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL,
+};
+
+static const i16 cached_powers_e[87] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+    -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+    -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+    -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+    56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+    694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+    1013, 1039, 1066,
+};
+
+static DiyFp GetCachedPower(i32 e, i32* out_k) {
+    //the multiplied exponent should land in [-60, -32] so integral digits fit in 32 bits
+    f64 dk = (-61 - e) * 0.30102999566398114 + 347;
+    i32 k = (i32)dk;
+    if (dk - k > 0.0) {
+        k++;
+    }
+    u32 index = (u32)((k >> 3) + 1);
+    *out_k = -(-348 + (i32)(index << 3));
+    return {cached_powers_f[index], cached_powers_e[index]};
+}
+
+//The scaled boundaries are only known to within a unit either way, so digits are generated over the widened
+//(unsafe) interval and weeding refuses whenever that error could change which digits are shortest or closest
+static b8 GrisuRoundWeed(char* buffer, u32 length, u64 distance_too_high_w, u64 unsafe_interval, u64 rest, u64 ten_kappa, u64 unit) {
+    u64 small_distance = distance_too_high_w - unit;
+    u64 big_distance = distance_too_high_w + unit;
+    while (rest < small_distance && unsafe_interval - rest >= ten_kappa &&
+           (rest + ten_kappa < small_distance || small_distance - rest >= rest + ten_kappa - small_distance)) {
+        buffer[length - 1]--;
+        rest += ten_kappa;
+    }
+    //if a digit one lower could still be closer to the far end of w's error range the result isn't certain
+    if (rest < big_distance && unsafe_interval - rest >= ten_kappa &&
+        (rest + ten_kappa < big_distance || big_distance - rest > rest + ten_kappa - big_distance)) {
+        return false;
+    }
+    return 2 * unit <= rest && rest <= unsafe_interval - 4 * unit;
+}
+
+static b8 DigitGen(DiyFp low, DiyFp w, DiyFp high, char* buffer, u32* length, i32* k) {
+    u64 unit = 1;
+    DiyFp too_low = {low.f - unit, low.e};
+    DiyFp too_high = {high.f + unit, high.e};
+    u64 unsafe_interval = DiyFpSub(too_high, too_low).f;
+    DiyFp one = {1ULL << -w.e, w.e};
+    u32 p1 = (u32)(too_high.f >> -one.e);
+    u64 p2 = too_high.f & (one.f - 1);
+    i32 kappa = (i32)CountDigits(p1);
+    *length = 0;
+
+    while (kappa > 0) {
+        u32 d = p1 / pow10_u32[kappa - 1];
+        p1 %= pow10_u32[kappa - 1];
+        if (d || *length) {
+            buffer[(*length)++] = (char)('0' + d);
+        }
+        kappa--;
+        u64 rest = ((u64)p1 << -one.e) + p2;
+        if (rest < unsafe_interval) {
+            *k += kappa;
+            return GrisuRoundWeed(buffer, *length, DiyFpSub(too_high, w).f, unsafe_interval, rest,
+                                  (u64)pow10_u32[kappa] << -one.e, unit);
+        }
+    }
+
+    for (;;) {
+        p2 *= 10;
+        unit *= 10;
+        unsafe_interval *= 10;
+        char d = (char)(p2 >> -one.e);
+        if (d || *length) {
+            buffer[(*length)++] = '0' + d;
+        }
+        p2 &= one.f - 1;
+        kappa--;
+        if (p2 < unsafe_interval) {
+            *k += kappa;
+            return GrisuRoundWeed(buffer, *length, DiyFpSub(too_high, w).f * unit, unsafe_interval, p2, one.f, unit);
+        }
+    }
+}
+
+//f/e is the value's significand and binary exponent, lower_closer is set when f is a power of two
+//(the gap to the next value down is half the gap up). Returns false when the digits can't be trusted
+static b8 Grisu3(u64 f, i32 e, b8 lower_closer, char* buffer, u32* length, i32* k) {
+    DiyFp plus = DiyFpNormalize({(f << 1) + 1, e - 1});
+    DiyFp minus = lower_closer ? DiyFp{(f << 2) - 1, e - 2} : DiyFp{(f << 1) - 1, e - 1};
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+
+    DiyFp c_mk = GetCachedPower(plus.e, k);
+    DiyFp w = DiyFpMul(DiyFpNormalize({f, e}), c_mk);
+    DiyFp wp = DiyFpMul(plus, c_mk);
+    DiyFp wm = DiyFpMul(minus, c_mk);
+    return DigitGen(wm, w, wp, buffer, length, k);
+}
+
+//Exact but slow: the first precision whose correctly rounded digits read back as the same value is the shortest
+static void ShortestDigitsExact(f64 magnitude, b8 single_precision, char* buffer, u32* length, i32* k) {
+    char text[32];
+    u32 max_digits = single_precision ? 9 : 17;
+    for (u32 digits = 1; digits <= max_digits; digits++) {
+        snprintf(text, sizeof(text), "%.*e", (i32)digits - 1, magnitude);
+        b8 round_trips = single_precision ? strtof(text, 0) == (f32)magnitude : strtod(text, 0) == magnitude;
+        if (round_trips || digits == max_digits) {
+            break;
+        }
+    }
+    //text is "d.ddde[+-]x"
+    *length = 0;
+    char* c = text;
+    for (; *c != 'e'; c++) {
+        if (*c != '.') {
+            buffer[(*length)++] = *c;
+        }
+    }
+    *k = atoi(c + 1) - (i32)(*length - 1);
+}
+
+static u32 WriteExponent(i32 k, char* dest) {
+    char* start = dest;
+    if (k < 0) {
+        *dest++ = '-';
+        k = -k;
+    }
+    dest += StringFromU64(dest, (u64)k);
+    return (u32)(dest - start);
+}
+
+//Lays out length digits scaled by 10^k as plain decimal where reasonable, otherwise as d.ddde+x
+static u32 Prettify(char* buffer, u32 length, i32 k) {
+    i32 kk = (i32)length + k; //10^(kk-1) <= v < 10^kk
+
+    if (k >= 0 && kk <= 21) {
+        //1234e7 -> 12340000000.0
+        for (i32 i = length; i < kk; i++) {
+            buffer[i] = '0';
+        }
+        buffer[kk] = '.';
+        buffer[kk + 1] = '0';
+        buffer[kk + 2] = 0;
+        return kk + 2;
+    } else if (kk > 0 && kk <= 21) {
+        //1234e-2 -> 12.34
+        memmove(&buffer[kk + 1], &buffer[kk], length - kk);
+        buffer[kk] = '.';
+        buffer[length + 1] = 0;
+        return length + 1;
+    } else if (kk > -6 && kk <= 0) {
+        //1234e-6 -> 0.001234
+        i32 offset = 2 - kk;
+        memmove(&buffer[offset], &buffer[0], length);
+        buffer[0] = '0';
+        buffer[1] = '.';
+        for (i32 i = 2; i < offset; i++) {
+            buffer[i] = '0';
+        }
+        buffer[length + offset] = 0;
+        return length + offset;
+    } else if (length == 1) {
+        //1e30
+        buffer[1] = 'e';
+        u32 written = 2 + WriteExponent(kk - 1, &buffer[2]);
         buffer[written] = 0;
-        DCopyMemory(dest, buffer, written + 1);
+        return written;
+    }
+    //1234e30 -> 1.234e33
+    memmove(&buffer[2], &buffer[1], length - 1);
+    buffer[1] = '.';
+    buffer[length + 1] = 'e';
+    u32 written = length + 2 + WriteExponent(kk - 1, &buffer[length + 2]);
+    buffer[written] = 0;
+    return written;
+}
 
+//Handles sign, zero, inf and nan. Returns true once dest is fully written
+static b8 WriteSpecialFloat(char** dest, u32* written, u64 exponent_bits, u64 significand, b8 negative, b8 is_max_exponent) {
+    if (is_max_exponent) {
+        char* text = significand ? (char*)"nan" : (negative ? (char*)"-inf" : (char*)"inf");
+        *written = (u32)StringLength(text);
+        DCopyMemory(*dest, text, *written + 1);
+        return true;
+    }
+    if (negative) {
+        *(*dest)++ = '-';
+        *written = 1;
+    }
+    if (exponent_bits == 0 && significand == 0) {
+        DCopyMemory(*dest, (void*)"0.0", 4);
+        *written += 3;
+        return true;
+    }
+    return false;
+}
+
+u32 StringFromF64(char* dest, f64 value) {
+    u64 bits;
+    DCopyMemory(&bits, &value, sizeof(bits));
+    u64 exponent_bits = (bits >> 52) & 0x7FF;
+    u64 significand = bits & 0x000FFFFFFFFFFFFFULL;
+    u32 written = 0;
+    if (WriteSpecialFloat(&dest, &written, exponent_bits, significand, (bits >> 63) != 0, exponent_bits == 0x7FF)) {
         return written;
     }
+
+    u64 f = significand;
+    i32 e = 1 - 1075;
+    if (exponent_bits) {
+        f += 1ULL << 52;
+        e = (i32)exponent_bits - 1075;
+    }
+    u32 length = 0;
+    i32 k = 0;
+    if (!Grisu3(f, e, exponent_bits > 1 && significand == 0, dest, &length, &k)) {
+        ShortestDigitsExact(value < 0 ? -value : value, false, dest, &length, &k);
+    }
+    return written + Prettify(dest, length, k);
+}
+
+u32 StringFromF32(char* dest, f32 value) {
+    u32 bits;
+    DCopyMemory(&bits, &value, sizeof(bits));
+    u32 exponent_bits = (bits >> 23) & 0xFF;
+    u32 significand = bits & 0x7FFFFF;
+    u32 written = 0;
+    if (WriteSpecialFloat(&dest, &written, exponent_bits, significand, (bits >> 31) != 0, exponent_bits == 0xFF)) {
+        return written;
+    }
+
+    //boundaries are taken from the f32 spacing so 0.1f prints as 0.1 rather than its exact double expansion
+    u64 f = significand;
+    i32 e = 1 - 150;
+    if (exponent_bits) {
+        f += 1U << 23;
+        e = (i32)exponent_bits - 150;
+    }
+    u32 length = 0;
+    i32 k = 0;
+    if (!Grisu3(f, e, exponent_bits > 1 && significand == 0, dest, &length, &k)) {
+        ShortestDigitsExact(value < 0 ? -value : value, true, dest, &length, &k);
+    }
+    return written + Prettify(dest, length, k);
+}
+
+u32 StringFromF64Fixed(char* dest, f64 value, u32 precision) {
+    if (value != value || value - value != 0) {
+        //nan and inf
+        return StringFromF64(dest, value);
+    }
+    precision = Minimum(precision, 9);
+    b8 negative = value < 0 || (value == 0 && 1.0 / value < 0);
+    f64 magnitude = negative ? -value : value;
+    if (magnitude >= 18446744073709551615.0) {
+        return StringFromF64(dest, value);
+    }
+
+    //split first so the fraction keeps full precision when scaled, the subtraction is exact
+    u64 integer = (u64)magnitude;
+    u64 scale = pow10_u32[precision];
+    u64 fraction = (u64)((magnitude - (f64)integer) * (f64)scale + 0.5);
+    if (fraction >= scale) {
+        integer++;
+        fraction -= scale;
+    }
+
+    char* p = dest;
+    if (negative) {
+        *p++ = '-';
+    }
+    p += StringFromU64(p, integer);
+    if (precision) {
+        *p++ = '.';
+        WriteDigits(p, fraction, precision);
+        p += precision;
+        *p = 0;
+    }
+    return (u32)(p - dest);
+}
+
+void StringBuilderAppendU64(StringBuilder* builder, u64 value) {
+    char buffer[STRING_NUMBER_MAX_LENGTH];
+    StringBuilderAppendN(builder, buffer, StringFromU64(buffer, value));
+}
+
+void StringBuilderAppendI64(StringBuilder* builder, i64 value) {
+    char buffer[STRING_NUMBER_MAX_LENGTH];
+    StringBuilderAppendN(builder, buffer, StringFromI64(buffer, value));
+}
+
+void StringBuilderAppendF64(StringBuilder* builder, f64 value) {
+    char buffer[STRING_NUMBER_MAX_LENGTH];
+    StringBuilderAppendN(builder, buffer, StringFromF64(buffer, value));
+}
+
+void StringBuilderAppendF64Fixed(StringBuilder* builder, f64 value, u32 precision) {
+    char buffer[STRING_NUMBER_MAX_LENGTH];
+    StringBuilderAppendN(builder, buffer, StringFromF64Fixed(buffer, value, precision));
+}
+
+b8 StringViewsEqual(StringView a, StringView b) {
+    return a.length == b.length && (a.str == b.str || memcmp(a.str, b.str, a.length) == 0);
+}
+
+u64 StringViewCopy(StringView view, char* dest, u64 capacity) {
+    if (!capacity) {
+        return 0;
+    }
+    u64 length = Minimum(view.length, capacity - 1);
+    DCopyMemory(dest, view.str, length);
+    dest[length] = 0;
+    return length;
+}
+
+b8 DStringCreate(char* str, LinearAllocator* allocator, DString* out_string) {
+    return DStringCreateFromView(StringViewFromCStr(str), allocator, out_string);
+}
+
+b8 DStringCreateFromView(StringView view, LinearAllocator* allocator, DString* out_string) {
+    out_string->allocator = allocator;
+    out_string->length = 0;
+    out_string->is_heap = false;
+    out_string->inline_data[0] = 0;
+    return DStringAppend(out_string, view);
+}
+
+void DStringDestroy(DString* string) {
+    if (string->is_heap && !string->allocator) {
+        DFree(string->heap.data, string->heap.capacity, MEMORY_TAG_STRING);
+    }
+    string->length = 0;
+    string->is_heap = false;
+    string->inline_data[0] = 0;
+}
+
+b8 DStringAppend(DString* string, StringView view) {
+    u64 new_length = string->length + view.length;
+    if (new_length > 0xFFFFFFFF) {
+        DERROR("DStringAppend - appending %llu characters would overflow the length.", (unsigned long long)view.length);
+        return false;
+    }
+    u64 capacity = string->is_heap ? string->heap.capacity : DSTRING_INLINE_CAPACITY + 1;
+    if (new_length + 1 > capacity) {
+        u64 new_capacity = Maximum(capacity * 2, new_length + 1);
+        char* data = 0;
+        if (string->allocator) {
+            data = (char*)AllocatorAllocate(string->allocator, new_capacity);
+            if (!data) {
+                //the allocator has already said why
+                return false;
+            }
+        } else {
+            data = (char*)DAllocate(new_capacity, MEMORY_TAG_STRING);
+        }
+        //view may point into the old data, so both copies happen before it is released
+        char* old_data = DStringCStr(string);
+        DCopyMemory(data, old_data, string->length);
+        DCopyMemory(data + string->length, view.str, view.length);
+        if (string->is_heap && !string->allocator) {
+            DFree(old_data, string->heap.capacity, MEMORY_TAG_STRING);
+        }
+        string->heap.data = data;
+        string->heap.capacity = new_capacity;
+        string->is_heap = true;
+        string->length = (u32)new_length;
+        data[new_length] = 0;
+        return true;
+    }
+    char* dest = DStringCStr(string);
+    DCopyMemory(dest + string->length, view.str, view.length);
+    string->length = (u32)new_length;
+    dest[new_length] = 0;
+    return true;
+}
+
+void DStringClear(DString* string) {
+    string->length = 0;
+    DStringCStr(string)[0] = 0;
+}
+
+i64 StringFindChar(StringView view, char c) {
+#if DSTRING_SIMD
+    u32 level = SimdLevel();
+    if (level == SIMD_LEVEL_AVX2) {
+        return StringFindCharAvx2(view.str, view.length, c);
+    }
+    if (level == SIMD_LEVEL_SSE2) {
+        return StringFindCharSse2(view.str, view.length, c);
+    }
+#endif
+    for (u64 i = 0; i < view.length; i++) {
+        if (view.str[i] == c) {
+            return (i64)i;
+        }
+    }
     return -1;
-}
\ No newline at end of file
+}
+
+i64 StringFindAnyOf(StringView view, char* set) {
+    u64 set_length = StringLength(set);
+    if (set_length == 1) {
+        return StringFindChar(view, set[0]);
+    }
+#if DSTRING_SIMD
+    u32 level = SimdLevel();
+    if (set_length <= STRING_SIMD_MAX_SET) {
+        if (level == SIMD_LEVEL_AVX2) {
+            return StringFindAnyOfAvx2(view.str, view.length, set, (u32)set_length);
+        }
+        if (level == SIMD_LEVEL_SSE2) {
+            return StringFindAnyOfSse2(view.str, view.length, set, (u32)set_length);
+        }
+    }
+#endif
+    u8 lookup[256] = {};
+    for (u64 s = 0; s < set_length; s++) {
+        lookup[(u8)set[s]] = 1;
+    }
+    for (u64 i = 0; i < view.length; i++) {
+        if (lookup[(u8)view.str[i]]) {
+            return (i64)i;
+        }
+    }
+    return -1;
+}
+
+b8 StringSplitNextLine(StringView* remaining, StringView* out_line) {
+    if (!remaining->length) {
+        return false;
+    }
+    i64 newline = StringFindChar(*remaining, '\n');
+    u64 line_length = newline < 0 ? remaining->length : (u64)newline;
+    u64 consumed = newline < 0 ? line_length : line_length + 1;
+
+    *out_line = StringViewCreate(remaining->str, line_length);
+    if (out_line->length && out_line->str[out_line->length - 1] == '\r') {
+        out_line->length--;
+    }
+    remaining->str += consumed;
+    remaining->length -= consumed;
+    return true;
+}
+
+b8 StringSplitNextWhitespace(StringView* remaining, StringView* out_token) {
+    //separators are usually single characters so skipping them doesn't need the vector path
+    u64 start = 0;
+    while (start < remaining->length) {
+        char c = remaining->str[start];
+        if (c != ' ' && c != '\t' && c != '\r' && c != '\n' && c != '\v' && c != '\f') {
+            break;
+        }
+        start++;
+    }
+    if (start == remaining->length) {
+        remaining->str += start;
+        remaining->length = 0;
+        return false;
+    }
+
+    StringView rest = StringViewSlice(*remaining, start, remaining->length - start);
+#if DSTRING_SIMD
+    i64 end = StringFindWhitespaceSse2(rest.str, rest.length);
+#else
+    i64 end = StringFindAnyOf(rest, " \t\r\n\v\f");
+#endif
+    u64 token_length = end < 0 ? rest.length : (u64)end;
+    *out_token = StringViewCreate(rest.str, token_length);
+    remaining->str = rest.str + token_length;
+    remaining->length = rest.length - token_length;
+    return true;
+}
@@ -2,6 +2,8 @@
 
 #include "defines.h"
 
+struct LinearAllocator;
+
 DAPI u64 StringLength(char* str);
 
 DAPI char* StringDuplicate(char* str);
@@ -9,6 +11,143 @@ DAPI char* StringDuplicate(char* str);
 //Case sensitive
 DAPI b8 StringsEqual(char* str0, char* str1);
 
+//ASCII case insensitive
+DAPI b8 StringsEqualI(char* str0, char* str1);
+
+//Legacy: assumes dest is large enough to hold the output. Prefer StringFormatN
 DAPI i32 StringFormat(char* dest, char* format, ...);
 
-DAPI i32 StringFormatV(char* dest, char* format, __builtin_va_list va_listp);
\ No newline at end of file
+DAPI i32 StringFormatV(char* dest, char* format, __builtin_va_list va_listp);
+
+/*
+Formats directly into dest, writing at most capacity bytes including the null terminator.
+Returns the length the full output needs (excluding the terminator), so a return value >= capacity
+means the output was truncated. Returns -1 on error.
+*/
+DAPI i32 StringFormatN(char* dest, u64 capacity, char* format, ...);
+
+DAPI i32 StringFormatNV(char* dest, u64 capacity, char* format, __builtin_va_list va_listp);
+
+/*
+Number formatting without going through vsnprintf. Each writes straight into dest, null terminates and
+returns the length written. dest must hold at least STRING_NUMBER_MAX_LENGTH bytes.
+*/
+#define STRING_NUMBER_MAX_LENGTH 32
+
+DAPI u32 StringFromU64(char* dest, u64 value);
+DAPI u32 StringFromI64(char* dest, i64 value);
+
+//Shortest digits that parse back to exactly the same value (Grisu3 with an exact fallback), e.g. 0.1 -> "0.1", 1e30 -> "1e30"
+DAPI u32 StringFromF64(char* dest, f64 value);
+DAPI u32 StringFromF32(char* dest, f32 value);
+
+//Fixed decimals like "%.*f", rounded half away from zero. Precision is capped at 9, values past u64 range use StringFromF64
+DAPI u32 StringFromF64Fixed(char* dest, f64 value, u32 precision);
+
+/*
+Builds a string out of multiple parts without intermediate copies. The buffer either comes from
+an arena (grown in place when it is the arena's last allocation) or is a fixed caller buffer, in which
+case output is truncated and truncated is set. buffer is always null terminated.
+*/
+struct StringBuilder {
+    char* buffer;
+    u64 length;
+    u64 capacity;
+    LinearAllocator* allocator;
+    b8 truncated;
+};
+
+DAPI b8 StringBuilderCreate(LinearAllocator* allocator, u64 initial_capacity, StringBuilder* out_builder);
+DAPI void StringBuilderCreateFromBuffer(char* buffer, u64 capacity, StringBuilder* out_builder);
+DAPI void StringBuilderAppend(StringBuilder* builder, char* str);
+DAPI void StringBuilderAppendN(StringBuilder* builder, char* str, u64 length);
+DAPI void StringBuilderAppendChar(StringBuilder* builder, char c);
+DAPI void StringBuilderAppendFormat(StringBuilder* builder, char* format, ...);
+DAPI void StringBuilderAppendFormatV(StringBuilder* builder, char* format, __builtin_va_list va_listp);
+DAPI void StringBuilderAppendU64(StringBuilder* builder, u64 value);
+DAPI void StringBuilderAppendI64(StringBuilder* builder, i64 value);
+DAPI void StringBuilderAppendF64(StringBuilder* builder, f64 value);
+DAPI void StringBuilderAppendF64Fixed(StringBuilder* builder, f64 value, u32 precision);
+DAPI void StringBuilderClear(StringBuilder* builder);
+
+//Non-owning slice of string data. Not necessarily null terminated
+struct StringView {
+    char* str;
+    u64 length;
+};
+
+DINLINE StringView StringViewCreate(char* str, u64 length) {
+    StringView view = {str, length};
+    return view;
+}
+
+DINLINE StringView StringViewFromCStr(char* str) {
+    return StringViewCreate(str, StringLength(str));
+}
+
+//Clamped to the bounds of view
+DINLINE StringView StringViewSlice(StringView view, u64 start, u64 length) {
+    if (start > view.length) {
+        start = view.length;
+    }
+    if (length > view.length - start) {
+        length = view.length - start;
+    }
+    return StringViewCreate(view.str + start, length);
+}
+
+DAPI b8 StringViewsEqual(StringView a, StringView b);
+
+//Copies into dest and null terminates, truncating to capacity. Returns the number of characters copied
+DAPI u64 StringViewCopy(StringView view, char* dest, u64 capacity);
+
+//The find and split scans use SSE2/AVX2 when the cpu has them (picked at first use) and scalar code otherwise
+
+//Index of the first c in view, or -1
+DAPI i64 StringFindChar(StringView view, char c);
+
+//Index of the first character of view that is in the null terminated set, or -1
+DAPI i64 StringFindAnyOf(StringView view, char* set);
+
+/*
+Tokenizers for text assets. Each call takes the next piece off the front of remaining and returns false
+once it is exhausted. Lines drop the '\n' and a trailing '\r', tokens are split on spaces, tabs and newlines.
+*/
+DAPI b8 StringSplitNextLine(StringView* remaining, StringView* out_line);
+DAPI b8 StringSplitNextWhitespace(StringView* remaining, StringView* out_token);
+
+#define DSTRING_INLINE_CAPACITY 23
+
+/*
+Owned, always null terminated string. Up to DSTRING_INLINE_CAPACITY characters are stored inside the struct
+so short identifiers never allocate. Longer strings come from the allocator given at creation, or the heap
+(MEMORY_TAG_STRING) when it is 0. Arena memory is not released on destroy, the arena owns it.
+*/
+struct DString {
+    union {
+        char inline_data[DSTRING_INLINE_CAPACITY + 1];
+        struct {
+            char* data;
+            u64 capacity;
+        } heap;
+    };
+    LinearAllocator* allocator;
+    u32 length;
+    b8 is_heap;
+};
+
+//Creating and appending fail when the allocator is out of room or the length would pass a u32, leaving the
+//string as it was (empty, for create)
+DAPI b8 DStringCreate(char* str, LinearAllocator* allocator, DString* out_string);
+DAPI b8 DStringCreateFromView(StringView view, LinearAllocator* allocator, DString* out_string);
+DAPI void DStringDestroy(DString* string);
+DAPI b8 DStringAppend(DString* string, StringView view);
+DAPI void DStringClear(DString* string);
+
+DINLINE char* DStringCStr(DString* string) {
+    return string->is_heap ? string->heap.data : string->inline_data;
+}
+
+DINLINE StringView DStringView(DString* string) {
+    return StringViewCreate(DStringCStr(string), string->length);
+}
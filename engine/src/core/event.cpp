@@ -1,23 +1,552 @@
 #include "core/event.h"
 #include "core/dmemory.h"
 #include "containers/darray.h"
+#include "core/datomic.h"
+#include "core/logger.h"
+#include "memory/linear_allocator.h"
+#include "platform/threading.h"
+
+#if DEVENT_INSTRUMENTATION
+#include "core/clock.h"
+#endif
 
 struct RegisteredEvent {
     void* listener;
     PfnOnEvent callback;
+    i16 priority;
+#if DEVENT_INSTRUMENTATION
+    //into listener_stats, fits in the padding after priority
+    u32 stats_index;
+#endif
+};
+
+//Registration made while a fire is running, applied once the outermost fire returns
+struct PendingRegistration {
+    u16 code;
+    RegisteredEvent event;
 };
 
+//One per code that was ever registered or given a policy. Its listeners are pool[first, first + count),
+//sorted by descending priority, with room to grow in place up to first + capacity
 struct EventCodeEntry {
-    RegisteredEvent* events;
+    u16 code;
+    b8 used;
+    u8 coalesce_policy;
+    u32 first;
+    u32 count;
+    u32 capacity;
+    //unregistered slots inside the range, blanked and skipped until swept
+    u32 blanks;
+    //index of this code's event in the queue, only valid while queued_generation matches the state's
+    u32 queued_index;
+    u32 queued_generation;
+#if DEVENT_INSTRUMENTATION
+    u32 frame_count;
+    u32 last_frame_count;
+    u64 total_count;
+#endif
 };
 
-#define MAX_MESSAGE_CODES 16384
+struct QueuedEvent {
+    u16 code;
+    void* sender;
+    EventContext context;
+};
+
+//Bounded MPSC ring cell, sequence tells producers and the consumer whose turn the cell is
+struct EventThreadCell {
+    u64 sequence;
+    QueuedEvent event;
+};
+
+struct EventThreadQueue {
+    EventThreadCell* cells;
+    u64 enqueue_position;
+    u64 dequeue_position;
+};
+
+//Buffer replaced while another thread might still be reading it
+struct RetiredBlock {
+    void* block;
+    u64 size;
+    MemoryTag tag;
+};
+
+#define EVENT_CODE_TABLE_INITIAL_CAPACITY 64
+#define EVENT_LISTENER_POOL_INITIAL_CAPACITY 64
+#define EVENT_LISTENER_RANGE_MIN_CAPACITY 4
+#define EVENT_QUEUE_INITIAL_CAPACITY 256
+//worker threads are spread over this many rings, threads sharing a ring is fine
+#define EVENT_THREAD_QUEUE_COUNT 8
+//per ring, must be a power of two. Posts past this before the next dispatch fail
+#define EVENT_THREAD_QUEUE_CAPACITY 64
+//listeners a fire from a worker thread copies out of the table at a time
+#define EVENT_CONCURRENT_FIRE_MAX_LISTENERS 32
+//per arena, there are two
+#define EVENT_PAYLOAD_ARENA_SIZE KiloBytes(64)
 
 struct EventSystemState {
-    EventCodeEntry registered[MAX_MESSAGE_CODES];
+    //open addressing on the code, entries are never removed so there are no tombstones
+    EventCodeEntry* codes;
+    u32 code_capacity;
+    u32 code_count;
+    //listeners of every code in one block, each code owns a contiguous range of it
+    RegisteredEvent* pool;
+    u32 pool_length;
+    u32 pool_capacity;
+    //sum of range capacities owned by codes, the rest of pool_length is abandoned ranges
+    u32 pool_live;
+    //seqlock over codes and pool, odd while the main thread is changing them
+    u32 generation;
+    //ranges are not reordered while a fire is running, registrations wait in pending until it returns
+    u32 firing_depth;
+    PendingRegistration* pending;
+    b8 removals_pending;
+    //EventPost appends to queue, dispatch swaps it with dispatching so posts made by listeners wait a frame
+    QueuedEvent* queue;
+    QueuedEvent* dispatching;
+    //bumped whenever queue is swapped out, invalidating every queued_index at once
+    u32 queue_generation;
+    //payloads for the queue being filled and the one being dispatched, swapped along with the queues
+    LinearAllocator payload_arenas[2];
+    u32 payload_arena_index;
+#if DEVENT_INSTRUMENTATION
+    //one per code/listener/callback ever registered, so stats survive re-registration
+    EventListenerStats* listener_stats;
+#endif
+
+    //posts from other threads, drained into queue at the dispatch point
+    EventThreadQueue thread_queues[EVENT_THREAD_QUEUE_COUNT];
+    u32 next_thread_queue;
+    //fires from other threads, counted from before they copy out of the table until their last callback returns.
+    //Each joins the count of reader_epoch, unregistering flips the epoch and waits out the old count only, so a
+    //steady stream of new fires can't hold it up. Old buffers are only freed while both are 0
+    u32 readers_in_flight[2];
+    u32 reader_epoch;
+    RetiredBlock* retired;
 };
 
 static EventSystemState* event_state_ptr;
+//registration, dispatch and coalescing all happen on the thread that initialized the system
+static thread_local b8 event_thread_is_main;
+static thread_local u32 event_thread_queue_index = 0xFFFFFFFF;
+
+DINLINE u32 EventCodeHash(u16 code) {
+    return ((u32)code * 2654435761u) >> 15;
+}
+
+static EventCodeEntry* FindCode(u16 code) {
+    u32 mask = event_state_ptr->code_capacity - 1;
+    for (u32 slot = EventCodeHash(code) & mask;; slot = (slot + 1) & mask) {
+        EventCodeEntry* entry = &event_state_ptr->codes[slot];
+        if (!entry->used) {
+            return 0;
+        }
+        if (entry->code == code) {
+            return entry;
+        }
+    }
+}
+
+//Spin waits on other threads: a few pauses, growing, then yielding the core
+static void Backoff(u32* spins) {
+    if (*spins < 10) {
+        for (u32 i = 0; i < (1u << *spins); i++) {
+            CpuPause();
+        }
+        (*spins)++;
+    } else {
+        ThreadYield();
+    }
+}
+
+/*
+Slots and the entry fields SnapshotListeners reads (used, code, first, count) are written with relaxed atomic
+stores on live buffers, the snapshot reads them with relaxed atomic loads. A read torn by a write is then just
+stale and thrown away by the seqlock, rather than a data race. The main thread reads its own writes plainly.
+*/
+static void ListenerStore(RegisteredEvent* slot, RegisteredEvent* event) {
+    __atomic_store_n(&slot->listener, event->listener, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->callback, event->callback, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->priority, event->priority, __ATOMIC_RELAXED);
+#if DEVENT_INSTRUMENTATION
+    slot->stats_index = event->stats_index;
+#endif
+}
+
+//Overlapping moves copy front to back, so to can't be above from
+static void ListenerMove(RegisteredEvent* to, RegisteredEvent* from, u32 count) {
+    for (u32 i = 0; i < count; i++) {
+        ListenerStore(&to[i], &from[i]);
+    }
+}
+
+static void TableWriteBegin() {
+    __atomic_store_n(&event_state_ptr->generation, event_state_ptr->generation + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void TableWriteEnd() {
+    __atomic_store_n(&event_state_ptr->generation, event_state_ptr->generation + 1, __ATOMIC_RELEASE);
+}
+
+//Old table buffers are kept until no other thread can be reading them
+static void Retire(void* block, u64 size, MemoryTag tag) {
+    RetiredBlock retired = {block, size, tag};
+    DarrayPush(event_state_ptr->retired, retired);
+}
+
+static void FreeRetired() {
+    u64 count = DarrayLength(event_state_ptr->retired);
+    for (u64 i = 0; i < count; i++) {
+        RetiredBlock* retired = &event_state_ptr->retired[i];
+        DFree(retired->block, retired->size, retired->tag);
+    }
+    DarrayClear(event_state_ptr->retired);
+}
+
+static EventCodeEntry* InsertCode(EventCodeEntry* codes, u32 capacity, u16 code) {
+    u32 mask = capacity - 1;
+    u32 slot = EventCodeHash(code) & mask;
+    while (codes[slot].used) {
+        slot = (slot + 1) & mask;
+    }
+    __atomic_store_n(&codes[slot].code, code, __ATOMIC_RELAXED);
+    __atomic_store_n(&codes[slot].used, (b8)true, __ATOMIC_RELAXED);
+    return &codes[slot];
+}
+
+static EventCodeEntry* FindOrAddCode(u16 code) {
+    EventCodeEntry* entry = FindCode(code);
+    if (entry) {
+        return entry;
+    }
+    //keep the load under 3/4 so probes stay short
+    if ((event_state_ptr->code_count + 1) * 4 > event_state_ptr->code_capacity * 3) {
+        u32 new_capacity = event_state_ptr->code_capacity * 2;
+        EventCodeEntry* new_codes = (EventCodeEntry*)DAllocate(sizeof(EventCodeEntry) * new_capacity, MEMORY_TAG_DICT);
+        for (u32 i = 0; i < event_state_ptr->code_capacity; i++) {
+            EventCodeEntry* old = &event_state_ptr->codes[i];
+            if (old->used) {
+                *InsertCode(new_codes, new_capacity, old->code) = *old;
+            }
+        }
+        Retire(event_state_ptr->codes, sizeof(EventCodeEntry) * event_state_ptr->code_capacity, MEMORY_TAG_DICT);
+        //pointer before capacity, a reader that sees the new capacity also sees the new buffer
+        __atomic_store_n(&event_state_ptr->codes, new_codes, __ATOMIC_RELEASE);
+        __atomic_store_n(&event_state_ptr->code_capacity, new_capacity, __ATOMIC_RELEASE);
+    }
+    event_state_ptr->code_count++;
+    return InsertCode(event_state_ptr->codes, event_state_ptr->code_capacity, code);
+}
+
+static void PoolReserve(u32 capacity) {
+    if (capacity <= event_state_ptr->pool_capacity) {
+        return;
+    }
+    u32 new_capacity = event_state_ptr->pool_capacity * 2;
+    while (new_capacity < capacity) {
+        new_capacity *= 2;
+    }
+    RegisteredEvent* new_pool = (RegisteredEvent*)DAllocate(sizeof(RegisteredEvent) * new_capacity, MEMORY_TAG_ARRAY);
+    DCopyMemory(new_pool, event_state_ptr->pool, sizeof(RegisteredEvent) * event_state_ptr->pool_length);
+    Retire(event_state_ptr->pool, sizeof(RegisteredEvent) * event_state_ptr->pool_capacity, MEMORY_TAG_ARRAY);
+    __atomic_store_n(&event_state_ptr->pool, new_pool, __ATOMIC_RELEASE);
+    __atomic_store_n(&event_state_ptr->pool_capacity, new_capacity, __ATOMIC_RELEASE);
+}
+
+//Packs every live range to the front of the pool, dropping the ones abandoned by relocation
+static void PoolCompact() {
+    RegisteredEvent* new_pool = (RegisteredEvent*)DAllocate(sizeof(RegisteredEvent) * event_state_ptr->pool_capacity, MEMORY_TAG_ARRAY);
+    u32 length = 0;
+    for (u32 i = 0; i < event_state_ptr->code_capacity; i++) {
+        EventCodeEntry* entry = &event_state_ptr->codes[i];
+        if (!entry->used || !entry->capacity) {
+            continue;
+        }
+        DCopyMemory(new_pool + length, event_state_ptr->pool + entry->first, sizeof(RegisteredEvent) * entry->count);
+        __atomic_store_n(&entry->first, length, __ATOMIC_RELAXED);
+        length += entry->capacity;
+    }
+    Retire(event_state_ptr->pool, sizeof(RegisteredEvent) * event_state_ptr->pool_capacity, MEMORY_TAG_ARRAY);
+    __atomic_store_n(&event_state_ptr->pool, new_pool, __ATOMIC_RELEASE);
+    event_state_ptr->pool_length = length;
+}
+
+//Makes room for one more listener in the entry's range, growing it in place when it is last in the pool
+//and otherwise moving it to the end with double the capacity
+static void RangeReserveOne(EventCodeEntry* entry) {
+    if (entry->count < entry->capacity) {
+        return;
+    }
+    u32 new_capacity = entry->capacity ? entry->capacity * 2 : EVENT_LISTENER_RANGE_MIN_CAPACITY;
+    u32 abandoned = event_state_ptr->pool_length - event_state_ptr->pool_live;
+    if (abandoned > event_state_ptr->pool_live) {
+        PoolCompact();
+    }
+    event_state_ptr->pool_live += new_capacity - entry->capacity;
+    if (entry->capacity && entry->first + entry->capacity == event_state_ptr->pool_length) {
+        PoolReserve(entry->first + new_capacity);
+        event_state_ptr->pool_length = entry->first + new_capacity;
+    } else {
+        u32 first = event_state_ptr->pool_length;
+        PoolReserve(first + new_capacity);
+        ListenerMove(event_state_ptr->pool + first, event_state_ptr->pool + entry->first, entry->count);
+        event_state_ptr->pool_length = first + new_capacity;
+        __atomic_store_n(&entry->first, first, __ATOMIC_RELAXED);
+    }
+    entry->capacity = new_capacity;
+}
+
+//Drops the slots blanked by unregister, keeping the priority order of the rest
+static void SweepEntry(EventCodeEntry* entry) {
+    RegisteredEvent* range = event_state_ptr->pool + entry->first;
+    u32 kept = 0;
+    for (u32 i = 0; i < entry->count; i++) {
+        if (range[i].callback) {
+            ListenerStore(&range[kept++], &range[i]);
+        }
+    }
+    __atomic_store_n(&entry->count, kept, __ATOMIC_RELAXED);
+    entry->blanks = 0;
+}
+
+static void SweepRemovals() {
+    TableWriteBegin();
+    for (u32 i = 0; i < event_state_ptr->code_capacity; i++) {
+        EventCodeEntry* entry = &event_state_ptr->codes[i];
+        if (entry->used && entry->blanks) {
+            SweepEntry(entry);
+        }
+    }
+    event_state_ptr->removals_pending = false;
+    TableWriteEnd();
+}
+
+#if DEVENT_INSTRUMENTATION
+static u32 ListenerStatsIndex(u16 code, RegisteredEvent* event) {
+    u32 count = (u32)DarrayLength(event_state_ptr->listener_stats);
+    for (u32 i = 0; i < count; i++) {
+        EventListenerStats* stats = &event_state_ptr->listener_stats[i];
+        if (stats->code == code && stats->listener == event->listener && stats->callback == event->callback) {
+            return i;
+        }
+    }
+    EventListenerStats stats = {};
+    stats.code = code;
+    stats.listener = event->listener;
+    stats.callback = event->callback;
+    DarrayPush(event_state_ptr->listener_stats, stats);
+    return count;
+}
+#endif
+
+//Inserts after every listener of higher or equal priority, equal priorities keep registration order
+static void InsertListener(u16 code, RegisteredEvent* event) {
+#if DEVENT_INSTRUMENTATION
+    event->stats_index = ListenerStatsIndex(code, event);
+#endif
+    TableWriteBegin();
+    EventCodeEntry* entry = FindOrAddCode(code);
+    if (entry->blanks) {
+        SweepEntry(entry);
+    }
+    RangeReserveOne(entry);
+    RegisteredEvent* range = event_state_ptr->pool + entry->first;
+    u32 index = entry->count;
+    while (index > 0 && range[index - 1].priority < event->priority) {
+        ListenerStore(&range[index], &range[index - 1]);
+        index--;
+    }
+    ListenerStore(&range[index], event);
+    __atomic_store_n(&entry->count, entry->count + 1, __ATOMIC_RELAXED);
+    TableWriteEnd();
+}
+
+static void ApplyPendingRegistrations() {
+    u64 count = DarrayLength(event_state_ptr->pending);
+    for (u64 i = 0; i < count; i++) {
+        InsertListener(event_state_ptr->pending[i].code, &event_state_ptr->pending[i].event);
+    }
+    DarrayClear(event_state_ptr->pending);
+}
+
+//Where a fire on another thread is in the code's range, between the chunks it copies out
+struct SnapshotCursor {
+    //generation the last chunk was read under and the range index it stopped at
+    u32 generation;
+    u32 next;
+    //the last listener copied, to find the place again when the range changed since
+    void* listener;
+    i16 priority;
+    b8 started;
+};
+
+/*
+Copies the next chunk of the code's live listeners out of the table for a fire on another thread, blanked
+slots skipped. Every read is bounds checked against the buffers it came from, a torn read is only ever wrong,
+never out of range, and the seqlock in the caller throws it away. out_next is the range index after the last
+slot looked at, out_more is set when the range goes on past it.
+*/
+static u32 SnapshotListeners(u16 code, u32 generation, SnapshotCursor* cursor, RegisteredEvent* out_listeners, u32* out_next, b8* out_more) {
+    *out_more = false;
+    u32 code_capacity = __atomic_load_n(&event_state_ptr->code_capacity, __ATOMIC_ACQUIRE);
+    EventCodeEntry* codes = __atomic_load_n(&event_state_ptr->codes, __ATOMIC_ACQUIRE);
+    u32 mask = code_capacity - 1;
+    u32 slot = EventCodeHash(code) & mask;
+    EventCodeEntry* entry = 0;
+    for (u32 probes = 0; probes < code_capacity; probes++, slot = (slot + 1) & mask) {
+        if (!__atomic_load_n(&codes[slot].used, __ATOMIC_RELAXED)) {
+            return 0;
+        }
+        if (__atomic_load_n(&codes[slot].code, __ATOMIC_RELAXED) == code) {
+            entry = &codes[slot];
+            break;
+        }
+    }
+    if (!entry) {
+        return 0;
+    }
+
+    u32 pool_capacity = __atomic_load_n(&event_state_ptr->pool_capacity, __ATOMIC_ACQUIRE);
+    RegisteredEvent* pool = __atomic_load_n(&event_state_ptr->pool, __ATOMIC_ACQUIRE);
+    u32 first = __atomic_load_n(&entry->first, __ATOMIC_RELAXED);
+    u32 total = __atomic_load_n(&entry->count, __ATOMIC_RELAXED);
+    if (first > pool_capacity || total > pool_capacity - first) {
+        return 0;
+    }
+    RegisteredEvent* range = pool + first;
+
+    u32 i = 0;
+    if (cursor->started && cursor->generation == generation) {
+        i = cursor->next;
+    } else if (cursor->started) {
+        //registered or swept since the last chunk. Carry on right after the last listener called, or where it
+        //was if it has been unregistered: before the first listener of lower priority
+        for (; i < total; i++) {
+            if (__atomic_load_n(&range[i].listener, __ATOMIC_RELAXED) == cursor->listener &&
+                __atomic_load_n(&range[i].callback, __ATOMIC_RELAXED)) {
+                i++;
+                break;
+            }
+            if (__atomic_load_n(&range[i].priority, __ATOMIC_RELAXED) < cursor->priority) {
+                break;
+            }
+        }
+    }
+    u32 count = 0;
+    for (; i < total && count < EVENT_CONCURRENT_FIRE_MAX_LISTENERS; i++) {
+        RegisteredEvent* listener = &out_listeners[count];
+        listener->callback = __atomic_load_n(&range[i].callback, __ATOMIC_RELAXED);
+        if (!listener->callback) {
+            continue;
+        }
+        listener->listener = __atomic_load_n(&range[i].listener, __ATOMIC_RELAXED);
+        listener->priority = __atomic_load_n(&range[i].priority, __ATOMIC_RELAXED);
+        count++;
+    }
+    *out_next = i;
+    *out_more = i < total;
+    return count;
+}
+
+/*
+Calls the code's listeners a chunk at a time, each chunk copied out under the seqlock. A registration or sweep
+between chunks is picked up by the next one, so listeners past the first chunk are called as long as they are
+registered and nobody is called twice.
+*/
+static b8 EventFireConcurrent(u16 code, void* sender, EventContext context) {
+    RegisteredEvent listeners[EVENT_CONCURRENT_FIRE_MAX_LISTENERS];
+    SnapshotCursor cursor = {};
+    //joining the count before reading the epoch's table means an unregister either waits for this fire or
+    //finished blanking before it reads the table
+    u32* readers = &event_state_ptr->readers_in_flight[__atomic_load_n(&event_state_ptr->reader_epoch, __ATOMIC_SEQ_CST) & 1];
+    __atomic_add_fetch(readers, 1, __ATOMIC_SEQ_CST);
+    b8 handled = false;
+    b8 more = true;
+    while (more && !handled) {
+        u32 count = 0;
+        u32 next = 0;
+        u32 generation = 0;
+        u32 spins = 0;
+        for (;;) {
+            generation = __atomic_load_n(&event_state_ptr->generation, __ATOMIC_ACQUIRE);
+            if (generation & 1) {
+                //main thread is mid registration, it never holds the table for long
+                Backoff(&spins);
+                continue;
+            }
+            count = SnapshotListeners(code, generation, &cursor, listeners, &next, &more);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&event_state_ptr->generation, __ATOMIC_RELAXED) == generation) {
+                break;
+            }
+        }
+
+        for (u32 i = 0; i < count; i++) {
+            if (listeners[i].callback(code, sender, listeners[i].listener, context)) {
+                handled = true;
+                break;
+            }
+        }
+        cursor.generation = generation;
+        cursor.next = next;
+        if (count) {
+            cursor.listener = listeners[count - 1].listener;
+            cursor.priority = listeners[count - 1].priority;
+        }
+        cursor.started = true;
+    }
+    __atomic_sub_fetch(readers, 1, __ATOMIC_SEQ_CST);
+    return handled;
+}
+
+//Main thread only. Returns once every fire on another thread that may have copied out the table before now
+//has finished calling its listeners
+static void WaitForConcurrentFires() {
+    u32 epoch = __atomic_fetch_add(&event_state_ptr->reader_epoch, 1, __ATOMIC_SEQ_CST);
+    u32 spins = 0;
+    while (__atomic_load_n(&event_state_ptr->readers_in_flight[epoch & 1], __ATOMIC_SEQ_CST)) {
+        Backoff(&spins);
+    }
+}
+
+//Runs on any thread. Vyukov style bounded enqueue, producers claim a cell by advancing enqueue_position
+static b8 ThreadQueuePush(EventThreadQueue* thread_queue, QueuedEvent* event) {
+    u64 position = __atomic_load_n(&thread_queue->enqueue_position, __ATOMIC_RELAXED);
+    EventThreadCell* cell;
+    for (;;) {
+        cell = &thread_queue->cells[position & (EVENT_THREAD_QUEUE_CAPACITY - 1)];
+        u64 sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        i64 difference = (i64)sequence - (i64)position;
+        if (difference == 0) {
+            if (__atomic_compare_exchange_n(&thread_queue->enqueue_position, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (difference < 0) {
+            //consumer has not caught up, ring is full
+            return false;
+        } else {
+            position = __atomic_load_n(&thread_queue->enqueue_position, __ATOMIC_RELAXED);
+        }
+    }
+    cell->event = *event;
+    __atomic_store_n(&cell->sequence, position + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+//Main thread only
+static b8 ThreadQueuePop(EventThreadQueue* thread_queue, QueuedEvent* out_event) {
+    u64 position = thread_queue->dequeue_position;
+    EventThreadCell* cell = &thread_queue->cells[position & (EVENT_THREAD_QUEUE_CAPACITY - 1)];
+    if (__atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) != position + 1) {
+        return false;
+    }
+    *out_event = cell->event;
+    __atomic_store_n(&cell->sequence, position + EVENT_THREAD_QUEUE_CAPACITY, __ATOMIC_RELEASE);
+    thread_queue->dequeue_position = position + 1;
+    return true;
+}
 
 void EventSystemInitialize(u64* memory_requirement, void* state) {
     *memory_requirement = sizeof(EventSystemState);
@@ -26,61 +555,132 @@ void EventSystemInitialize(u64* memory_requirement, void* state) {
     }
     DZeroMemory(state, sizeof(EventSystemState));
     event_state_ptr = (EventSystemState*)state;
+    event_thread_is_main = true;
+    event_state_ptr->code_capacity = EVENT_CODE_TABLE_INITIAL_CAPACITY;
+    event_state_ptr->codes = (EventCodeEntry*)DAllocate(sizeof(EventCodeEntry) * EVENT_CODE_TABLE_INITIAL_CAPACITY, MEMORY_TAG_DICT);
+    event_state_ptr->pool_capacity = EVENT_LISTENER_POOL_INITIAL_CAPACITY;
+    event_state_ptr->pool = (RegisteredEvent*)DAllocate(sizeof(RegisteredEvent) * EVENT_LISTENER_POOL_INITIAL_CAPACITY, MEMORY_TAG_ARRAY);
+    event_state_ptr->queue = (QueuedEvent*)DarrayReserve(QueuedEvent, EVENT_QUEUE_INITIAL_CAPACITY);
+    event_state_ptr->dispatching = (QueuedEvent*)DarrayReserve(QueuedEvent, EVENT_QUEUE_INITIAL_CAPACITY);
+    event_state_ptr->queue_generation = 1;
+    event_state_ptr->retired = (RetiredBlock*)DarrayCreate(RetiredBlock);
+    event_state_ptr->pending = (PendingRegistration*)DarrayCreate(PendingRegistration);
+#if DEVENT_INSTRUMENTATION
+    event_state_ptr->listener_stats = (EventListenerStats*)DarrayCreate(EventListenerStats);
+#endif
+    AllocatorCreate(EVENT_PAYLOAD_ARENA_SIZE, 0, &event_state_ptr->payload_arenas[0]);
+    AllocatorCreate(EVENT_PAYLOAD_ARENA_SIZE, 0, &event_state_ptr->payload_arenas[1]);
+
+    EventThreadCell* cells = (EventThreadCell*)DAllocate(sizeof(EventThreadCell) * EVENT_THREAD_QUEUE_COUNT * EVENT_THREAD_QUEUE_CAPACITY, MEMORY_TAG_RING_QUEUE);
+    for (u32 i = 0; i < EVENT_THREAD_QUEUE_COUNT; i++) {
+        EventThreadQueue* thread_queue = &event_state_ptr->thread_queues[i];
+        thread_queue->cells = cells + i * EVENT_THREAD_QUEUE_CAPACITY;
+        for (u64 j = 0; j < EVENT_THREAD_QUEUE_CAPACITY; j++) {
+            thread_queue->cells[j].sequence = j;
+        }
+    }
+
+    //these can arrive hundreds of times a frame and only the net result matters
+    EventSetCoalescePolicy(EVENT_CODE_MOUSE_MOVED, EVENT_COALESCE_LATEST);
+    EventSetCoalescePolicy(EVENT_CODE_RESIZED, EVENT_COALESCE_LATEST);
+    EventSetCoalescePolicy(EVENT_CODE_MOUSE_WHEEL, EVENT_COALESCE_ACCUMULATE);
 }
 
 void EventSystemShutdown(void* state) {
     if (event_state_ptr) {
-        for (u16 i = 0; i < MAX_MESSAGE_CODES; i++) {
-            if (event_state_ptr->registered[i].events != 0) {
-                DarrayDestroy(event_state_ptr->registered[i].events);
-                event_state_ptr->registered[i].events = 0;
-            }
-        }
+        FreeRetired();
+        DarrayDestroy(event_state_ptr->retired);
+        DarrayDestroy(event_state_ptr->pending);
+#if DEVENT_INSTRUMENTATION
+        DarrayDestroy(event_state_ptr->listener_stats);
+        event_state_ptr->listener_stats = 0;
+#endif
+        AllocatorDestroy(&event_state_ptr->payload_arenas[0]);
+        AllocatorDestroy(&event_state_ptr->payload_arenas[1]);
+        event_state_ptr->pending = 0;
+        DFree(event_state_ptr->codes, sizeof(EventCodeEntry) * event_state_ptr->code_capacity, MEMORY_TAG_DICT);
+        DFree(event_state_ptr->pool, sizeof(RegisteredEvent) * event_state_ptr->pool_capacity, MEMORY_TAG_ARRAY);
+        DFree(event_state_ptr->thread_queues[0].cells, sizeof(EventThreadCell) * EVENT_THREAD_QUEUE_COUNT * EVENT_THREAD_QUEUE_CAPACITY, MEMORY_TAG_RING_QUEUE);
+        event_state_ptr->retired = 0;
+        event_state_ptr->codes = 0;
+        event_state_ptr->pool = 0;
+        DarrayDestroy(event_state_ptr->queue);
+        DarrayDestroy(event_state_ptr->dispatching);
+        event_state_ptr->queue = 0;
+        event_state_ptr->dispatching = 0;
     }
+    event_state_ptr = 0;
+    event_thread_is_main = false;
 }
 
-b8 EventRegister(u16 code, void* listener, PfnOnEvent on_event) {
-    if (!event_state_ptr) {
+b8 EventRegister(u16 code, void* listener, PfnOnEvent on_event, i16 priority) {
+    if (!event_state_ptr || !event_thread_is_main) {
         return false;
     }
 
-    //RegisteredEvent* events = state.registered[code].events;
-
-    if (!event_state_ptr->registered[code].events) {
-        event_state_ptr->registered[code].events = (RegisteredEvent*)DarrayCreate(RegisteredEvent);
+    EventCodeEntry* entry = FindCode(code);
+    if (entry) {
+        RegisteredEvent* range = event_state_ptr->pool + entry->first;
+        for (u32 i = 0; i < entry->count; i++) {
+            if (range[i].callback && range[i].listener == listener) {
+                DWARN("EventRegister - listener is already registered for code %u.", code);
+                return false;
+            }
+        }
     }
-
-    u64 registered_count = DarrayLength(event_state_ptr->registered[code].events);
-    for (u64 i = 0; i < registered_count; i++) {
-        if (event_state_ptr->registered[code].events[i].listener == listener) {
-            //TODO: warn
+    u64 pending_count = DarrayLength(event_state_ptr->pending);
+    for (u64 i = 0; i < pending_count; i++) {
+        if (event_state_ptr->pending[i].code == code && event_state_ptr->pending[i].event.listener == listener) {
+            DWARN("EventRegister - listener is already registered for code %u.", code);
             return false;
         }
     }
 
-    RegisteredEvent event = {};
-    event.listener = listener;
-    event.callback = on_event;
-    DarrayPush(event_state_ptr->registered[code].events, event);
+    PendingRegistration registration = {};
+    registration.code = code;
+    registration.event.listener = listener;
+    registration.event.callback = on_event;
+    registration.event.priority = priority;
+    if (event_state_ptr->firing_depth) {
+        //inserting would shift the range under the running fire
+        DarrayPush(event_state_ptr->pending, registration);
+    } else {
+        InsertListener(code, &registration.event);
+    }
     return true;
 }
 
 b8 EventUnregister(u16 code, void* listener, PfnOnEvent on_event) {
-    if (!event_state_ptr) {
+    if (!event_state_ptr || !event_thread_is_main) {
         return false;
     }
 
-    if (!event_state_ptr->registered[code].events) {
+    u64 pending_count = DarrayLength(event_state_ptr->pending);
+    for (u64 i = 0; i < pending_count; i++) {
+        PendingRegistration* pending = &event_state_ptr->pending[i];
+        if (pending->code == code && pending->event.listener == listener && pending->event.callback == on_event) {
+            PendingRegistration popped;
+            DarrayPopAt(event_state_ptr->pending, i, &popped);
+            return true;
+        }
+    }
+
+    EventCodeEntry* entry = FindCode(code);
+    if (!entry) {
         return false;
     }
 
-    u64 registered_count = DarrayLength(event_state_ptr->registered[code].events);
-    for (u64 i = 0; i < registered_count; i++) {
-        RegisteredEvent e = event_state_ptr->registered[code].events[i];
-        //TODO: maybe make and equals function for events?
-        if (e.listener == listener && e.callback == on_event) {
-            RegisteredEvent poppedEvent = {};
-            DarrayPopAt(event_state_ptr->registered[code].events, i, &poppedEvent);
+    //blanking is O(1) and keeps the priority order, blanks are swept at the next dispatch or registration
+    RegisteredEvent* range = event_state_ptr->pool + entry->first;
+    for (u32 i = 0; i < entry->count; i++) {
+        if (range[i].listener == listener && range[i].callback == on_event) {
+            TableWriteBegin();
+            __atomic_store_n(&range[i].listener, (void*)0, __ATOMIC_RELAXED);
+            __atomic_store_n(&range[i].callback, (PfnOnEvent)0, __ATOMIC_RELAXED);
+            entry->blanks++;
+            event_state_ptr->removals_pending = true;
+            TableWriteEnd();
+            WaitForConcurrentFires();
             return true;
         }
     }
@@ -91,19 +691,221 @@ b8 EventFire(u16 code, void* sender, EventContext context) {
     if (!event_state_ptr) {
         return false;
     }
+    if (!event_thread_is_main) {
+        return EventFireConcurrent(code, sender, context);
+    }
 
-    if (!event_state_ptr->registered[code].events) {
+    EventCodeEntry* entry = FindCode(code);
+    if (!entry || !entry->count) {
         return false;
     }
 
-    u64 registered_count = DarrayLength(event_state_ptr->registered[code].events);
-    for (u64 i = 0; i < registered_count; i++) {
-        RegisteredEvent e = event_state_ptr->registered[code].events[i];
-        //TODO: maybe make and equals function for events?
-        if (e.callback(code, sender, e.listener, context)) {
-            //Message handled, dont send ot other listeners
-            return true;
+#if DEVENT_INSTRUMENTATION
+    entry->frame_count++;
+    entry->total_count++;
+#endif
+
+    //nothing moves the range while firing, a callback can only blank slots or grow the code table
+    u32 count = entry->count;
+    u32 first = entry->first;
+    b8 handled = false;
+    event_state_ptr->firing_depth++;
+    for (u32 i = 0; i < count; i++) {
+        RegisteredEvent e = event_state_ptr->pool[first + i];
+        if (!e.callback) {
+            continue;
+        }
+#if DEVENT_INSTRUMENTATION
+        u64 start_ticks = ClockGetTicks();
+        b8 consumed = e.callback(code, sender, e.listener, context);
+        EventListenerStats* stats = &event_state_ptr->listener_stats[e.stats_index];
+        stats->calls++;
+        stats->ticks += ClockGetTicks() - start_ticks;
+#else
+        b8 consumed = e.callback(code, sender, e.listener, context);
+#endif
+        if (consumed) {
+            //Message handled, lower priority listeners never see it
+            handled = true;
+            break;
         }
     }
-    return false;
-}
\ No newline at end of file
+    event_state_ptr->firing_depth--;
+    if (!event_state_ptr->firing_depth && DarrayLength(event_state_ptr->pending)) {
+        ApplyPendingRegistrations();
+    }
+    return handled;
+}
+
+//Main thread side of EventPost, where coalescing happens
+static void EventQueue(u16 code, void* sender, EventContext context) {
+    EventCodeEntry* entry = FindCode(code);
+    if (entry && entry->coalesce_policy != EVENT_COALESCE_KEEP_ALL && entry->queued_generation == event_state_ptr->queue_generation) {
+        QueuedEvent* queued = &event_state_ptr->queue[entry->queued_index];
+        if (entry->coalesce_policy == EVENT_COALESCE_LATEST) {
+            queued->sender = sender;
+            queued->context = context;
+        } else {
+            for (u32 i = 0; i < 4; i++) {
+                queued->context.data.i32[i] += context.data.i32[i];
+            }
+        }
+        return;
+    }
+
+    if (entry) {
+        entry->queued_index = (u32)DarrayLength(event_state_ptr->queue);
+        entry->queued_generation = event_state_ptr->queue_generation;
+    }
+    QueuedEvent queued = {};
+    queued.code = code;
+    queued.sender = sender;
+    queued.context = context;
+    DarrayPush(event_state_ptr->queue, queued);
+}
+
+b8 EventPost(u16 code, void* sender, EventContext context) {
+    if (!event_state_ptr) {
+        return false;
+    }
+    if (event_thread_is_main) {
+        EventQueue(code, sender, context);
+        return true;
+    }
+
+    if (event_thread_queue_index == 0xFFFFFFFF) {
+        event_thread_queue_index = __atomic_fetch_add(&event_state_ptr->next_thread_queue, 1, __ATOMIC_RELAXED) % EVENT_THREAD_QUEUE_COUNT;
+    }
+    QueuedEvent queued = {};
+    queued.code = code;
+    queued.sender = sender;
+    queued.context = context;
+    return ThreadQueuePush(&event_state_ptr->thread_queues[event_thread_queue_index], &queued);
+}
+
+void EventSetCoalescePolicy(u16 code, EventCoalescePolicy policy) {
+    if (!event_state_ptr || !event_thread_is_main) {
+        return;
+    }
+    TableWriteBegin();
+    FindOrAddCode(code)->coalesce_policy = (u8)policy;
+    TableWriteEnd();
+}
+
+u32 EventDispatchQueued() {
+    if (!event_state_ptr || !event_thread_is_main) {
+        return 0;
+    }
+    //other threads' posts join this frame's queue, getting the same coalescing as main thread posts
+    for (u32 i = 0; i < EVENT_THREAD_QUEUE_COUNT; i++) {
+        QueuedEvent event;
+        while (ThreadQueuePop(&event_state_ptr->thread_queues[i], &event)) {
+            EventQueue(event.code, event.sender, event.context);
+        }
+    }
+#if DEVENT_INSTRUMENTATION
+    for (u32 i = 0; i < event_state_ptr->code_capacity; i++) {
+        EventCodeEntry* entry = &event_state_ptr->codes[i];
+        entry->last_frame_count = entry->frame_count;
+        entry->frame_count = 0;
+    }
+#endif
+    if (event_state_ptr->removals_pending && !event_state_ptr->firing_depth) {
+        SweepRemovals();
+    }
+    if (DarrayLength(event_state_ptr->retired) && __atomic_load_n(&event_state_ptr->readers_in_flight[0], __ATOMIC_SEQ_CST) == 0 &&
+        __atomic_load_n(&event_state_ptr->readers_in_flight[1], __ATOMIC_SEQ_CST) == 0) {
+        FreeRetired();
+    }
+
+    QueuedEvent* events = event_state_ptr->queue;
+    event_state_ptr->queue = event_state_ptr->dispatching;
+    event_state_ptr->dispatching = events;
+    event_state_ptr->queue_generation++;
+    LinearAllocator* payloads = &event_state_ptr->payload_arenas[event_state_ptr->payload_arena_index];
+    event_state_ptr->payload_arena_index ^= 1;
+
+    u32 count = (u32)DarrayLength(events);
+    for (u32 i = 0; i < count; i++) {
+        EventFire(events[i].code, events[i].sender, events[i].context);
+    }
+    DarrayClear(events);
+    //payloads are overwritten by their next sender, no need to pay for AllocatorFreeAll's zeroing
+    payloads->allocated = 0;
+    return count;
+}
+
+void* EventPayloadAllocate(u32 size, u32 type, EventContext* out_context) {
+    if (!event_state_ptr || !event_thread_is_main) {
+        return 0;
+    }
+    LinearAllocator* arena = &event_state_ptr->payload_arenas[event_state_ptr->payload_arena_index];
+    u64 aligned_size = (size + 15) & ~15ULL;
+    if (arena->allocated + aligned_size > arena->totalSize) {
+        return 0;
+    }
+    void* payload = AllocatorAllocate(arena, aligned_size);
+    out_context->data.payload.ptr = payload;
+    out_context->data.payload.size = size;
+    out_context->data.payload.type = type;
+    return payload;
+}
+
+#if DEVENT_INSTRUMENTATION
+u32 EventGetCodeStats(EventCodeStats* out_stats, u32 max_count) {
+    if (!event_state_ptr) {
+        return 0;
+    }
+    u32 listener_count = (u32)DarrayLength(event_state_ptr->listener_stats);
+    u32 count = 0;
+    for (u32 i = 0; i < event_state_ptr->code_capacity; i++) {
+        EventCodeEntry* entry = &event_state_ptr->codes[i];
+        if (!entry->used || !entry->total_count) {
+            continue;
+        }
+        if (out_stats && count < max_count) {
+            EventCodeStats* stats = &out_stats[count];
+            stats->code = entry->code;
+            stats->last_frame_count = entry->last_frame_count;
+            stats->total_count = entry->total_count;
+            stats->listener_count = 0;
+            u64 listener_ticks = 0;
+            for (u32 j = 0; j < listener_count; j++) {
+                EventListenerStats* listener = &event_state_ptr->listener_stats[j];
+                if (listener->code == entry->code) {
+                    stats->listener_count++;
+                    listener_ticks += listener->ticks;
+                }
+            }
+            stats->listener_seconds = ClockTicksToSeconds(listener_ticks);
+        }
+        count++;
+    }
+    return count;
+}
+
+u32 EventGetListenerStats(EventListenerStats* out_stats, u32 max_count) {
+    if (!event_state_ptr) {
+        return 0;
+    }
+    u32 count = (u32)DarrayLength(event_state_ptr->listener_stats);
+    if (out_stats) {
+        DCopyMemory(out_stats, event_state_ptr->listener_stats, sizeof(EventListenerStats) * Minimum(count, max_count));
+        for (u32 i = 0; i < Minimum(count, max_count); i++) {
+            out_stats[i].seconds = ClockTicksToSeconds(out_stats[i].ticks);
+        }
+    }
+    return count;
+}
+
+void EventLogStats() {
+    EventCodeStats stats[64];
+    u32 count = EventGetCodeStats(stats, ArrayCount(stats));
+    DINFO("Event stats, %u codes fired:", count);
+    for (u32 i = 0; i < Minimum(count, (u32)ArrayCount(stats)); i++) {
+        DINFO("  code 0x%04x: %u last frame, %llu total, %u listeners took %.3f ms",
+              stats[i].code, stats[i].last_frame_count, (unsigned long long)stats[i].total_count, stats[i].listener_count,
+              stats[i].listener_seconds * 1000.0);
+    }
+}
+#endif
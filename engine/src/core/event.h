@@ -2,8 +2,24 @@
 
 #include "defines.h"
 
+//Per code fire counts and listener timing in EventFire, compiled out entirely when 0
+#ifndef DEVENT_INSTRUMENTATION
+    #if DRELEASE == 1
+        #define DEVENT_INSTRUMENTATION 0
+    #else
+        #define DEVENT_INSTRUMENTATION 1
+    #endif
+#endif
+
 //offhand idea, have arrays for each input (an array for W, A, S, D etc) and loop the array to trigger events
 
+struct EventPayload{
+    void* ptr;
+    u32 size;
+    //sender defined tag so listeners can check what the pointer holds
+    u32 type;
+};
+
 struct EventContext{
     //128 bytes
     union {
@@ -22,13 +38,33 @@ struct EventContext{
         u8 u8[16];
 
         char c[16];
+
+        //larger data placed in the frame's payload arena by EventPayloadAllocate
+        EventPayload payload;
     } data;
 };
 
+//Typed view of a payload, null when the context's payload type doesn't match
+#define EventPayloadGet(context, payload_type, type_id) \
+    ((context).data.payload.type == (type_id) ? (payload_type*)(context).data.payload.ptr : (payload_type*)0)
+
 typedef b8 (*PfnOnEvent)(u16 code, void* sender, void* listenerInst, EventContext data);
 
-void EventSystemInitialize(u64* memoryRequirement, void* state);
-void EventSystemShutdown(void* state);
+/*
+The thread that initializes the event system is its main thread. Registering, unregistering, setting
+policies and dispatching the queue only work there, EventFire and EventPost work on any thread.
+*/
+DAPI void EventSystemInitialize(u64* memoryRequirement, void* state);
+DAPI void EventSystemShutdown(void* state);
+
+//Listeners with a higher priority are called first and can consume the event before lower ones see it
+enum EventPriority {
+    EVENT_PRIORITY_LOW = -100,
+    EVENT_PRIORITY_NORMAL = 0,
+    EVENT_PRIORITY_HIGH = 100,
+    //UI layers, ahead of gameplay
+    EVENT_PRIORITY_UI = 200
+};
 
 /*
 Register to listen for when events are sent twitht he provided code. Events with duplicate listener/callback combos
@@ -36,17 +72,62 @@ won't be registered and will return false.
 code = event code to listen for
 listener = pointer to listener instance
 onEvent = callback function pointer to invoke when event code is fired
+priority = order the listener is called in, highest first. Equal priorities are called in registration order
 */
-DAPI b8 EventRegister(u16 code, void* listener, PfnOnEvent onEvent);
+DAPI b8 EventRegister(u16 code, void* listener, PfnOnEvent onEvent, i16 priority);
 
 /*
 Unregister from listening for when event sare sent witht he provided code. If no matching registration is found,
-return false
+return false. Waits for fires on other threads that may have already picked up the listener to finish, so the
+callback is never called once this returns. A listener that waits on the main thread from inside a fire off
+the main thread would deadlock it.
 */
 DAPI b8 EventUnregister(u16 code, void* listener, PfnOnEvent onEvent);
 
+/*
+Sends the event to its listeners immediately, on the caller's stack. Off the main thread the code's listeners
+are copied out of the table without locking, 32 at a time, and called on the calling thread, so those listeners
+have to be thread safe. A listener registered while such a fire is running may or may not be called by it.
+*/
 DAPI b8 EventFire(u16 code, void* sender, EventContext context);
 
+/*
+Queues the event for the next dispatch point instead of firing it inside the caller. The application
+dispatches the queue once per frame, right after platform messages are pumped. Events posted while the
+queue is being dispatched are delivered at the following dispatch.
+Posts from other threads go through a small lock free queue per thread that is drained into the main queue
+at the dispatch point. Returns false if that queue is full, which lasts until the next dispatch.
+*/
+DAPI b8 EventPost(u16 code, void* sender, EventContext context);
+
+//Fires everything queued by EventPost in posting order. Returns the number of events dispatched
+DAPI u32 EventDispatchQueued();
+
+/*
+Reserves size bytes (16 byte aligned) in the event system's frame arena and points out_context's payload at it,
+tagged with type so listeners can check what they got. The sender fills the returned memory and posts or fires
+the context as usual, listeners read it in place. The memory stays valid until the end of the dispatch that
+follows the allocation, after which the arena is reused without freeing. Main thread only, returns 0 when
+called elsewhere or when the arena is full. Not meant for codes with the accumulate coalescing policy.
+*/
+DAPI void* EventPayloadAllocate(u32 size, u32 type, EventContext* out_context);
+
+//How EventPost treats an event whose code already has one waiting in the queue
+enum EventCoalescePolicy {
+    //every post is delivered (default)
+    EVENT_COALESCE_KEEP_ALL,
+    //the queued event is overwritten with the newest sender and context
+    EVENT_COALESCE_LATEST,
+    //the newest context's data.i32 lanes are added onto the queued event's
+    EVENT_COALESCE_ACCUMULATE
+};
+
+/*
+Sets the coalescing policy for posted events with this code. A merged event keeps the queue position of
+the first post. Defaults: mouse moves and resizes are latest-wins, mouse wheel accumulates.
+*/
+DAPI void EventSetCoalescePolicy(u16 code, EventCoalescePolicy policy);
+
 //System internal codes. App should use codes beyond 255
 enum SystemEventCode{
     EVENT_CODE_APPLICATION_QUIT = 0x01,
@@ -58,4 +139,39 @@ enum SystemEventCode{
     EVENT_CODE_MOUSE_WHEEL = 0x07,
     EVENT_CODE_RESIZED = 0x08,
     MAX_EVENT_CODE = 0xFF
-};
\ No newline at end of file
+};
+
+#if DEVENT_INSTRUMENTATION
+/*
+Instrumentation only covers fires on the main thread. Counts roll over to the "last frame" slots at each
+EventDispatchQueued. Listener times are inclusive, a listener that fires another event is also charged
+for that event's listeners.
+*/
+struct EventCodeStats{
+    u16 code;
+    u32 last_frame_count;
+    u64 total_count;
+    u32 listener_count;
+    f64 listener_seconds;
+};
+
+struct EventListenerStats{
+    u16 code;
+    void* listener;
+    PfnOnEvent callback;
+    u64 calls;
+    //accumulated in clock ticks, seconds is filled in from them when the stats are copied out
+    u64 ticks;
+    f64 seconds;
+};
+
+//Copies up to max_count entries into out_stats, pass 0 to just get the count. Returns the entries available
+DAPI u32 EventGetCodeStats(EventCodeStats* out_stats, u32 max_count);
+DAPI u32 EventGetListenerStats(EventListenerStats* out_stats, u32 max_count);
+
+//Logs every code that has fired with its counts and total listener time
+DAPI void EventLogStats();
+
+//Seconds between the application loop's EventLogStats dumps
+#define EVENT_STATS_LOG_INTERVAL 10.0
+#endif
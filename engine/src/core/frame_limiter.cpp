@@ -0,0 +1,112 @@
+#include "frame_limiter.h"
+
+#include "core/datomic.h"
+#include "math/dmath.h"
+#include "platform/platform.h"
+
+//a guess at the first sleeps until there are measurements, typical of a scheduler tick
+#define FRAME_LIMITER_INITIAL_OVERSHOOT 0.002
+//pause instructions between clock reads while spinning
+#define FRAME_LIMITER_SPIN_PAUSES 16
+
+void FrameLimiterInit(FrameLimiter* limiter, f64 target_hz) {
+    *limiter = {};
+    limiter->sleep_overshoot_mean = FRAME_LIMITER_INITIAL_OVERSHOOT;
+    limiter->sleep_samples = 1;
+    FrameLimiterSetTarget(limiter, target_hz);
+}
+
+void FrameLimiterSetTarget(FrameLimiter* limiter, f64 target_hz) {
+    limiter->target_seconds = target_hz > 0 ? 1.0 / target_hz : 0;
+    //the next wait starts a fresh schedule rather than chasing the old one
+    limiter->next_deadline = 0;
+}
+
+static f64 SleepOvershootEstimate(FrameLimiter* limiter) {
+    f64 variance = limiter->sleep_samples > 1 ? limiter->sleep_overshoot_m2 / (limiter->sleep_samples - 1) : 0;
+    return limiter->sleep_overshoot_mean + dsqrt((f32)variance);
+}
+
+static void RecordSleepOvershoot(FrameLimiter* limiter, f64 overshoot) {
+    limiter->sleep_samples++;
+    f64 delta = overshoot - limiter->sleep_overshoot_mean;
+    limiter->sleep_overshoot_mean += delta / limiter->sleep_samples;
+    limiter->sleep_overshoot_m2 += delta * (overshoot - limiter->sleep_overshoot_mean);
+}
+
+static void RecordFrame(FrameLimiter* limiter, f64 now) {
+    if (limiter->last_frame_end != 0) {
+        f64 frame_time = now - limiter->last_frame_end;
+        limiter->frames++;
+        f64 delta = frame_time - limiter->frame_time_mean;
+        limiter->frame_time_mean += delta / limiter->frames;
+        limiter->frame_time_m2 += delta * (frame_time - limiter->frame_time_mean);
+        limiter->frame_time_max = Maximum(limiter->frame_time_max, frame_time);
+    }
+    limiter->last_frame_end = now;
+}
+
+void FrameLimiterWait(FrameLimiter* limiter) {
+    f64 now = PlatformGetAbsoluteTime();
+    if (limiter->target_seconds == 0) {
+        RecordFrame(limiter, now);
+        return;
+    }
+    if (limiter->next_deadline == 0) {
+        limiter->next_deadline = now;
+    }
+
+    if (now > limiter->next_deadline) {
+        limiter->missed_deadlines++;
+        //more than a frame behind, drop the backlog instead of running short frames to catch up
+        if (now - limiter->next_deadline > limiter->target_seconds) {
+            limiter->next_deadline = now;
+        }
+    } else {
+        f64 deadline = limiter->next_deadline;
+        //coarse part, one millisecond at a time so every sleep also refines the estimate
+        while (deadline - now > SleepOvershootEstimate(limiter) + 0.001) {
+            f64 sleep_start = now;
+            PlatformSleep(1);
+            now = PlatformGetAbsoluteTime();
+            RecordSleepOvershoot(limiter, (now - sleep_start) - 0.001);
+            limiter->sleep_seconds += now - sleep_start;
+        }
+        f64 spin_start = now;
+        while (now < deadline) {
+            for (u32 i = 0; i < FRAME_LIMITER_SPIN_PAUSES; i++) {
+                CpuPause();
+            }
+            now = PlatformGetAbsoluteTime();
+        }
+        limiter->spin_seconds += now - spin_start;
+        limiter->max_pacing_error = Maximum(limiter->max_pacing_error, now - deadline);
+    }
+    limiter->next_deadline += limiter->target_seconds;
+    RecordFrame(limiter, now);
+}
+
+void FrameLimiterGetStats(FrameLimiter* limiter, FrameLimiterStats* out_stats) {
+    out_stats->frames = limiter->frames;
+    out_stats->missed_deadlines = limiter->missed_deadlines;
+    out_stats->mean_frame_seconds = limiter->frame_time_mean;
+    out_stats->max_frame_seconds = limiter->frame_time_max;
+    f64 variance = limiter->frames > 1 ? limiter->frame_time_m2 / (limiter->frames - 1) : 0;
+    out_stats->jitter_seconds = dsqrt((f32)variance);
+    out_stats->max_pacing_error_seconds = limiter->max_pacing_error;
+    out_stats->sleep_seconds = limiter->sleep_seconds;
+    out_stats->spin_seconds = limiter->spin_seconds;
+}
+
+void FrameLimiterResetStats(FrameLimiter* limiter) {
+    limiter->frames = 0;
+    limiter->missed_deadlines = 0;
+    limiter->frame_time_mean = 0;
+    limiter->frame_time_m2 = 0;
+    limiter->frame_time_max = 0;
+    limiter->max_pacing_error = 0;
+    limiter->sleep_seconds = 0;
+    limiter->spin_seconds = 0;
+    //the next frame's time would span the reset, start measuring from there instead
+    limiter->last_frame_end = 0;
+}
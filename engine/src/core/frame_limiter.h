@@ -0,0 +1,58 @@
+#pragma once
+
+#include "defines.h"
+
+/*
+Paces the main loop to a target rate against absolute deadlines, so a late frame doesn't push every frame after
+it back. Waiting sleeps in whole milliseconds while the deadline is further away than the sleep is expected to
+overshoot, then spins on the clock with a pause instruction for the last stretch. The overshoot estimate is
+learned from the sleeps themselves (mean plus one deviation), so a coarse OS timer just means a longer spin,
+and a precise one means hardly any.
+*/
+struct FrameLimiter{
+    //0 runs unlimited, FrameLimiterWait then only records the frame times
+    f64 target_seconds;
+    f64 next_deadline;
+    f64 last_frame_end;
+
+    //running mean/variance of how far past the requested time a 1ms sleep wakes
+    f64 sleep_overshoot_mean;
+    f64 sleep_overshoot_m2;
+    u64 sleep_samples;
+
+    //frame time statistics since the last reset
+    u32 frames;
+    u32 missed_deadlines;
+    f64 frame_time_mean;
+    f64 frame_time_m2;
+    f64 frame_time_max;
+    f64 max_pacing_error;
+    f64 sleep_seconds;
+    f64 spin_seconds;
+};
+
+struct FrameLimiterStats{
+    u32 frames;
+    //frames whose work alone took longer than the target
+    u32 missed_deadlines;
+    f64 mean_frame_seconds;
+    f64 max_frame_seconds;
+    //standard deviation of the frame time
+    f64 jitter_seconds;
+    //furthest the limiter woke past a deadline it could have made
+    f64 max_pacing_error_seconds;
+    //where the waiting went, spinning is the part that keeps a core busy
+    f64 sleep_seconds;
+    f64 spin_seconds;
+};
+
+//target_hz of 0 runs unlimited
+DAPI void FrameLimiterInit(FrameLimiter* limiter, f64 target_hz);
+//Takes effect from the next frame, statistics are kept
+DAPI void FrameLimiterSetTarget(FrameLimiter* limiter, f64 target_hz);
+
+//Call once per frame after the frame's work. Returns once the frame's deadline is reached
+DAPI void FrameLimiterWait(FrameLimiter* limiter);
+
+DAPI void FrameLimiterGetStats(FrameLimiter* limiter, FrameLimiterStats* out_stats);
+DAPI void FrameLimiterResetStats(FrameLimiter* limiter);
@@ -2,15 +2,17 @@
 #include "core/event.h"
 #include "core/dmemory.h"
 #include "core/logger.h"
+#include "platform/platform.h"
 
+//one bit per key, so carrying a frame's state over is a handful of words
 struct KeyboardState{
-    b8 keys[256];
+    u64 keys[256 / 64];
 };
 
 struct MouseState{
     i16 x;
     i16 y;
-    u8 buttons[BUTTON_MAX_BUTTONS];
+    u8 buttons;
 };
 
 struct InputSystemState {
@@ -18,10 +20,34 @@ struct InputSystemState {
     KeyboardState keyboard_previous;
     MouseState mouse_current;
     MouseState mouse_previous;
+    //ring of raw events, write_position only grows and frame_begin is where the current frame starts
+    InputEvent events[INPUT_EVENT_RING_CAPACITY];
+    u64 write_position;
+    u64 frame_begin;
+    b8 muted;
 };
 
 static InputSystemState* input_state_ptr;
 
+DINLINE b8 KeyBit(KeyboardState* keyboard, u32 key) {
+    return (keyboard->keys[key >> 6] >> (key & 63)) & 1;
+}
+
+DINLINE b8 ButtonBit(MouseState* mouse, u32 button) {
+    return (mouse->buttons >> button) & 1;
+}
+
+static void RecordInputEvent(InputEventType type, u16 code, i16 x, i16 y, i8 wheel_delta) {
+    InputEvent* event = &input_state_ptr->events[input_state_ptr->write_position & (INPUT_EVENT_RING_CAPACITY - 1)];
+    event->timestamp = PlatformGetAbsoluteTime();
+    event->code = code;
+    event->x = x;
+    event->y = y;
+    event->type = (u8)type;
+    event->wheel_delta = wheel_delta;
+    input_state_ptr->write_position++;
+}
+
 void InputSystemInitialize(u64* memory_requirment, void* state) {
     *memory_requirment = sizeof(InputSystemState);
     if (state == 0) {
@@ -41,14 +67,46 @@ void InputUpdate(f64 delta_time) {
     if (!input_state_ptr) {
         return;
     }
-    //TODO: maybe change the states to pointers and just swap pointers back and forth instead of copying
-    DCopyMemory(&input_state_ptr->keyboard_previous, &input_state_ptr->keyboard_current, sizeof(KeyboardState));
-    DCopyMemory(&input_state_ptr->mouse_previous, &input_state_ptr->mouse_current, sizeof(MouseState));
+    //current has to carry over since only changes are reported, so previous takes a copy rather than a swap
+    input_state_ptr->keyboard_previous = input_state_ptr->keyboard_current;
+    input_state_ptr->mouse_previous = input_state_ptr->mouse_current;
+    input_state_ptr->frame_begin = input_state_ptr->write_position;
+}
+
+void InputEventsBegin(InputEventIterator* iterator) {
+    if (!input_state_ptr) {
+        iterator->position = 0;
+        iterator->end = 0;
+        return;
+    }
+    iterator->position = input_state_ptr->frame_begin;
+    iterator->end = input_state_ptr->write_position;
+}
+
+b8 InputEventsNext(InputEventIterator* iterator, InputEvent* out_event) {
+    if (!input_state_ptr || iterator->position >= iterator->end) {
+        return false;
+    }
+    //skip whatever the ring has overwritten since
+    u64 oldest = input_state_ptr->write_position > INPUT_EVENT_RING_CAPACITY ? input_state_ptr->write_position - INPUT_EVENT_RING_CAPACITY : 0;
+    if (iterator->position < oldest) {
+        iterator->position = oldest;
+    }
+    *out_event = input_state_ptr->events[iterator->position & (INPUT_EVENT_RING_CAPACITY - 1)];
+    iterator->position++;
+    return true;
+}
+
+void InputSetMuted(b8 muted) {
+    if (input_state_ptr) {
+        input_state_ptr->muted = muted;
+    }
 }
 
 void InputProcessKey(Keys key, b8 pressed) {
-    if (input_state_ptr && input_state_ptr->keyboard_current.keys[key] != pressed) {
-        input_state_ptr->keyboard_current.keys[key] = pressed;
+    if (input_state_ptr && !input_state_ptr->muted && KeyBit(&input_state_ptr->keyboard_current, key) != pressed) {
+        input_state_ptr->keyboard_current.keys[key >> 6] ^= 1ULL << (key & 63);
+        RecordInputEvent(pressed ? INPUT_EVENT_KEY_PRESSED : INPUT_EVENT_KEY_RELEASED, key, input_state_ptr->mouse_current.x, input_state_ptr->mouse_current.y, 0);
 
         if (key == KEY_LALT) {
             DINFO("Left alt %s.", pressed ? "pressed": "released");
@@ -68,92 +126,101 @@ void InputProcessKey(Keys key, b8 pressed) {
 
         EventContext context = {};
         context.data.u16[0] = key;
-        EventFire(pressed ? EVENT_CODE_KEY_PRESSED : EVENT_CODE_KEY_RELEASED, 0, context);
+        EventPost(pressed ? EVENT_CODE_KEY_PRESSED : EVENT_CODE_KEY_RELEASED, 0, context);
     }
 }
 
 void InputProcessButton(Buttons button, b8 pressed) {
-    if (input_state_ptr->mouse_current.buttons[button] != pressed) {
-        input_state_ptr->mouse_current.buttons[button] = pressed;
+    if (input_state_ptr && !input_state_ptr->muted && ButtonBit(&input_state_ptr->mouse_current, button) != pressed) {
+        input_state_ptr->mouse_current.buttons ^= 1 << button;
+        RecordInputEvent(pressed ? INPUT_EVENT_BUTTON_PRESSED : INPUT_EVENT_BUTTON_RELEASED, button, input_state_ptr->mouse_current.x, input_state_ptr->mouse_current.y, 0);
         EventContext context = {};
         context.data.u16[0] = button;
-        EventFire(pressed ? EVENT_CODE_BUTTON_PRESSED : EVENT_CODE_BUTTON_RELEASED, 0, context);
+        EventPost(pressed ? EVENT_CODE_BUTTON_PRESSED : EVENT_CODE_BUTTON_RELEASED, 0, context);
     }
 }
 
 void InputProcessMouseMove(i16 x, i16 y) {
-    if (input_state_ptr->mouse_current.x != x || input_state_ptr->mouse_current.y != y) {
+    if (input_state_ptr && !input_state_ptr->muted && (input_state_ptr->mouse_current.x != x || input_state_ptr->mouse_current.y != y)) {
         //DDEBUG("Mouse pos: %i, %i", x, y);
         input_state_ptr->mouse_current.x = x;
         input_state_ptr->mouse_current.y = y;
+        RecordInputEvent(INPUT_EVENT_MOUSE_MOVED, 0, x, y, 0);
 
         EventContext context = {};
         context.data.u16[0] = x;
         context.data.u16[1] = y;
-        EventFire(EVENT_CODE_MOUSE_MOVED, 0, context);
+        EventPost(EVENT_CODE_MOUSE_MOVED, 0, context);
     }
 }
 
 void InputProcessMouseWheel(i8 zDelta) {
+    if (input_state_ptr && input_state_ptr->muted) {
+        return;
+    }
+    if (input_state_ptr) {
+        RecordInputEvent(INPUT_EVENT_MOUSE_WHEEL, 0, input_state_ptr->mouse_current.x, input_state_ptr->mouse_current.y, zDelta);
+    }
     EventContext context = {};
-    context.data.u8[0] = zDelta;
-    EventFire(EVENT_CODE_MOUSE_WHEEL, 0, context);
+    //i32 so queued wheel events can be summed, the low byte still reads as the i8 delta
+    context.data.i32[0] = zDelta;
+    EventPost(EVENT_CODE_MOUSE_WHEEL, 0, context);
 }
 
 b8 InputIsKeyDown(Keys key) {
     if (!input_state_ptr) {
         return false;
     }
-    return input_state_ptr->keyboard_current.keys[key] == true;
+    return KeyBit(&input_state_ptr->keyboard_current, key);
 }
 
 b8 InputIsKeyUp(Keys key) {
     if (!input_state_ptr) {
         return true;
     }
-    return input_state_ptr->keyboard_current.keys[key] == false;
+    return !KeyBit(&input_state_ptr->keyboard_current, key);
 }
 
 b8 InputWasKeyDown(Keys key) {
     if (!input_state_ptr) {
         return false;
     }
-    return input_state_ptr->keyboard_previous.keys[key] == true;
+    return KeyBit(&input_state_ptr->keyboard_previous, key);
 }
 
 b8 InputWasKeyUp(Keys key) {
     if (!input_state_ptr) {
         return true;
     }
-    return input_state_ptr->keyboard_previous.keys[key] == false;
+    return !KeyBit(&input_state_ptr->keyboard_previous, key);
 }
 
 b8 InputIsButtonDown(Buttons button) {
     if (!input_state_ptr) {
         return false;
     }
-    return input_state_ptr->mouse_current.buttons[button] == true;
+    return ButtonBit(&input_state_ptr->mouse_current, button);
 }
 
 b8 InputIsButtonUp(Buttons button) {
     if (!input_state_ptr) {
         return true;
     }
-    return input_state_ptr->mouse_current.buttons[button] == false;
+    return !ButtonBit(&input_state_ptr->mouse_current, button);
 }
 
 b8 InputWasButtonDown(Buttons button) {
     if (!input_state_ptr) {
         return false;
     }
-    return input_state_ptr->mouse_previous.buttons[button] == true;
+    return ButtonBit(&input_state_ptr->mouse_previous, button);
 }
 
 b8 InputWasButtonUp(Buttons button) {
     if (!input_state_ptr) {
         return true;
     }
-    return input_state_ptr->mouse_previous.buttons[button] == false;
+    return !ButtonBit(&input_state_ptr->mouse_previous, button);
 }
 
 void InputGetMousePosition(i32* x, i32* y) {
@@ -175,3 +242,14 @@ void InputGetPreviousMousePosition(i32* x, i32* y) {
     *x = input_state_ptr->mouse_previous.x;
     *y = input_state_ptr->mouse_previous.y;
 }
+
+void InputGetRawState(InputRawState* out_state) {
+    if (!input_state_ptr) {
+        DZeroMemory(out_state, sizeof(InputRawState));
+        return;
+    }
+    for (u32 i = 0; i < ArrayCount(out_state->keys); i++) {
+        out_state->keys[i] = input_state_ptr->keyboard_current.keys[i];
+    }
+    out_state->buttons = input_state_ptr->mouse_current.buttons;
+}
@@ -143,9 +143,45 @@ enum Keys {
     KEYS_MAX_KEYS
 };
 
-void InputSystemInitialize(u64* memoryRequirement, void* state);
-void InputSystemShutdown(void* state);
-void InputUpdate(f64 delta_time);
+enum InputEventType{
+    INPUT_EVENT_KEY_PRESSED,
+    INPUT_EVENT_KEY_RELEASED,
+    INPUT_EVENT_BUTTON_PRESSED,
+    INPUT_EVENT_BUTTON_RELEASED,
+    INPUT_EVENT_MOUSE_MOVED,
+    INPUT_EVENT_MOUSE_WHEEL
+};
+
+//One raw input change, stamped with PlatformGetAbsoluteTime when the platform layer reported it
+struct InputEvent{
+    f64 timestamp;
+    //key or button, depending on type
+    u16 code;
+    i16 x;
+    i16 y;
+    u8 type;
+    i8 wheel_delta;
+};
+
+//Walks the events recorded during the current frame, oldest first
+struct InputEventIterator{
+    u64 position;
+    u64 end;
+};
+
+//Events kept in the ring, a frame with more than this loses its oldest events
+#define INPUT_EVENT_RING_CAPACITY 1024
+
+DAPI void InputSystemInitialize(u64* memoryRequirement, void* state);
+DAPI void InputSystemShutdown(void* state);
+DAPI void InputUpdate(f64 delta_time);
+
+/*
+Every key, button, move and wheel change since the last InputUpdate, in the order they happened. Unlike the
+Is/Was queries this keeps taps that start and end within one frame and every intermediate mouse position.
+*/
+DAPI void InputEventsBegin(InputEventIterator* iterator);
+DAPI b8 InputEventsNext(InputEventIterator* iterator, InputEvent* out_event);
 
 // keyboard input
 DAPI b8 InputIsKeyDown(Keys key);
@@ -153,7 +189,7 @@ DAPI b8 InputIsKeyUp(Keys key);
 DAPI b8 InputWasKeyDown(Keys key);
 DAPI b8 InputWasKeyUp(Keys key);
 
-void InputProcessKey(Keys key, b8 pressed);
+DAPI void InputProcessKey(Keys key, b8 pressed);
 
 // mouse input
 DAPI b8 InputIsButtonDown(Buttons button);
@@ -163,6 +199,20 @@ DAPI b8 InputWasButtonUp(Buttons button);
 DAPI void InputGetMousePosition(i32* x, i32* y);
 DAPI void InputGetPreviousMousePosition(i32* x, i32* y);
 
-void InputProcessButton(Buttons button, b8 pressed);
-void InputProcessMouseMove(i16 x, i16 y);
-void InputProcessMouseWheel(i8 zDelta);
\ No newline at end of file
+//Bitset view of the current key and button state, for code evaluating many bindings at once
+struct InputRawState{
+    u64 keys[256 / 64];
+    u8 buttons;
+};
+
+DAPI void InputGetRawState(InputRawState* out_state);
+
+/*
+While muted the InputProcess functions drop whatever they are given. Input playback mutes the platform's
+message pump, so the window keeps getting its messages without live input mixing into the recorded frames.
+*/
+DAPI void InputSetMuted(b8 muted);
+
+DAPI void InputProcessButton(Buttons button, b8 pressed);
+DAPI void InputProcessMouseMove(i16 x, i16 y);
+DAPI void InputProcessMouseWheel(i8 zDelta);
\ No newline at end of file
@@ -0,0 +1,296 @@
+#include "core/input_actions.h"
+#include "core/dmemory.h"
+#include "core/dstring.h"
+#include "core/logger.h"
+
+#include <stdlib.h>
+
+struct InputBinding {
+    u64 keys[256 / 64];
+    u8 buttons;
+    u16 action;
+    f32 scale;
+};
+
+struct InputActionsState {
+    char names[INPUT_MAX_ACTIONS][INPUT_ACTION_NAME_MAX];
+    u8 types[INPUT_MAX_ACTIONS];
+    u16 action_count;
+    //axis actions as a bitset, their values get clamped instead of turned into 0/1
+    u64 axis_mask;
+    u64 down_previous;
+
+    InputBinding bindings[INPUT_MAX_BINDINGS];
+    u32 binding_count;
+
+    f32 values[INPUT_MAX_ACTIONS];
+    InputActionState states[INPUT_MAX_ACTIONS];
+};
+
+static InputActionsState* actions_state_ptr;
+
+//Names for the keys whose KEY_ name isn't a letter, digit, F key or numpad digit
+struct KeyName {
+    char* name;
+    Keys key;
+};
+
+static KeyName key_names[] = {
+    {"BACKSPACE", KEY_BACKSPACE}, {"ENTER", KEY_ENTER}, {"TAB", KEY_TAB}, {"SHIFT", KEY_SHIFT},
+    {"CONTROL", KEY_CONTROL}, {"PAUSE", KEY_PAUSE}, {"CAPITAL", KEY_CAPITAL}, {"ESCAPE", KEY_ESCAPE},
+    {"SPACE", KEY_SPACE}, {"PRIOR", KEY_PRIOR}, {"NEXT", KEY_NEXT}, {"END", KEY_END}, {"HOME", KEY_HOME},
+    {"LEFT", KEY_LEFT}, {"UP", KEY_UP}, {"RIGHT", KEY_RIGHT}, {"DOWN", KEY_DOWN}, {"INSERT", KEY_INSERT},
+    {"DELETE", KEY_DELETE}, {"LWIN", KEY_LWIN}, {"RWIN", KEY_RWIN}, {"APPS", KEY_APPS},
+    {"MULTIPLY", KEY_MULTIPLY}, {"ADD", KEY_ADD}, {"SUBTRACT", KEY_SUBTRACT}, {"DECIMAL", KEY_DECIMAL},
+    {"DIVIDE", KEY_DIVIDE}, {"NUMLOCK", KEY_NUMLOCK}, {"SCROLL", KEY_SCROLL}, {"LSHIFT", KEY_LSHIFT},
+    {"RSHIFT", KEY_RSHIFT}, {"LCONTROL", KEY_LCONTROL}, {"RCONTROL", KEY_RCONTROL}, {"LALT", KEY_LALT},
+    {"RALT", KEY_RALT}, {"SEMICOLON", KEY_SEMICOLON}, {"PLUS", KEY_PLUS}, {"COMMA", KEY_COMMA},
+    {"MINUS", KEY_MINUS}, {"PERIOD", KEY_PERIOD}, {"SLASH", KEY_SLASH}, {"GRAVE", KEY_GRAVE}
+};
+
+static b8 ParseNumber(StringView text, u32* out_value) {
+    if (text.length == 0 || text.length > 2) {
+        return false;
+    }
+    u32 value = 0;
+    for (u64 i = 0; i < text.length; i++) {
+        if (text.str[i] < '0' || text.str[i] > '9') {
+            return false;
+        }
+        value = value * 10 + (text.str[i] - '0');
+    }
+    *out_value = value;
+    return true;
+}
+
+static b8 KeyFromName(StringView name, Keys* out_key) {
+    if (name.length == 1 && ((name.str[0] >= 'A' && name.str[0] <= 'Z') || (name.str[0] >= '0' && name.str[0] <= '9'))) {
+        //virtual key codes for letters and digits are their ascii values
+        *out_key = (Keys)name.str[0];
+        return true;
+    }
+    u32 number = 0;
+    if (name.length > 1 && name.str[0] == 'F' && ParseNumber(StringViewSlice(name, 1, name.length), &number) && number >= 1 && number <= 24) {
+        *out_key = (Keys)(KEY_F1 + number - 1);
+        return true;
+    }
+    StringView numpad = StringViewFromCStr("NUMPAD");
+    if (name.length == numpad.length + 1 && StringViewsEqual(StringViewSlice(name, 0, numpad.length), numpad) &&
+        ParseNumber(StringViewSlice(name, numpad.length, name.length), &number)) {
+        *out_key = (Keys)(KEY_NUMPAD0 + number);
+        return true;
+    }
+    for (u32 i = 0; i < ArrayCount(key_names); i++) {
+        if (StringViewsEqual(name, StringViewFromCStr(key_names[i].name))) {
+            *out_key = key_names[i].key;
+            return true;
+        }
+    }
+    return false;
+}
+
+static b8 ButtonFromName(StringView name, Buttons* out_button) {
+    if (StringViewsEqual(name, StringViewFromCStr("MOUSE_LEFT"))) {
+        *out_button = BUTTON_LEFT;
+    } else if (StringViewsEqual(name, StringViewFromCStr("MOUSE_RIGHT"))) {
+        *out_button = BUTTON_RIGHT;
+    } else if (StringViewsEqual(name, StringViewFromCStr("MOUSE_MIDDLE"))) {
+        *out_button = BUTTON_MIDDLE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void InputActionsInitialize(u64* memory_requirement, void* state) {
+    *memory_requirement = sizeof(InputActionsState);
+    if (state == 0) {
+        return;
+    }
+    DZeroMemory(state, sizeof(InputActionsState));
+    actions_state_ptr = (InputActionsState*)state;
+}
+
+void InputActionsShutdown(void* state) {
+    actions_state_ptr = 0;
+}
+
+u16 InputActionFind(char* name) {
+    if (!actions_state_ptr) {
+        return INPUT_ACTION_INVALID;
+    }
+    for (u16 i = 0; i < actions_state_ptr->action_count; i++) {
+        if (StringsEqual(actions_state_ptr->names[i], name)) {
+            return i;
+        }
+    }
+    return INPUT_ACTION_INVALID;
+}
+
+u16 InputActionRegister(char* name, InputActionType type) {
+    if (!actions_state_ptr) {
+        return INPUT_ACTION_INVALID;
+    }
+    u16 existing = InputActionFind(name);
+    if (existing != INPUT_ACTION_INVALID) {
+        return existing;
+    }
+    if (actions_state_ptr->action_count == INPUT_MAX_ACTIONS || StringLength(name) >= INPUT_ACTION_NAME_MAX) {
+        DERROR("InputActionRegister - can't register '%s', too many actions or name too long.", name);
+        return INPUT_ACTION_INVALID;
+    }
+    u16 action = actions_state_ptr->action_count++;
+    StringViewCopy(StringViewFromCStr(name), actions_state_ptr->names[action], INPUT_ACTION_NAME_MAX);
+    actions_state_ptr->types[action] = (u8)type;
+    if (type == INPUT_ACTION_AXIS) {
+        actions_state_ptr->axis_mask |= 1ULL << action;
+    }
+    return action;
+}
+
+b8 InputActionBind(u16 action, Keys* keys, u32 key_count, Buttons* buttons, u32 button_count, f32 scale) {
+    if (!actions_state_ptr || action >= actions_state_ptr->action_count || key_count + button_count == 0) {
+        return false;
+    }
+    if (actions_state_ptr->binding_count == INPUT_MAX_BINDINGS) {
+        DERROR("InputActionBind - binding table is full.");
+        return false;
+    }
+    InputBinding* binding = &actions_state_ptr->bindings[actions_state_ptr->binding_count++];
+    DZeroMemory(binding, sizeof(InputBinding));
+    for (u32 i = 0; i < key_count; i++) {
+        binding->keys[keys[i] >> 6] |= 1ULL << (keys[i] & 63);
+    }
+    for (u32 i = 0; i < button_count; i++) {
+        binding->buttons |= 1 << buttons[i];
+    }
+    binding->action = action;
+    binding->scale = scale;
+    return true;
+}
+
+b8 InputActionBindKey(u16 action, Keys key, f32 scale) {
+    return InputActionBind(action, &key, 1, 0, 0, scale);
+}
+
+void InputActionUnbindAll(u16 action) {
+    if (!actions_state_ptr) {
+        return;
+    }
+    u32 kept = 0;
+    for (u32 i = 0; i < actions_state_ptr->binding_count; i++) {
+        if (actions_state_ptr->bindings[i].action != action) {
+            actions_state_ptr->bindings[kept++] = actions_state_ptr->bindings[i];
+        }
+    }
+    actions_state_ptr->binding_count = kept;
+}
+
+b8 InputActionsLoadBindings(char* text) {
+    StringView remaining = StringViewFromCStr(text);
+    StringView line;
+    u32 line_number = 0;
+    while (StringSplitNextLine(&remaining, &line)) {
+        line_number++;
+        StringView name, chord, scale_text;
+        if (!StringSplitNextWhitespace(&line, &name)) {
+            continue;
+        }
+        char buffer[INPUT_ACTION_NAME_MAX];
+        StringViewCopy(name, buffer, sizeof(buffer));
+        u16 action = InputActionFind(buffer);
+        if (action == INPUT_ACTION_INVALID || !StringSplitNextWhitespace(&line, &chord)) {
+            DERROR("InputActionsLoadBindings - line %u: unknown action or missing keys.", line_number);
+            return false;
+        }
+
+        Keys keys[8];
+        Buttons buttons[BUTTON_MAX_BUTTONS];
+        u32 key_count = 0;
+        u32 button_count = 0;
+        while (chord.length) {
+            i64 plus = StringFindChar(chord, '+');
+            u64 part_length = plus < 0 ? chord.length : (u64)plus;
+            StringView part = StringViewSlice(chord, 0, part_length);
+            chord = StringViewSlice(chord, plus < 0 ? chord.length : part_length + 1, chord.length);
+            if (key_count < ArrayCount(keys) && KeyFromName(part, &keys[key_count])) {
+                key_count++;
+            } else if (button_count < ArrayCount(buttons) && ButtonFromName(part, &buttons[button_count])) {
+                button_count++;
+            } else {
+                DERROR("InputActionsLoadBindings - line %u: unknown key '%.*s'.", line_number, (i32)part.length, part.str);
+                return false;
+            }
+        }
+
+        f32 scale = 1.0f;
+        if (StringSplitNextWhitespace(&line, &scale_text)) {
+            StringViewCopy(scale_text, buffer, sizeof(buffer));
+            char* end = 0;
+            scale = strtof(buffer, &end);
+            if (end == buffer) {
+                DERROR("InputActionsLoadBindings - line %u: bad scale.", line_number);
+                return false;
+            }
+        }
+        if (!InputActionBind(action, keys, key_count, buttons, button_count, scale)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void InputActionsUpdate() {
+    if (!actions_state_ptr) {
+        return;
+    }
+    InputRawState raw;
+    InputGetRawState(&raw);
+
+    f32* values = actions_state_ptr->values;
+    DZeroMemory(values, sizeof(f32) * actions_state_ptr->action_count);
+    u64 held = 0;
+    InputBinding* bindings = actions_state_ptr->bindings;
+    for (u32 i = 0; i < actions_state_ptr->binding_count; i++) {
+        InputBinding* binding = &bindings[i];
+        //a chord counts when every bit it needs is set
+        u64 missing = (binding->keys[0] & ~raw.keys[0]) | (binding->keys[1] & ~raw.keys[1]) |
+                      (binding->keys[2] & ~raw.keys[2]) | (binding->keys[3] & ~raw.keys[3]) |
+                      (u64)(binding->buttons & ~raw.buttons);
+        if (!missing) {
+            values[binding->action] += binding->scale;
+            held |= 1ULL << binding->action;
+        }
+    }
+
+    u64 down = 0;
+    for (u16 i = 0; i < actions_state_ptr->action_count; i++) {
+        f32 value = values[i];
+        if ((actions_state_ptr->axis_mask >> i) & 1) {
+            value = value > 1.0f ? 1.0f : (value < -1.0f ? -1.0f : value);
+            down |= (u64)(value != 0.0f) << i;
+        } else {
+            value = (f32)((held >> i) & 1);
+            down |= held & (1ULL << i);
+        }
+        values[i] = value;
+    }
+    u64 pressed = down & ~actions_state_ptr->down_previous;
+    u64 released = ~down & actions_state_ptr->down_previous;
+    actions_state_ptr->down_previous = down;
+
+    for (u16 i = 0; i < actions_state_ptr->action_count; i++) {
+        InputActionState* state = &actions_state_ptr->states[i];
+        state->value = values[i];
+        state->down = (down >> i) & 1;
+        state->pressed = (pressed >> i) & 1;
+        state->released = (released >> i) & 1;
+    }
+}
+
+InputActionState* InputActionsGetStates() {
+    if (!actions_state_ptr) {
+        return 0;
+    }
+    return actions_state_ptr->states;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "defines.h"
+#include "core/input.h"
+
+/*
+Named actions evaluated once per frame from a flat table of bindings. A binding is a chord, a set of keys and
+mouse buttons that all have to be held, compiled to a bitmask, plus the value it adds to its action. Gameplay
+reads the precomputed action states and never asks about specific keys, so rebinding is only a data change.
+*/
+
+enum InputActionType{
+    //down while any binding is held
+    INPUT_ACTION_BUTTON,
+    //sum of the scales of the held bindings, clamped to [-1, 1]
+    INPUT_ACTION_AXIS
+};
+
+struct InputActionState{
+    f32 value;
+    b8 down;
+    //changed this frame
+    b8 pressed;
+    b8 released;
+};
+
+#define INPUT_MAX_ACTIONS 64
+#define INPUT_MAX_BINDINGS 256
+#define INPUT_ACTION_NAME_MAX 32
+#define INPUT_ACTION_INVALID 0xFFFF
+
+DAPI void InputActionsInitialize(u64* memory_requirement, void* state);
+DAPI void InputActionsShutdown(void* state);
+
+//Returns the action's id, or the existing id if the name is already registered
+DAPI u16 InputActionRegister(char* name, InputActionType type);
+DAPI u16 InputActionFind(char* name);
+
+//Binds a chord, every listed key and button has to be held for it to count
+DAPI b8 InputActionBind(u16 action, Keys* keys, u32 key_count, Buttons* buttons, u32 button_count, f32 scale);
+DAPI b8 InputActionBindKey(u16 action, Keys key, f32 scale);
+DAPI void InputActionUnbindAll(u16 action);
+
+/*
+Binds from text, one binding per line: action name, chord and an optional scale (default 1), e.g.
+    camera_yaw LEFT -1
+    save LCONTROL+S
+Keys use the KEY_ names without the prefix, mouse buttons are MOUSE_LEFT/MOUSE_RIGHT/MOUSE_MIDDLE.
+Actions must already be registered. Stops and returns false at the first line it can't use.
+*/
+DAPI b8 InputActionsLoadBindings(char* text);
+
+//Evaluates every binding against the current input state. The application calls this once per frame
+DAPI void InputActionsUpdate();
+
+//Indexed by action id, valid until shutdown, so it can be cached
+DAPI InputActionState* InputActionsGetStates();
@@ -0,0 +1,219 @@
+#include "core/input_recording.h"
+#include "core/input.h"
+#include "core/dmemory.h"
+#include "core/logger.h"
+#include "platform/filesystem.h"
+
+#define INPUT_RECORDING_HEADER_SIZE 8
+#define INPUT_RECORDING_FRAME_HEADER_SIZE 14
+#define INPUT_RECORDING_EVENT_SIZE 6
+
+struct InputRecordingState {
+    FileHandle file;
+    b8 recording;
+    //one frame's worth of records, written with a single FileSystemWrite
+    u8 frame_buffer[INPUT_RECORDING_FRAME_HEADER_SIZE + INPUT_EVENT_RING_CAPACITY * INPUT_RECORDING_EVENT_SIZE];
+
+    u8* playback_data;
+    u64 playback_size;
+    u64 playback_offset;
+    b8 playing;
+};
+
+static InputRecordingState* recording_state_ptr;
+
+DINLINE u8* WriteBytes(u8* dest, void* source, u64 size) {
+    DCopyMemory(dest, source, size);
+    return dest + size;
+}
+
+DINLINE u8* ReadBytes(u8* source, void* dest, u64 size) {
+    DCopyMemory(dest, source, size);
+    return source + size;
+}
+
+void InputRecordingInitialize(u64* memory_requirement, void* state) {
+    *memory_requirement = sizeof(InputRecordingState);
+    if (state == 0) {
+        return;
+    }
+    DZeroMemory(state, sizeof(InputRecordingState));
+    recording_state_ptr = (InputRecordingState*)state;
+}
+
+void InputRecordingShutdown(void* state) {
+    if (recording_state_ptr) {
+        InputRecordingStop();
+        InputPlaybackStop();
+    }
+    recording_state_ptr = 0;
+}
+
+b8 InputRecordingStart(char* path) {
+    if (!recording_state_ptr) {
+        return false;
+    }
+    if (recording_state_ptr->recording) {
+        InputRecordingStop();
+    }
+    if (!FileSystemOpen(path, FILE_MODE_WRITE, true, &recording_state_ptr->file)) {
+        DERROR("Input recording - unable to open '%s' for writing.", path);
+        return false;
+    }
+    u8 header[INPUT_RECORDING_HEADER_SIZE];
+    u32 magic = INPUT_RECORDING_MAGIC;
+    u16 version = INPUT_RECORDING_VERSION;
+    u16 reserved = 0;
+    u8* cursor = WriteBytes(header, &magic, sizeof(magic));
+    cursor = WriteBytes(cursor, &version, sizeof(version));
+    WriteBytes(cursor, &reserved, sizeof(reserved));
+    u64 written = 0;
+    FileSystemWrite(&recording_state_ptr->file, sizeof(header), header, &written);
+    recording_state_ptr->recording = true;
+    DINFO("Recording input to '%s'.", path);
+    return true;
+}
+
+void InputRecordingStop() {
+    if (recording_state_ptr && recording_state_ptr->recording) {
+        FileSystemClose(&recording_state_ptr->file);
+        recording_state_ptr->recording = false;
+    }
+}
+
+b8 InputRecordingIsActive() {
+    return recording_state_ptr && recording_state_ptr->recording;
+}
+
+void InputRecordFrame(u32 frame_number, f64 delta_time) {
+    if (!recording_state_ptr || !recording_state_ptr->recording) {
+        return;
+    }
+    u8* cursor = recording_state_ptr->frame_buffer + INPUT_RECORDING_FRAME_HEADER_SIZE;
+    u16 event_count = 0;
+    InputEventIterator iterator;
+    InputEvent event;
+    InputEventsBegin(&iterator);
+    while (InputEventsNext(&iterator, &event)) {
+        u8 code = event.type == INPUT_EVENT_MOUSE_WHEEL ? (u8)event.wheel_delta : (u8)event.code;
+        cursor = WriteBytes(cursor, &event.type, sizeof(u8));
+        cursor = WriteBytes(cursor, &code, sizeof(u8));
+        cursor = WriteBytes(cursor, &event.x, sizeof(i16));
+        cursor = WriteBytes(cursor, &event.y, sizeof(i16));
+        event_count++;
+    }
+
+    u8* header = recording_state_ptr->frame_buffer;
+    header = WriteBytes(header, &frame_number, sizeof(frame_number));
+    header = WriteBytes(header, &delta_time, sizeof(delta_time));
+    WriteBytes(header, &event_count, sizeof(event_count));
+
+    u64 size = cursor - recording_state_ptr->frame_buffer;
+    u64 written = 0;
+    if (!FileSystemWrite(&recording_state_ptr->file, size, recording_state_ptr->frame_buffer, &written) || written != size) {
+        DERROR("Input recording - write failed, recording stopped.");
+        InputRecordingStop();
+    }
+}
+
+b8 InputPlaybackStart(char* path) {
+    if (!recording_state_ptr) {
+        return false;
+    }
+    InputPlaybackStop();
+    FileHandle file;
+    if (!FileSystemOpen(path, FILE_MODE_READ, true, &file)) {
+        DERROR("Input playback - unable to open '%s'.", path);
+        return false;
+    }
+    u8* data = 0;
+    u64 size = 0;
+    b8 read = FileSystemReadAllBytes(&file, &data, &size);
+    FileSystemClose(&file);
+    if (!read) {
+        DERROR("Input playback - unable to read '%s'.", path);
+        return false;
+    }
+
+    u32 magic = 0;
+    u16 version = 0;
+    if (size >= INPUT_RECORDING_HEADER_SIZE) {
+        ReadBytes(ReadBytes(data, &magic, sizeof(magic)), &version, sizeof(version));
+    }
+    if (magic != INPUT_RECORDING_MAGIC || version != INPUT_RECORDING_VERSION) {
+        DERROR("Input playback - '%s' is not a version %u input recording.", path, INPUT_RECORDING_VERSION);
+        DFree(data, size, MEMORY_TAG_STRING);
+        return false;
+    }
+    recording_state_ptr->playback_data = data;
+    recording_state_ptr->playback_size = size;
+    recording_state_ptr->playback_offset = INPUT_RECORDING_HEADER_SIZE;
+    recording_state_ptr->playing = true;
+    DINFO("Playing back input from '%s'.", path);
+    return true;
+}
+
+void InputPlaybackStop() {
+    if (!recording_state_ptr) {
+        return;
+    }
+    if (recording_state_ptr->playback_data) {
+        DFree(recording_state_ptr->playback_data, recording_state_ptr->playback_size, MEMORY_TAG_STRING);
+    }
+    recording_state_ptr->playback_data = 0;
+    recording_state_ptr->playback_size = 0;
+    recording_state_ptr->playback_offset = 0;
+    recording_state_ptr->playing = false;
+}
+
+b8 InputPlaybackIsActive() {
+    return recording_state_ptr && recording_state_ptr->playing;
+}
+
+b8 InputPlaybackFrame(f64* out_delta_time) {
+    if (!recording_state_ptr || !recording_state_ptr->playing) {
+        return false;
+    }
+    u64 remaining = recording_state_ptr->playback_size - recording_state_ptr->playback_offset;
+    if (remaining < INPUT_RECORDING_FRAME_HEADER_SIZE) {
+        recording_state_ptr->playing = false;
+        return false;
+    }
+    u8* cursor = recording_state_ptr->playback_data + recording_state_ptr->playback_offset;
+    u32 frame_number = 0;
+    u16 event_count = 0;
+    cursor = ReadBytes(cursor, &frame_number, sizeof(frame_number));
+    cursor = ReadBytes(cursor, out_delta_time, sizeof(f64));
+    cursor = ReadBytes(cursor, &event_count, sizeof(event_count));
+    if (remaining - INPUT_RECORDING_FRAME_HEADER_SIZE < (u64)event_count * INPUT_RECORDING_EVENT_SIZE) {
+        DWARN("Input playback - frame %u is truncated, stopping.", frame_number);
+        recording_state_ptr->playing = false;
+        return false;
+    }
+
+    for (u16 i = 0; i < event_count; i++) {
+        u8 type = cursor[0];
+        u8 code = cursor[1];
+        i16 x, y;
+        ReadBytes(ReadBytes(cursor + 2, &x, sizeof(x)), &y, sizeof(y));
+        cursor += INPUT_RECORDING_EVENT_SIZE;
+        switch (type) {
+            case INPUT_EVENT_KEY_PRESSED:
+            case INPUT_EVENT_KEY_RELEASED:
+                InputProcessKey((Keys)code, type == INPUT_EVENT_KEY_PRESSED);
+                break;
+            case INPUT_EVENT_BUTTON_PRESSED:
+            case INPUT_EVENT_BUTTON_RELEASED:
+                InputProcessButton((Buttons)code, type == INPUT_EVENT_BUTTON_PRESSED);
+                break;
+            case INPUT_EVENT_MOUSE_MOVED:
+                InputProcessMouseMove(x, y);
+                break;
+            case INPUT_EVENT_MOUSE_WHEEL:
+                InputProcessMouseWheel((i8)code);
+                break;
+        }
+    }
+    recording_state_ptr->playback_offset = cursor - recording_state_ptr->playback_data;
+    return true;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "defines.h"
+
+/*
+Records the input of each frame, with its frame number and delta time, to a compact binary file, and plays
+it back into the input system in place of the platform's input. Replaying a session with its recorded deltas
+makes a run reproducible, which is what benchmark runs are compared on.
+
+File layout, little endian:
+    header: u32 magic 'DINP', u16 version, u16 reserved
+    frame:  u32 frame number, f64 delta seconds, u16 event count, then count events
+    event:  u8 type (InputEventType), u8 key/button or wheel delta, i16 x, i16 y
+*/
+
+#define INPUT_RECORDING_MAGIC 0x504E4944
+#define INPUT_RECORDING_VERSION 1
+
+DAPI void InputRecordingInitialize(u64* memory_requirement, void* state);
+//Stops any recording or playback still running
+DAPI void InputRecordingShutdown(void* state);
+
+DAPI b8 InputRecordingStart(char* path);
+DAPI void InputRecordingStop();
+DAPI b8 InputRecordingIsActive();
+
+//Writes the events the input system collected this frame. Call before InputUpdate clears the frame
+DAPI void InputRecordFrame(u32 frame_number, f64 delta_time);
+
+//Loads the whole file, playback then never touches the disk until it is done
+DAPI b8 InputPlaybackStart(char* path);
+DAPI void InputPlaybackStop();
+DAPI b8 InputPlaybackIsActive();
+
+/*
+Feeds the next recorded frame's events through the InputProcess functions, exactly as the platform layer
+would, and returns its recorded delta. Returns false once the recording is exhausted.
+*/
+DAPI b8 InputPlaybackFrame(f64* out_delta_time);
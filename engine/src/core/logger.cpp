@@ -55,16 +55,22 @@ void LogOutput(LogLevel level, char* message, ...) {
     const char* level_strings[6] = {"[FATAL]: ", "[ERROR]: ", "[WARN]: ", "[INFO]: ", "[DEBUG]: ", "[TRACE]: "};
     b8 is_error = level < LOG_LEVEL_WARN;
 
+    //level prefix, message and newline are all formatted straight into one buffer
     char out_message[32000];
-    DZeroMemory(out_message, sizeof(out_message));
+    StringBuilder builder;
+    StringBuilderCreateFromBuffer(out_message, sizeof(out_message), &builder);
+    StringBuilderAppend(&builder, (char*)level_strings[level]);
 
     //this va list type workaround is because MSFT headers override the Clang va_list type with char* sometimes
     __builtin_va_list arg_ptr;
     va_start(arg_ptr, message);
-    StringFormatV(out_message, message, arg_ptr);
+    StringBuilderAppendFormatV(&builder, message, arg_ptr);
     va_end(arg_ptr);
 
-    StringFormat(out_message, "%s%s\n", level_strings[level], out_message);
+    if (builder.truncated) {
+        builder.length--;
+    }
+    StringBuilderAppendChar(&builder, '\n');
 
     if(is_error){
         PlatformConsoleWriteError(out_message, level);
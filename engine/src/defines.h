@@ -42,6 +42,8 @@ typedef uint8_t b8;
     #ifndef _WIN64
         #error "64-bit is required on Windows!"alignas
     #endif
+#elif defined(__linux__) || defined(__gnu_linux__)
+    #define DPLATFORM_LINUX 1
 #endif
 
 #ifdef DEXPORT
@@ -2,11 +2,13 @@
 
 #include "core/application.h"
 #include "core/logger.h"
+#include "core/dstring.h"
 #include "game_types.h"
+#include <stdlib.h>
 
 extern b8 CreateGame(Game* outGame);
 
-int main(void){
+int main(int argc, char** argv){
 
 
     Game gameInst = {};
@@ -15,6 +17,29 @@ int main(void){
         return -1;
     }
 
+    //--record <file> / --playback <file> for reproducible benchmark runs
+    //--headless and --frames <count> to run the loop without a display or GPU, unpaced unless --fps is given
+    //--fps <rate> to override the game's frame rate target, 0 for unlimited
+    f32 frameRate = -1;
+    for(int i = 1; i < argc; i++){
+        if(StringsEqual(argv[i], "--headless")){
+            gameInst.appConfig.headless = true;
+        } else if(i + 1 < argc && StringsEqual(argv[i], "--record")){
+            gameInst.appConfig.inputRecordPath = argv[++i];
+        } else if(i + 1 < argc && StringsEqual(argv[i], "--playback")){
+            gameInst.appConfig.inputPlaybackPath = argv[++i];
+        } else if(i + 1 < argc && StringsEqual(argv[i], "--frames")){
+            gameInst.appConfig.maxFrames = (u32)atoi(argv[++i]);
+        } else if(i + 1 < argc && StringsEqual(argv[i], "--fps")){
+            frameRate = (f32)atof(argv[++i]);
+        }
+    }
+    if(frameRate >= 0){
+        gameInst.appConfig.targetFrameRate = frameRate;
+    } else if(gameInst.appConfig.headless){
+        gameInst.appConfig.targetFrameRate = 0;
+    }
+
     if(!gameInst.Render || !gameInst.Update || !gameInst.Initialize || !gameInst.OnResize){
         DFATAL("The game's function pointers must be assigned!");
     }
@@ -43,6 +43,22 @@ void* AllocatorAllocate(LinearAllocator* allocator, u64 size){
     return 0;
 }
 
+void* AllocatorAllocateAligned(LinearAllocator* allocator, u64 size, u64 alignment){
+    if(allocator && allocator->memory){
+        u64 address = (u64)allocator->memory + allocator->allocated;
+        u64 padding = ((address + alignment - 1) & ~(alignment - 1)) - address;
+        if(allocator->allocated + padding + size > allocator->totalSize){
+            u64 remaining = allocator->totalSize - allocator->allocated;
+            DERROR("Linear allocator allocate - Tried to allocate %lluB aligned to %llu, only %lluB remaining.", size, alignment, remaining);
+            return 0;
+        }
+        allocator->allocated += padding;
+        return AllocatorAllocate(allocator, size);
+    }
+    DERROR("Linear allocator allocate - provided allocator not initialized.");
+    return 0;
+}
+
 void AllocatorFreeAll(LinearAllocator* allocator){
     if(allocator && allocator->memory){
         allocator->allocated = 0;
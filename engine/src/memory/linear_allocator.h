@@ -12,4 +12,6 @@ struct LinearAllocator{
 DAPI void AllocatorCreate(u64 totalSize, void* memory, LinearAllocator* outAllocator);
 DAPI void AllocatorDestroy(LinearAllocator* allocator);
 DAPI void* AllocatorAllocate(LinearAllocator* allocator, u64 size);
+//Pads the allocation start so the returned address is a multiple of alignment (a power of 2)
+DAPI void* AllocatorAllocateAligned(LinearAllocator* allocator, u64 size, u64 alignment);
 DAPI void AllocatorFreeAll(LinearAllocator* allocator);
\ No newline at end of file
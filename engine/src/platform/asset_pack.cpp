@@ -0,0 +1,284 @@
+#include "platform/asset_pack.h"
+
+#include "core/compression.h"
+#include "core/dmemory.h"
+#include "core/dstring.h"
+#include "core/logger.h"
+#include "platform/threading.h"
+
+#define ASSET_PACK_MAX_NAME 512
+
+static u64 HashName(char* name, u64 length) {
+    //FNV-1a, names are short so anything fancier wouldn't pay for itself
+    u64 hash = 0xCBF29CE484222325ULL;
+    for (u64 i = 0; i < length; i++) {
+        hash ^= (u8)name[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+static u64 AlignOffset(u64 offset) {
+    return (offset + ASSET_PACK_ALIGNMENT - 1) & ~(u64)(ASSET_PACK_ALIGNMENT - 1);
+}
+
+void AssetPackNormalizeName(char* name) {
+    u64 start = 0;
+    while (name[start] == '.' && (name[start + 1] == '/' || name[start + 1] == '\\')) {
+        start += 2;
+    }
+    u64 length = 0;
+    for (char* c = name + start; *c; c++) {
+        name[length++] = *c == '\\' ? '/' : *c;
+    }
+    name[length] = 0;
+}
+
+static b8 SectionInBounds(u64 offset, u64 size, u64 file_size) {
+    return offset <= file_size && size <= file_size - offset;
+}
+
+b8 AssetPackOpen(char* path, AssetPack* out_pack) {
+    DZeroMemory(out_pack, sizeof(AssetPack));
+    if (!FileSystemMap(path, FILE_ACCESS_RANDOM, &out_pack->mapping)) {
+        return false;
+    }
+    u64 file_size = out_pack->mapping.size;
+    AssetPackHeader* header = (AssetPackHeader*)out_pack->mapping.data;
+    if (file_size < sizeof(AssetPackHeader) || header->magic != ASSET_PACK_MAGIC) {
+        DERROR("AssetPackOpen - '%s' is not an asset pack.", path);
+        AssetPackClose(out_pack);
+        return false;
+    }
+    if (header->version != ASSET_PACK_VERSION) {
+        DERROR("AssetPackOpen - '%s' is version %u, expected %u.", path, header->version, ASSET_PACK_VERSION);
+        AssetPackClose(out_pack);
+        return false;
+    }
+    b8 slots_valid = header->index_slot_count && (header->index_slot_count & (header->index_slot_count - 1)) == 0 &&
+                     header->index_slot_count > header->entry_count;
+    if (header->file_size != file_size || !slots_valid ||
+        !SectionInBounds(header->entries_offset, (u64)header->entry_count * sizeof(AssetPackEntry), file_size) ||
+        !SectionInBounds(header->index_offset, (u64)header->index_slot_count * sizeof(u32), file_size) ||
+        !SectionInBounds(header->names_offset, 0, file_size) || !SectionInBounds(header->data_offset, 0, file_size)) {
+        DERROR("AssetPackOpen - '%s' is truncated or corrupt.", path);
+        AssetPackClose(out_pack);
+        return false;
+    }
+    u8* base = (u8*)out_pack->mapping.data;
+    out_pack->header = header;
+    out_pack->entries = (AssetPackEntry*)(base + header->entries_offset);
+    out_pack->index = (u32*)(base + header->index_offset);
+    out_pack->names = (char*)(base + header->names_offset);
+    for (u32 i = 0; i < header->entry_count; i++) {
+        AssetPackEntry* entry = &out_pack->entries[i];
+        if (!SectionInBounds(header->names_offset + entry->name_offset, entry->name_length, file_size) ||
+            !SectionInBounds(entry->offset, entry->stored_size, file_size)) {
+            DERROR("AssetPackOpen - '%s' entry %u points outside the file.", path, i);
+            AssetPackClose(out_pack);
+            return false;
+        }
+        b8 stored_valid = entry->compression == ASSET_PACK_COMPRESSION_NONE ? entry->stored_size == entry->size
+                                                                            : entry->compression == ASSET_PACK_COMPRESSION_LZ;
+        if (!stored_valid) {
+            DERROR("AssetPackOpen - '%s' entry %u uses an unsupported compression %u.", path, i, entry->compression);
+            AssetPackClose(out_pack);
+            return false;
+        }
+    }
+    return true;
+}
+
+void AssetPackClose(AssetPack* pack) {
+    FileSystemUnmap(&pack->mapping);
+    DZeroMemory(pack, sizeof(AssetPack));
+}
+
+AssetPackEntry* AssetPackFind(AssetPack* pack, char* name) {
+    if (!pack->header) {
+        return 0;
+    }
+    char normalized[ASSET_PACK_MAX_NAME];
+    if (StringViewCopy(StringViewFromCStr(name), normalized, sizeof(normalized)) != StringLength(name)) {
+        return 0;
+    }
+    AssetPackNormalizeName(normalized);
+    u64 length = StringLength(normalized);
+    u64 hash = HashName(normalized, length);
+    u32 mask = pack->header->index_slot_count - 1;
+    //a written index always has an empty slot, the bound is for corrupt ones that don't
+    u32 slot = (u32)hash & mask;
+    for (u32 probes = 0; probes < pack->header->index_slot_count; probes++, slot = (slot + 1) & mask) {
+        u32 entry_index = pack->index[slot];
+        if (entry_index == 0 || entry_index > pack->header->entry_count) {
+            return 0;
+        }
+        AssetPackEntry* entry = &pack->entries[entry_index - 1];
+        if (entry->name_hash == hash && entry->name_length == length &&
+            StringViewsEqual(StringViewCreate(pack->names + entry->name_offset, entry->name_length), StringViewCreate(normalized, length))) {
+            return entry;
+        }
+    }
+    return 0;
+}
+
+void* AssetPackEntryData(AssetPack* pack, AssetPackEntry* entry) {
+    return (u8*)pack->mapping.data + entry->offset;
+}
+
+b8 AssetPackEntryRead(AssetPack* pack, AssetPackEntry* entry, void* destination, u64 capacity) {
+    if (capacity < entry->size) {
+        DERROR("AssetPackEntryRead - the entry is %llu bytes, destination only holds %llu.", entry->size, capacity);
+        return false;
+    }
+    void* stored = AssetPackEntryData(pack, entry);
+    if (entry->compression == ASSET_PACK_COMPRESSION_NONE) {
+        DCopyMemory(destination, stored, entry->size);
+        return true;
+    }
+    //asset loads are one at a time, spreading a single one over threads isn't worth starting them
+    return DecompressStream(stored, entry->stored_size, destination, entry->size, 1);
+}
+
+static b8 WritePadding(FileHandle* handle, u64* position, u64 target) {
+    static u8 zeros[ASSET_PACK_ALIGNMENT];
+    u64 written = 0;
+    if (target > *position && !FileSystemWrite(handle, target - *position, zeros, &written)) {
+        return false;
+    }
+    *position = target;
+    return true;
+}
+
+static b8 WriteSection(FileHandle* handle, u64* position, void* data, u64 size) {
+    u64 written = 0;
+    if (size && !FileSystemWrite(handle, size, data, &written)) {
+        return false;
+    }
+    *position += size;
+    return true;
+}
+
+b8 AssetPackWrite(char* path, AssetPackSource* sources, u32 source_count) {
+    u32 slot_count = 16;
+    //at most half full keeps probe runs short
+    while (slot_count < source_count * 2) {
+        slot_count *= 2;
+    }
+    u64 entries_size = sizeof(AssetPackEntry) * source_count;
+    u64 index_size = sizeof(u32) * slot_count;
+    AssetPackEntry* entries = (AssetPackEntry*)DAllocate(entries_size, MEMORY_TAG_ARRAY);
+    u32* index = (u32*)DAllocate(index_size, MEMORY_TAG_ARRAY);
+    char* names = (char*)DAllocate((u64)source_count * ASSET_PACK_MAX_NAME, MEMORY_TAG_STRING);
+    //what goes in the data section per source, the source itself or a compressed copy
+    void** stored_data = (void**)DAllocate(sizeof(void*) * source_count, MEMORY_TAG_ARRAY);
+    u64* stored_capacity = (u64*)DAllocate(sizeof(u64) * source_count, MEMORY_TAG_ARRAY);
+    u64 names_size = 0;
+    b8 result = true;
+    CpuTopology topology = {};
+    u32 thread_count = CpuGetTopology(&topology) ? topology.logical_cores : 1;
+
+    AssetPackHeader header = {};
+    header.magic = ASSET_PACK_MAGIC;
+    header.version = ASSET_PACK_VERSION;
+    header.entry_count = source_count;
+    header.index_slot_count = slot_count;
+    header.entries_offset = AlignOffset(sizeof(AssetPackHeader));
+    header.index_offset = AlignOffset(header.entries_offset + entries_size);
+    header.names_offset = AlignOffset(header.index_offset + index_size);
+
+    for (u32 i = 0; i < source_count && result; i++) {
+        if (sources[i].compression != ASSET_PACK_COMPRESSION_NONE && sources[i].compression != ASSET_PACK_COMPRESSION_LZ) {
+            DERROR("AssetPackWrite - '%s' asks for an unsupported compression %u.", sources[i].name, sources[i].compression);
+            result = false;
+            break;
+        }
+        char* name = names + names_size;
+        u64 length = StringViewCopy(StringViewFromCStr(sources[i].name), name, ASSET_PACK_MAX_NAME);
+        if (length != StringLength(sources[i].name)) {
+            DERROR("AssetPackWrite - name '%s' is longer than %u characters.", sources[i].name, ASSET_PACK_MAX_NAME - 1);
+            result = false;
+            break;
+        }
+        AssetPackNormalizeName(name);
+        length = StringLength(name);
+        AssetPackEntry* entry = &entries[i];
+        entry->name_hash = HashName(name, length);
+        entry->name_offset = (u32)names_size;
+        entry->name_length = (u16)length;
+        entry->size = sources[i].size;
+        entry->stored_size = sources[i].size;
+        entry->compression = ASSET_PACK_COMPRESSION_NONE;
+        stored_data[i] = sources[i].data;
+        names_size += length;
+        if (sources[i].compression == ASSET_PACK_COMPRESSION_LZ) {
+            u64 capacity = CompressStreamBound(sources[i].size);
+            void* compressed = DAllocate(capacity, MEMORY_TAG_ARRAY);
+            u64 compressed_size = CompressStream(sources[i].data, sources[i].size, compressed, capacity, thread_count);
+            if (compressed_size && compressed_size < sources[i].size) {
+                entry->stored_size = compressed_size;
+                entry->compression = ASSET_PACK_COMPRESSION_LZ;
+                stored_data[i] = compressed;
+                stored_capacity[i] = capacity;
+            } else {
+                DFree(compressed, capacity, MEMORY_TAG_ARRAY);
+            }
+        }
+
+        u32 mask = slot_count - 1;
+        u32 slot = (u32)entry->name_hash & mask;
+        while (index[slot]) {
+            AssetPackEntry* other = &entries[index[slot] - 1];
+            if (other->name_hash == entry->name_hash && other->name_length == length &&
+                StringViewsEqual(StringViewCreate(names + other->name_offset, length), StringViewCreate(name, length))) {
+                DERROR("AssetPackWrite - '%s' is in the pack twice.", name);
+                result = false;
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+        index[slot] = i + 1;
+    }
+
+    FileHandle handle = {};
+    if (result) {
+        header.data_offset = AlignOffset(header.names_offset + names_size);
+        u64 offset = header.data_offset;
+        for (u32 i = 0; i < source_count; i++) {
+            entries[i].offset = offset;
+            offset = AlignOffset(offset + entries[i].stored_size);
+        }
+        header.file_size = source_count ? entries[source_count - 1].offset + entries[source_count - 1].stored_size : header.data_offset;
+        result = FileSystemOpen(path, FILE_MODE_WRITE, true, &handle);
+    }
+    if (result) {
+        u64 position = 0;
+        result = WriteSection(&handle, &position, &header, sizeof(header)) &&
+                 WritePadding(&handle, &position, header.entries_offset) &&
+                 WriteSection(&handle, &position, entries, entries_size) &&
+                 WritePadding(&handle, &position, header.index_offset) &&
+                 WriteSection(&handle, &position, index, index_size) &&
+                 WritePadding(&handle, &position, header.names_offset) &&
+                 WriteSection(&handle, &position, names, names_size);
+        for (u32 i = 0; i < source_count && result; i++) {
+            result = WritePadding(&handle, &position, entries[i].offset) &&
+                     WriteSection(&handle, &position, stored_data[i], entries[i].stored_size);
+        }
+        FileSystemClose(&handle);
+        if (!result) {
+            DERROR("AssetPackWrite - writing '%s' failed.", path);
+        }
+    }
+
+    for (u32 i = 0; i < source_count; i++) {
+        if (stored_capacity[i]) {
+            DFree(stored_data[i], stored_capacity[i], MEMORY_TAG_ARRAY);
+        }
+    }
+    DFree(stored_data, sizeof(void*) * source_count, MEMORY_TAG_ARRAY);
+    DFree(stored_capacity, sizeof(u64) * source_count, MEMORY_TAG_ARRAY);
+    DFree(entries, entries_size, MEMORY_TAG_ARRAY);
+    DFree(index, index_size, MEMORY_TAG_ARRAY);
+    DFree(names, (u64)source_count * ASSET_PACK_MAX_NAME, MEMORY_TAG_STRING);
+    return result;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "defines.h"
+#include "platform/filesystem.h"
+
+/*
+Many assets in one file, so loading them costs one open and one mapping for the whole pack instead of an open
+per asset. Names are the paths the loose files would have ("assets/shaders/x.spv") with forward slashes, and
+are found through a hash index without touching the rest of the file.
+
+File layout, little endian, every section and entry data starting on an ASSET_PACK_ALIGNMENT boundary:
+    header:  AssetPackHeader
+    entries: entry_count AssetPackEntry
+    index:   index_slot_count u32, entry index + 1 or 0 for an empty slot. Open addressing, a name starts at
+             slot (FNV-1a 64 of the name) & (index_slot_count - 1) and probes forward
+    names:   the entries' names back to back, not null terminated
+    data:    each entry's stored bytes
+*/
+
+#define ASSET_PACK_MAGIC 0x4B415044
+#define ASSET_PACK_VERSION 1
+#define ASSET_PACK_ALIGNMENT 64
+
+enum AssetPackCompression {
+    ASSET_PACK_COMPRESSION_NONE = 0,
+    //stored as a core/compression.h stream. The writer falls back to NONE for entries it doesn't shrink
+    ASSET_PACK_COMPRESSION_LZ = 1
+};
+
+struct AssetPackHeader {
+    u32 magic;
+    u16 version;
+    u16 reserved;
+    u32 entry_count;
+    u32 index_slot_count;
+    u64 entries_offset;
+    u64 index_offset;
+    u64 names_offset;
+    u64 data_offset;
+    u64 file_size;
+};
+
+struct AssetPackEntry {
+    u64 name_hash;
+    u64 offset;
+    //bytes in the pack, and once decompressed
+    u64 stored_size;
+    u64 size;
+    u32 name_offset;
+    u16 name_length;
+    u8 compression;
+    u8 reserved;
+};
+
+//An open pack, the whole file mapped once
+struct AssetPack {
+    FileMapping mapping;
+    AssetPackHeader* header;
+    AssetPackEntry* entries;
+    u32* index;
+    char* names;
+};
+
+//Validates the header and section bounds, so lookups afterwards can trust the offsets
+DAPI b8 AssetPackOpen(char* path, AssetPack* out_pack);
+DAPI void AssetPackClose(AssetPack* pack);
+
+//0 when the name isn't in the pack
+DAPI AssetPackEntry* AssetPackFind(AssetPack* pack, char* name);
+//The entry's stored bytes, inside the pack's mapping
+DAPI void* AssetPackEntryData(AssetPack* pack, AssetPackEntry* entry);
+//Decompresses (or copies) the entry into destination, which needs entry->size bytes. A mapped staging buffer
+//works, there is no intermediate copy
+DAPI b8 AssetPackEntryRead(AssetPack* pack, AssetPackEntry* entry, void* destination, u64 capacity);
+
+struct AssetPackSource {
+    char* name;
+    void* data;
+    u64 size;
+    AssetPackCompression compression;
+};
+
+//Writes a pack holding the sources, compressing on every core. Fails on duplicate names
+DAPI b8 AssetPackWrite(char* path, AssetPackSource* sources, u32 source_count);
+
+//Backslashes to forward slashes and no leading "./", in place. Pack names and lookups both go through it
+DAPI void AssetPackNormalizeName(char* name);
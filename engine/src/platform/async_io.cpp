@@ -0,0 +1,344 @@
+#include "platform/async_io.h"
+
+#include "platform/platform.h"
+#include "platform/threading.h"
+#include "core/dmemory.h"
+#include "core/event.h"
+#include "core/logger.h"
+
+enum AsyncRequestStatus {
+    ASYNC_REQUEST_FREE,
+    ASYNC_REQUEST_IN_FLIGHT,
+    //finished, waiting in the ready list for AsyncIoPoll/AsyncIoWait
+    ASYNC_REQUEST_READY
+};
+
+struct AsyncRequest {
+    u64 handle;
+    u64 file_size;
+    u64 offset;
+    u64 size;
+    u64 bytes_read;
+    u8* destination;
+    void* user_data;
+    u32 id;
+    u16 event_code;
+    u8 status;
+    b8 success;
+};
+
+struct AsyncIoState {
+    AsyncIoBackendType backend;
+    void* queue;
+
+    AsyncRequest requests[ASYNC_IO_MAX_REQUESTS];
+    u32 free_slots[ASYNC_IO_MAX_REQUESTS];
+    u32 free_count;
+    u32 next_id;
+    u32 in_flight;
+
+    //finished reads without an event code, in completion order
+    u32 ready[ASYNC_IO_MAX_REQUESTS];
+    u32 ready_head;
+    u32 ready_count;
+
+    //worker thread backend: slots to read and slots read, both guarded by mutex
+    Thread workers[ASYNC_IO_WORKER_COUNT];
+    Mutex mutex;
+    Semaphore work_available;
+    Semaphore work_finished;
+    u32 work[ASYNC_IO_MAX_REQUESTS];
+    u32 work_head;
+    u32 work_count;
+    u32 finished[ASYNC_IO_MAX_REQUESTS];
+    u32 finished_count;
+    b8 stopping;
+};
+
+static AsyncIoState* async_state_ptr;
+
+static u32 AsyncIoWorker(void* params) {
+    AsyncIoState* state = (AsyncIoState*)params;
+    for (;;) {
+        SemaphoreWait(&state->work_available, PLATFORM_WAIT_INFINITE);
+        MutexLock(&state->mutex);
+        if (!state->work_count) {
+            b8 stopping = state->stopping;
+            MutexUnlock(&state->mutex);
+            if (stopping) {
+                return 0;
+            }
+            continue;
+        }
+        u32 slot = state->work[state->work_head];
+        state->work_head = (state->work_head + 1) % ASYNC_IO_MAX_REQUESTS;
+        state->work_count--;
+        MutexUnlock(&state->mutex);
+
+        //the slot belongs to this worker until it is handed back below
+        AsyncRequest* request = &state->requests[slot];
+        request->success = PlatformFileReadAt(request->handle, request->offset, request->size, request->destination, &request->bytes_read);
+
+        MutexLock(&state->mutex);
+        state->finished[state->finished_count++] = slot;
+        MutexUnlock(&state->mutex);
+        SemaphoreSignal(&state->work_finished, 1);
+    }
+}
+
+void AsyncIoInitialize(u64* memory_requirement, void* state, AsyncIoBackendType backend) {
+    *memory_requirement = sizeof(AsyncIoState);
+    if (state == 0) {
+        return;
+    }
+    DZeroMemory(state, sizeof(AsyncIoState));
+    async_state_ptr = (AsyncIoState*)state;
+    for (u32 i = 0; i < ASYNC_IO_MAX_REQUESTS; i++) {
+        //handed out from the back, so slot 0 goes first
+        async_state_ptr->free_slots[i] = ASYNC_IO_MAX_REQUESTS - 1 - i;
+    }
+    async_state_ptr->free_count = ASYNC_IO_MAX_REQUESTS;
+    async_state_ptr->next_id = 1;
+
+    if (backend != ASYNC_IO_BACKEND_THREADS && PlatformIoQueueCreate(ASYNC_IO_MAX_REQUESTS, &async_state_ptr->queue)) {
+        async_state_ptr->backend = ASYNC_IO_BACKEND_IO_URING;
+        DINFO("Async IO using io_uring.");
+        return;
+    }
+    if (backend == ASYNC_IO_BACKEND_IO_URING) {
+        DWARN("Async IO - io_uring was asked for but isn't available, using worker threads.");
+    }
+    async_state_ptr->backend = ASYNC_IO_BACKEND_THREADS;
+    MutexCreate(&async_state_ptr->mutex);
+    SemaphoreCreate(0, &async_state_ptr->work_available);
+    SemaphoreCreate(0, &async_state_ptr->work_finished);
+    for (u32 i = 0; i < ASYNC_IO_WORKER_COUNT; i++) {
+        ThreadCreate(AsyncIoWorker, async_state_ptr, false, &async_state_ptr->workers[i]);
+        ThreadSetName(&async_state_ptr->workers[i], "async io");
+    }
+    DINFO("Async IO using %u worker threads.", ASYNC_IO_WORKER_COUNT);
+}
+
+static void FreeRequest(u32 slot) {
+    async_state_ptr->requests[slot].status = ASYNC_REQUEST_FREE;
+    async_state_ptr->free_slots[async_state_ptr->free_count++] = slot;
+}
+
+//The read is over one way or another: post its event or line it up for polling
+static void FinishRequest(u32 slot) {
+    AsyncRequest* request = &async_state_ptr->requests[slot];
+    async_state_ptr->in_flight--;
+    if (!request->success) {
+        DWARN("Async read of %llu bytes at offset %llu failed.", request->size, request->offset);
+    }
+    if (request->event_code) {
+        EventContext context = {};
+        context.data.u64[0] = (u64)request->user_data;
+        context.data.u32[2] = request->success ? request->id : request->id | ASYNC_IO_EVENT_FAILED;
+        context.data.u32[3] = (u32)request->bytes_read;
+        EventPost(request->event_code, 0, context);
+        FreeRequest(slot);
+        return;
+    }
+    request->status = ASYNC_REQUEST_READY;
+    async_state_ptr->ready[(async_state_ptr->ready_head + async_state_ptr->ready_count) % ASYNC_IO_MAX_REQUESTS] = slot;
+    async_state_ptr->ready_count++;
+}
+
+//Picks up whatever the backend has finished, waiting up to timeout_ms for the first if nothing has
+static void CollectCompletions(u64 timeout_ms) {
+    if (!async_state_ptr->in_flight) {
+        return;
+    }
+    if (async_state_ptr->backend == ASYNC_IO_BACKEND_IO_URING) {
+        //reads queued since the last collect, short read remainders included, go to the kernel in one call
+        PlatformIoQueueSubmit(async_state_ptr->queue);
+        PlatformIoCompletion completions[32];
+        u32 count = PlatformIoQueueReap(async_state_ptr->queue, completions, ArrayCount(completions), timeout_ms);
+        for (u32 i = 0; i < count; i++) {
+            u32 slot = (u32)completions[i].user_data;
+            AsyncRequest* request = &async_state_ptr->requests[slot];
+            if (completions[i].result < 0) {
+                request->success = false;
+                FinishRequest(slot);
+                continue;
+            }
+            request->bytes_read += (u64)completions[i].result;
+            u64 position = request->offset + request->bytes_read;
+            //a short read before the end of the file just means the kernel stopped early, ask for the rest
+            if (completions[i].result > 0 && request->bytes_read < request->size && position < request->file_size) {
+                if (PlatformIoQueueSubmitRead(async_state_ptr->queue, request->handle, position,
+                                              (u32)(request->size - request->bytes_read),
+                                              request->destination + request->bytes_read, slot)) {
+                    continue;
+                }
+                request->success = false;
+                FinishRequest(slot);
+                continue;
+            }
+            request->success = true;
+            FinishRequest(slot);
+        }
+        return;
+    }
+
+    if (timeout_ms) {
+        //counts can run ahead of the finished list, an early wake just comes back with nothing
+        SemaphoreWait(&async_state_ptr->work_finished, timeout_ms);
+    }
+    u32 finished[ASYNC_IO_MAX_REQUESTS];
+    MutexLock(&async_state_ptr->mutex);
+    u32 count = async_state_ptr->finished_count;
+    DCopyMemory(finished, async_state_ptr->finished, sizeof(u32) * count);
+    async_state_ptr->finished_count = 0;
+    MutexUnlock(&async_state_ptr->mutex);
+    for (u32 i = 0; i < count; i++) {
+        FinishRequest(finished[i]);
+    }
+}
+
+void AsyncIoShutdown(void* state) {
+    if (!async_state_ptr) {
+        return;
+    }
+    while (async_state_ptr->in_flight) {
+        CollectCompletions(PLATFORM_WAIT_INFINITE);
+    }
+    if (async_state_ptr->backend == ASYNC_IO_BACKEND_IO_URING) {
+        PlatformIoQueueDestroy(async_state_ptr->queue);
+    } else {
+        MutexLock(&async_state_ptr->mutex);
+        async_state_ptr->stopping = true;
+        MutexUnlock(&async_state_ptr->mutex);
+        SemaphoreSignal(&async_state_ptr->work_available, ASYNC_IO_WORKER_COUNT);
+        for (u32 i = 0; i < ASYNC_IO_WORKER_COUNT; i++) {
+            ThreadJoin(&async_state_ptr->workers[i], 0);
+        }
+        MutexDestroy(&async_state_ptr->mutex);
+        SemaphoreDestroy(&async_state_ptr->work_available);
+        SemaphoreDestroy(&async_state_ptr->work_finished);
+    }
+    async_state_ptr = 0;
+}
+
+AsyncIoBackendType AsyncIoGetBackend() {
+    return async_state_ptr ? async_state_ptr->backend : ASYNC_IO_BACKEND_AUTO;
+}
+
+b8 AsyncFileOpen(char* path, AsyncFile* out_file) {
+    out_file->is_valid = PlatformFileOpenRead(path, &out_file->handle, &out_file->size);
+    return out_file->is_valid;
+}
+
+void AsyncFileClose(AsyncFile* file) {
+    if (file->is_valid) {
+        PlatformFileClose(file->handle);
+    }
+    file->handle = 0;
+    file->size = 0;
+    file->is_valid = false;
+}
+
+u32 AsyncIoSubmitRead(AsyncFile* file, u64 offset, u64 size, void* destination, void* user_data, u16 event_code) {
+    if (!async_state_ptr || !file->is_valid || size > 0xFFFFFFFF) {
+        return 0;
+    }
+    if (!async_state_ptr->free_count) {
+        return 0;
+    }
+    u32 slot = async_state_ptr->free_slots[--async_state_ptr->free_count];
+    AsyncRequest* request = &async_state_ptr->requests[slot];
+    request->handle = file->handle;
+    request->file_size = file->size;
+    request->offset = offset;
+    request->size = size;
+    request->bytes_read = 0;
+    request->destination = (u8*)destination;
+    request->user_data = user_data;
+    request->event_code = event_code;
+    request->success = false;
+    request->status = ASYNC_REQUEST_IN_FLIGHT;
+    request->id = async_state_ptr->next_id++;
+    //the top bit is the failure flag of posted events
+    if (async_state_ptr->next_id & ASYNC_IO_EVENT_FAILED) {
+        async_state_ptr->next_id = 1;
+    }
+
+    if (async_state_ptr->backend == ASYNC_IO_BACKEND_IO_URING) {
+        //only queued, so the slot can still go back when the queue is full
+        if (!PlatformIoQueueSubmitRead(async_state_ptr->queue, file->handle, offset, (u32)size, destination, slot)) {
+            FreeRequest(slot);
+            return 0;
+        }
+    } else {
+        MutexLock(&async_state_ptr->mutex);
+        async_state_ptr->work[(async_state_ptr->work_head + async_state_ptr->work_count) % ASYNC_IO_MAX_REQUESTS] = slot;
+        async_state_ptr->work_count++;
+        MutexUnlock(&async_state_ptr->mutex);
+        SemaphoreSignal(&async_state_ptr->work_available, 1);
+    }
+    async_state_ptr->in_flight++;
+    return request->id;
+}
+
+void AsyncIoUpdate() {
+    if (async_state_ptr) {
+        CollectCompletions(0);
+    }
+}
+
+static u32 TakeReady(AsyncIoCompletion* out_completions, u32 max_count) {
+    u32 count = 0;
+    while (async_state_ptr->ready_count && count < max_count) {
+        u32 slot = async_state_ptr->ready[async_state_ptr->ready_head];
+        async_state_ptr->ready_head = (async_state_ptr->ready_head + 1) % ASYNC_IO_MAX_REQUESTS;
+        async_state_ptr->ready_count--;
+        AsyncRequest* request = &async_state_ptr->requests[slot];
+        AsyncIoCompletion* completion = &out_completions[count++];
+        completion->id = request->id;
+        completion->success = request->success;
+        completion->bytes_read = request->bytes_read;
+        completion->destination = request->destination;
+        completion->user_data = request->user_data;
+        FreeRequest(slot);
+    }
+    return count;
+}
+
+u32 AsyncIoPoll(AsyncIoCompletion* out_completions, u32 max_count) {
+    if (!async_state_ptr) {
+        return 0;
+    }
+    CollectCompletions(0);
+    return TakeReady(out_completions, max_count);
+}
+
+u32 AsyncIoWait(AsyncIoCompletion* out_completions, u32 max_count, u64 timeout_ms) {
+    if (!async_state_ptr) {
+        return 0;
+    }
+    f64 deadline = timeout_ms == PLATFORM_WAIT_INFINITE ? 0 : PlatformGetAbsoluteTime() + timeout_ms / 1000.0;
+    for (;;) {
+        CollectCompletions(0);
+        if (async_state_ptr->ready_count) {
+            return TakeReady(out_completions, max_count);
+        }
+        if (!async_state_ptr->in_flight) {
+            //whatever was left only had events to post
+            return 0;
+        }
+        u64 wait_ms = PLATFORM_WAIT_INFINITE;
+        if (timeout_ms != PLATFORM_WAIT_INFINITE) {
+            f64 now = PlatformGetAbsoluteTime();
+            if (now >= deadline) {
+                return 0;
+            }
+            wait_ms = (u64)((deadline - now) * 1000.0) + 1;
+        }
+        CollectCompletions(wait_ms);
+    }
+}
+
+u32 AsyncIoPendingCount() {
+    return async_state_ptr ? async_state_ptr->in_flight + async_state_ptr->ready_count : 0;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "defines.h"
+
+/*
+Reads that run while the frame goes on: submit (file, offset, size, destination) and pick the result up later,
+either by polling or waiting for completions, or as an event posted when it finishes. On linux the reads go
+to the kernel through io_uring, batched: everything submitted since the last AsyncIoUpdate (or poll/wait) is
+handed over in one call there. Elsewhere (or where io_uring is unavailable) a few worker threads do blocking
+positional reads.
+Submitting, polling, waiting and AsyncIoUpdate are main thread only. The destination must stay valid and
+untouched until the read's completion has been seen.
+*/
+
+#define ASYNC_IO_MAX_REQUESTS 256
+#define ASYNC_IO_WORKER_COUNT 2
+
+enum AsyncIoBackendType {
+    //io_uring when the kernel allows it, worker threads otherwise
+    ASYNC_IO_BACKEND_AUTO,
+    ASYNC_IO_BACKEND_IO_URING,
+    ASYNC_IO_BACKEND_THREADS
+};
+
+//Opened for positional reads, so any number of reads can be in flight on one file
+struct AsyncFile {
+    u64 handle;
+    u64 size;
+    b8 is_valid;
+};
+
+struct AsyncIoCompletion {
+    u32 id;
+    b8 success;
+    //can be short of the requested size at the end of the file
+    u64 bytes_read;
+    void* destination;
+    void* user_data;
+};
+
+/*
+Layout of the EventContext posted for a read submitted with an event code:
+    data.u64[0] user_data, data.u32[2] request id with ASYNC_IO_EVENT_FAILED or'd in when the read failed,
+    data.u32[3] bytes read
+Request ids stay below ASYNC_IO_EVENT_FAILED so the flag never collides with one.
+*/
+#define ASYNC_IO_EVENT_FAILED 0x80000000
+
+DAPI void AsyncIoInitialize(u64* memory_requirement, void* state, AsyncIoBackendType backend);
+//Waits for reads still in flight before tearing down
+DAPI void AsyncIoShutdown(void* state);
+//The backend actually in use
+DAPI AsyncIoBackendType AsyncIoGetBackend();
+
+DAPI b8 AsyncFileOpen(char* path, AsyncFile* out_file);
+//Reads on the file must have completed
+DAPI void AsyncFileClose(AsyncFile* file);
+
+/*
+Queues a read of size bytes (under 4GiB) at offset into destination. With an event code the completion is
+posted as that event instead of being returned by AsyncIoPoll/AsyncIoWait. Returns the request id, or 0 when
+ASYNC_IO_MAX_REQUESTS reads are already outstanding.
+*/
+DAPI u32 AsyncIoSubmitRead(AsyncFile* file, u64 offset, u64 size, void* destination, void* user_data, u16 event_code);
+
+//Collects finished reads and posts the events of those that asked for one. The application calls it every frame
+DAPI void AsyncIoUpdate();
+
+//Copies out up to max_count finished reads that have no event code, without blocking. Returns how many
+DAPI u32 AsyncIoPoll(AsyncIoCompletion* out_completions, u32 max_count);
+
+//Like poll but blocks until at least one read has finished, up to timeout_ms. Returns 0 on timeout or when nothing is outstanding
+DAPI u32 AsyncIoWait(AsyncIoCompletion* out_completions, u32 max_count, u64 timeout_ms);
+
+//Reads submitted whose completion hasn't been handed out yet
+DAPI u32 AsyncIoPendingCount();
@@ -2,10 +2,12 @@
 
 #include "core/logger.h"
 #include "core/dmemory.h"
+#include "core/dstring.h"
+#include "platform/asset_pack.h"
 
 #include <stdio.h>
 #include <string.h>
-#include <sys\stat.h>
+#include <sys/stat.h>
 
 b8 FileSystemExists(char* path){
     struct stat buffer;
@@ -62,6 +64,84 @@ b8 FileSystemReadLine(FileHandle* handle, char** line_buf) {
     return false;
 }
 
+b8 FileSystemReadLineString(FileHandle* handle, LinearAllocator* allocator, DString* out_line) {
+    if (!handle->handle) {
+        return false;
+    }
+    DStringCreate("", allocator, out_line);
+    //small chunks so the common short line never touches more than this
+    char chunk[256];
+    while (fgets(chunk, sizeof(chunk), (FILE*)handle->handle) != 0) {
+        u64 length = strlen(chunk);
+        if (!DStringAppend(out_line, StringViewCreate(chunk, length))) {
+            return false;
+        }
+        if (length && chunk[length - 1] == '\n') {
+            return true;
+        }
+    }
+    return out_line->length > 0;
+}
+
+void FileLineReaderCreate(FileHandle* handle, char* buffer, u64 capacity, FileLineReader* out_reader) {
+    *out_reader = {};
+    out_reader->handle = handle;
+    out_reader->buffer = buffer;
+    out_reader->capacity = capacity;
+}
+
+void FileLineReaderCreateFromView(StringView data, FileLineReader* out_reader) {
+    *out_reader = {};
+    out_reader->remaining = data;
+    out_reader->eof = true;
+}
+
+b8 FileLineReaderNext(FileLineReader* reader, StringView* out_line) {
+    reader->partial = false;
+    if (!reader->handle) {
+        return StringSplitNextLine(&reader->remaining, out_line);
+    }
+    if (!reader->handle->handle || !reader->capacity) {
+        return false;
+    }
+    for (;;) {
+        StringView unread = StringViewCreate(reader->buffer + reader->start, reader->end - reader->start);
+        i64 newline = StringFindChar(StringViewSlice(unread, reader->scanned, unread.length), '\n');
+        if (newline >= 0 || (reader->eof && unread.length)) {
+            u64 length = newline >= 0 ? reader->scanned + (u64)newline : unread.length;
+            *out_line = StringViewCreate(unread.str, length);
+            if (out_line->length && out_line->str[out_line->length - 1] == '\r') {
+                out_line->length--;
+            }
+            reader->start += newline >= 0 ? length + 1 : length;
+            reader->scanned = 0;
+            return true;
+        }
+        if (reader->eof) {
+            return false;
+        }
+        reader->scanned = unread.length;
+        if (unread.length == reader->capacity) {
+            //no newline in a full buffer, hand it over as is and carry on with the rest of the line next call
+            *out_line = unread;
+            reader->start = reader->end = reader->scanned = 0;
+            reader->partial = true;
+            return true;
+        }
+        //keep the started line and fill in behind it
+        if (reader->start) {
+            memmove(reader->buffer, unread.str, unread.length);
+            reader->start = 0;
+            reader->end = unread.length;
+        }
+        u64 read = fread(reader->buffer + reader->end, 1, reader->capacity - reader->end, (FILE*)reader->handle->handle);
+        reader->end += read;
+        if (read == 0) {
+            reader->eof = true;
+        }
+    }
+}
+
 b8 FileSystemWriteLine(FileHandle* handle, char* text) {
     if (handle->handle) {
         i32 result = fputs(text, (FILE*)handle->handle);
@@ -112,4 +192,64 @@ b8 FileSystemWrite(FileHandle* handle, u64 data_size, void* data, u64* out_bytes
         return true;
     }
     return false;
-}
\ No newline at end of file
+}
+
+static AssetPack mounted_packs[FILESYSTEM_MAX_PACKS];
+static u32 mounted_pack_count;
+
+b8 FileSystemMountPack(char* path) {
+    if (mounted_pack_count == FILESYSTEM_MAX_PACKS) {
+        DERROR("FileSystemMountPack - already %u packs mounted, can't mount '%s'.", FILESYSTEM_MAX_PACKS, path);
+        return false;
+    }
+    if (!AssetPackOpen(path, &mounted_packs[mounted_pack_count])) {
+        return false;
+    }
+    DINFO("Mounted asset pack '%s', %u assets.", path, mounted_packs[mounted_pack_count].header->entry_count);
+    mounted_pack_count++;
+    return true;
+}
+
+void FileSystemUnmountPacks() {
+    for (u32 i = 0; i < mounted_pack_count; i++) {
+        AssetPackClose(&mounted_packs[i]);
+    }
+    mounted_pack_count = 0;
+}
+
+b8 FileSystemOpenAsset(char* path, FileAccessHint hint, AssetData* out_asset) {
+    DZeroMemory(out_asset, sizeof(AssetData));
+    for (u32 i = 0; i < mounted_pack_count; i++) {
+        AssetPackEntry* entry = AssetPackFind(&mounted_packs[i], path);
+        if (!entry) {
+            continue;
+        }
+        out_asset->size = entry->size;
+        if (entry->compression == ASSET_PACK_COMPRESSION_NONE) {
+            out_asset->data = AssetPackEntryData(&mounted_packs[i], entry);
+            return true;
+        }
+        out_asset->data = DAllocate(entry->size, MEMORY_TAG_ARRAY);
+        out_asset->decompressed = true;
+        if (!AssetPackEntryRead(&mounted_packs[i], entry, out_asset->data, entry->size)) {
+            DERROR("FileSystemOpenAsset - unable to decompress '%s'.", path);
+            FileSystemCloseAsset(out_asset);
+            return false;
+        }
+        return true;
+    }
+    if (!FileSystemMap(path, hint, &out_asset->mapping)) {
+        return false;
+    }
+    out_asset->data = out_asset->mapping.data;
+    out_asset->size = out_asset->mapping.size;
+    return true;
+}
+
+void FileSystemCloseAsset(AssetData* asset) {
+    if (asset->decompressed) {
+        DFree(asset->data, asset->size, MEMORY_TAG_ARRAY);
+    }
+    FileSystemUnmap(&asset->mapping);
+    DZeroMemory(asset, sizeof(AssetData));
+}
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "defines.h"
+#include "core/dstring.h"
+
+struct LinearAllocator;
 
 struct FileHandle{
     void* handle;
@@ -12,15 +15,61 @@ enum FileModes{
     FILE_MODE_WRITE = 0x2
 };
 
+//How a mapped file is going to be read, so the OS can read ahead or not bother
+enum FileAccessHint{
+    FILE_ACCESS_NORMAL,
+    //front to back once, read ahead aggressively and start paging it in right away
+    FILE_ACCESS_SEQUENTIAL,
+    //scattered lookups, read ahead would only pull in pages nobody touches
+    FILE_ACCESS_RANDOM
+};
+
+struct FileMapping{
+    //read only, writing through it faults. 0 for an empty file
+    void* data;
+    u64 size;
+};
+
 DAPI b8 FileSystemExists(char* path);
 
 DAPI b8 FileSystemOpen(char* path, FileModes mode, b8 binary, FileHandle* out_handle);
 
 DAPI b8 FileSystemClose(FileHandle* out_handle);
 
-//Reads up to a newline or EOF. Allocates *line_buf which must be free by caller
+//Reads up to a newline or EOF. Allocates *line_buf which must be free by caller. FileLineReader doesn't allocate
 DAPI b8 FileSystemReadLine(FileHandle* handle, char** line_buf);
 
+//Reads up to a newline or EOF into out_line (created by this call, destroy with DStringDestroy).
+//Short lines stay inline in the DString, longer ones come from allocator or the heap when it is 0
+DAPI b8 FileSystemReadLineString(FileHandle* handle, LinearAllocator* allocator, DString* out_line);
+
+/*
+Iterates the lines of a file or an in-memory view (a FileMapping, say) without allocating. File lines are read
+a block at a time into the buffer the caller gives it and returned as views into that buffer, valid until the
+next call. A line that runs past the end of a block is moved to the front and the block refilled, so it still
+comes back whole, unless it is longer than the whole buffer: then it comes back in buffer sized pieces with
+partial set on all but the last (which can be empty). Newlines are found with the SIMD StringFindChar. Lines drop the '\n' and a
+trailing '\r', like StringSplitNextLine.
+*/
+struct FileLineReader{
+    //0 when reading a view
+    FileHandle* handle;
+    char* buffer;
+    u64 capacity;
+    //unread bytes are buffer[start, end), the first scanned of them are known to hold no newline
+    u64 start;
+    u64 end;
+    u64 scanned;
+    StringView remaining;
+    b8 eof;
+    b8 partial;
+};
+
+DAPI void FileLineReaderCreate(FileHandle* handle, char* buffer, u64 capacity, FileLineReader* out_reader);
+DAPI void FileLineReaderCreateFromView(StringView data, FileLineReader* out_reader);
+//False once every line has been returned
+DAPI b8 FileLineReaderNext(FileLineReader* reader, StringView* out_line);
+
 //Writes to provided file appending '\n' at the end
 DAPI b8 FileSystemWriteLine(FileHandle* handle, char* text);
 
@@ -31,4 +80,36 @@ DAPI b8 FileSystemRead(FileHandle* handle, u64 data_size, void* out_data, u64* o
 //Allocates *out_bytes which must be freed by caller
 DAPI b8 FileSystemReadAllBytes(FileHandle* handle, u8** out_bytes, u64* out_bytes_read);
 
-DAPI b8 FileSystemWrite(FileHandle* handle, u64 data_size, void* data, u64* out_bytes_written);
\ No newline at end of file
+DAPI b8 FileSystemWrite(FileHandle* handle, u64 data_size, void* data, u64* out_bytes_written);
+
+/*
+Maps the whole file read only into memory. Pages are read in from the OS file cache the first time they are
+touched, nothing is copied onto the heap, so large assets cost no more than the file cache already holds. The
+data is page aligned. The view stays valid until FileSystemUnmap, the file doesn't need to stay open, but it
+shouldn't be truncated while mapped. Implemented by the platform layer.
+*/
+DAPI b8 FileSystemMap(char* path, FileAccessHint hint, FileMapping* out_mapping);
+DAPI void FileSystemUnmap(FileMapping* mapping);
+
+/*
+Asset loading. Mounted packs (see asset_pack.h) are searched first, in the order they were mounted, and a name
+not found in any of them is mapped from the loose file at that path instead. Either way the bytes are read only
+and stay valid until FileSystemCloseAsset.
+*/
+#define FILESYSTEM_MAX_PACKS 8
+
+struct AssetData{
+    void* data;
+    u64 size;
+    //set when the asset came from a loose file
+    FileMapping mapping;
+    //set when it was compressed in the pack, data is then a heap copy decompressed into
+    b8 decompressed;
+};
+
+DAPI b8 FileSystemMountPack(char* path);
+//Assets opened from the packs must be closed first
+DAPI void FileSystemUnmountPacks();
+
+DAPI b8 FileSystemOpenAsset(char* path, FileAccessHint hint, AssetData* out_asset);
+DAPI void FileSystemCloseAsset(AssetData* asset);
@@ -2,7 +2,8 @@
 
 #include "defines.h"
 
-b8 PlatformSystemStartup(u64* memoryRequirement, void* state, char* appName, i32 x, i32 y, i32 width, i32 height);
+//headless opens no window and pumps no messages, only the time/memory/console parts of the platform work
+b8 PlatformSystemStartup(u64* memoryRequirement, void* state, char* appName, i32 x, i32 y, i32 width, i32 height, b8 headless);
 
 void PlatformSystemShutdown(void* state);
 
@@ -19,4 +20,41 @@ void PlatformConsoleWriteError(char* message, u8 color);
 
 f64 PlatformGetAbsoluteTime();
 
-void PlatformSleep(u64 ms);
\ No newline at end of file
+//The OS monotonic counter PlatformGetAbsoluteTime is built on, unconverted, and its ticks per second
+u64 PlatformGetOsTicks();
+u64 PlatformGetOsTickFrequency();
+
+void PlatformSleep(u64 ms);
+
+/*
+Address based wait/wake (futex on linux, WaitOnAddress on windows) that the user space sync primitives in
+threading.cpp sleep on. Wait returns immediately if *address != expected, otherwise until a wake on the same
+address or timeout_ms (PLATFORM_WAIT_INFINITE for none). Returns false on timeout, wakeups can be spurious.
+*/
+b8 PlatformFutexWait(u32* address, u32 expected, u64 timeout_ms);
+void PlatformFutexWake(u32* address, u32 count);
+
+//Files opened for positional reads that async_io.cpp's workers share, handle is the fd or HANDLE
+b8 PlatformFileOpenRead(char* path, u64* out_handle, u64* out_size);
+void PlatformFileClose(u64 handle);
+//Blocking, reads until size bytes or the end of the file. Safe to call on one handle from several threads
+b8 PlatformFileReadAt(u64 handle, u64 offset, u64 size, void* destination, u64* out_bytes_read);
+
+struct PlatformIoCompletion{
+    u64 user_data;
+    //bytes read, or a negative OS error code
+    i64 result;
+};
+
+/*
+The kernel's own async read queue (io_uring on linux) for async_io.cpp, used from one thread only. Create
+returns false where there isn't one or it can't do plain reads. SubmitRead only queues the read, returning false
+when the queue is full, and Submit hands everything queued to the kernel in one call. A false Submit leaves the
+reads queued for the next Submit or Reap, so every queued read still completes through Reap. Reap copies out up
+to max_count completions, waiting up to timeout_ms for the first when none are ready.
+*/
+b8 PlatformIoQueueCreate(u32 entries, void** out_queue);
+void PlatformIoQueueDestroy(void* queue);
+b8 PlatformIoQueueSubmitRead(void* queue, u64 handle, u64 offset, u32 size, void* destination, u64 user_data);
+b8 PlatformIoQueueSubmit(void* queue);
+u32 PlatformIoQueueReap(void* queue, PlatformIoCompletion* out_completions, u32 max_count, u64 timeout_ms);
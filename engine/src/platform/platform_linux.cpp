@@ -0,0 +1,1034 @@
+#include "platform/platform.h"
+#include "platform/threading.h"
+#include "platform/filesystem.h"
+
+#if DPLATFORM_LINUX
+#include <core/logger.h>
+#include "core/input.h"
+#include "core/event.h"
+#include "core/datomic.h"
+#include "containers/darray.h"
+#include <xcb/xcb.h>
+#include <X11/keysym.h>
+#include <X11/XKBlib.h>
+#include <X11/Xlib.h>
+#include <X11/Xlib-xcb.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <linux/io_uring.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#define VK_USE_PLATFORM_XCB_KHR
+#include <vulkan/vulkan.h>
+#include "renderer/vulkan/vulkan_types.inl"
+
+struct PlatformState{
+    Display* display;
+    xcb_connection_t* connection;
+    xcb_window_t window;
+    xcb_screen_t* screen;
+    xcb_atom_t wm_protocols;
+    xcb_atom_t wm_delete_win;
+    VkSurfaceKHR surface;
+    b8 headless;
+};
+
+static PlatformState* platform_state_ptr;
+
+//Blocks this size and up get their own mapping so freeing them hands the pages straight back to the OS
+#define PLATFORM_MMAP_THRESHOLD KiloBytes(64)
+
+//Sits in front of every block so PlatformFree knows how it was allocated. 16 bytes keeps malloc's alignment
+struct PlatformAllocationHeader{
+    u64 mapped_size;
+    u64 padding;
+};
+
+Keys TranslateKeycode(u32 x_keycode);
+
+b8 PlatformSystemStartup(u64* memory_requirement, void* state, char* appName, i32 x, i32 y, i32 width, i32 height, b8 headless){
+    *memory_requirement = sizeof(PlatformState);
+    if (state == 0) {
+        return true;
+    }
+    platform_state_ptr = (PlatformState*)state;
+    platform_state_ptr->headless = headless;
+    if (headless) {
+        //no X server needed at all
+        return true;
+    }
+
+    platform_state_ptr->display = XOpenDisplay(0);
+    if (!platform_state_ptr->display) {
+        DFATAL("Failed to open the X display.");
+        return false;
+    }
+    //only sends the final release of a held key instead of a release/press pair per repeat, just for this client
+    XkbSetDetectableAutoRepeat(platform_state_ptr->display, True, 0);
+
+    platform_state_ptr->connection = XGetXCBConnection(platform_state_ptr->display);
+    if (xcb_connection_has_error(platform_state_ptr->connection)) {
+        DFATAL("Failed to connect to X server via XCB.");
+        return false;
+    }
+
+    const xcb_setup_t* setup = xcb_get_setup(platform_state_ptr->connection);
+    xcb_screen_iterator_t it = xcb_setup_roots_iterator(setup);
+    platform_state_ptr->screen = it.data;
+
+    //Create Window
+    platform_state_ptr->window = xcb_generate_id(platform_state_ptr->connection);
+    u32 event_mask = XCB_CW_BACK_PIXEL | XCB_CW_EVENT_MASK;
+    u32 event_values = XCB_EVENT_MASK_BUTTON_PRESS | XCB_EVENT_MASK_BUTTON_RELEASE |
+                       XCB_EVENT_MASK_KEY_PRESS | XCB_EVENT_MASK_KEY_RELEASE |
+                       XCB_EVENT_MASK_EXPOSURE | XCB_EVENT_MASK_POINTER_MOTION |
+                       XCB_EVENT_MASK_STRUCTURE_NOTIFY;
+    u32 value_list[] = {platform_state_ptr->screen->black_pixel, event_values};
+
+    xcb_create_window(
+        platform_state_ptr->connection, XCB_COPY_FROM_PARENT, platform_state_ptr->window,
+        platform_state_ptr->screen->root, x, y, width, height, 0,
+        XCB_WINDOW_CLASS_INPUT_OUTPUT, platform_state_ptr->screen->root_visual, event_mask, value_list);
+
+    xcb_change_property(
+        platform_state_ptr->connection, XCB_PROP_MODE_REPLACE, platform_state_ptr->window,
+        XCB_ATOM_WM_NAME, XCB_ATOM_STRING, 8, strlen(appName), appName);
+
+    //ask the window manager for a client message on close instead of having the connection killed
+    xcb_intern_atom_cookie_t wm_delete_cookie = xcb_intern_atom(
+        platform_state_ptr->connection, 0, strlen("WM_DELETE_WINDOW"), "WM_DELETE_WINDOW");
+    xcb_intern_atom_cookie_t wm_protocols_cookie = xcb_intern_atom(
+        platform_state_ptr->connection, 0, strlen("WM_PROTOCOLS"), "WM_PROTOCOLS");
+    xcb_intern_atom_reply_t* wm_delete_reply = xcb_intern_atom_reply(platform_state_ptr->connection, wm_delete_cookie, 0);
+    xcb_intern_atom_reply_t* wm_protocols_reply = xcb_intern_atom_reply(platform_state_ptr->connection, wm_protocols_cookie, 0);
+    platform_state_ptr->wm_delete_win = wm_delete_reply->atom;
+    platform_state_ptr->wm_protocols = wm_protocols_reply->atom;
+    xcb_change_property(
+        platform_state_ptr->connection, XCB_PROP_MODE_REPLACE, platform_state_ptr->window,
+        wm_protocols_reply->atom, 4, 32, 1, &wm_delete_reply->atom);
+    free(wm_delete_reply);
+    free(wm_protocols_reply);
+
+    xcb_map_window(platform_state_ptr->connection, platform_state_ptr->window);
+
+    i32 stream_result = xcb_flush(platform_state_ptr->connection);
+    if (stream_result <= 0) {
+        DFATAL("An error occurred when flushing the stream: %d", stream_result);
+        return false;
+    }
+    return true;
+}
+
+void PlatformSystemShutdown(void* state) {
+    if (platform_state_ptr && platform_state_ptr->display) {
+        xcb_destroy_window(platform_state_ptr->connection, platform_state_ptr->window);
+        //also closes the xcb connection, Xlib owns it
+        XCloseDisplay(platform_state_ptr->display);
+        platform_state_ptr->display = 0;
+        platform_state_ptr->connection = 0;
+    }
+}
+
+b8 PlatformPumpMessages() {
+    if (!platform_state_ptr || platform_state_ptr->headless) {
+        return true;
+    }
+    xcb_generic_event_t* event;
+    while ((event = xcb_poll_for_event(platform_state_ptr->connection))) {
+        //the high bit marks events sent with SendEvent (xdotool, some IMEs), which have to be treated as real ones
+        u8 event_type = event->response_type & ~0x80;
+        switch (event_type) {
+            case XCB_KEY_PRESS:
+            case XCB_KEY_RELEASE: {
+                xcb_key_press_event_t* kb_event = (xcb_key_press_event_t*)event;
+                b8 pressed = event_type == XCB_KEY_PRESS;
+                //unshifted symbol, bindings are by key rather than by character
+                KeySym key_sym = XkbKeycodeToKeysym(platform_state_ptr->display, (KeyCode)kb_event->detail, 0, 0);
+                Keys key = TranslateKeycode(key_sym);
+                if (key != KEYS_MAX_KEYS) {
+                    InputProcessKey(key, pressed);
+                }
+            } break;
+            case XCB_BUTTON_PRESS:
+            case XCB_BUTTON_RELEASE: {
+                xcb_button_press_event_t* mouse_event = (xcb_button_press_event_t*)event;
+                b8 pressed = event_type == XCB_BUTTON_PRESS;
+                Buttons mouse_button = BUTTON_MAX_BUTTONS;
+                switch (mouse_event->detail) {
+                    case XCB_BUTTON_INDEX_1:
+                        mouse_button = BUTTON_LEFT;
+                        break;
+                    case XCB_BUTTON_INDEX_2:
+                        mouse_button = BUTTON_MIDDLE;
+                        break;
+                    case XCB_BUTTON_INDEX_3:
+                        mouse_button = BUTTON_RIGHT;
+                        break;
+                    case XCB_BUTTON_INDEX_4:
+                    case XCB_BUTTON_INDEX_5:
+                        //X reports wheel steps as presses of buttons 4 (up) and 5 (down)
+                        if (pressed) {
+                            InputProcessMouseWheel(mouse_event->detail == XCB_BUTTON_INDEX_4 ? 1 : -1);
+                        }
+                        break;
+                }
+                if (mouse_button != BUTTON_MAX_BUTTONS) {
+                    InputProcessButton(mouse_button, pressed);
+                }
+            } break;
+            case XCB_MOTION_NOTIFY: {
+                xcb_motion_notify_event_t* move_event = (xcb_motion_notify_event_t*)event;
+                InputProcessMouseMove(move_event->event_x, move_event->event_y);
+            } break;
+            case XCB_CONFIGURE_NOTIFY: {
+                //also sent for moves, resizes are posted latest-wins so repeats of the same size are cheap
+                xcb_configure_notify_event_t* configure_event = (xcb_configure_notify_event_t*)event;
+                EventContext context = {};
+                context.data.u16[0] = configure_event->width;
+                context.data.u16[1] = configure_event->height;
+                EventPost(EVENT_CODE_RESIZED, 0, context);
+            } break;
+            case XCB_CLIENT_MESSAGE: {
+                xcb_client_message_event_t* client_message = (xcb_client_message_event_t*)event;
+                if (client_message->data.data32[0] == platform_state_ptr->wm_delete_win) {
+                    EventContext data = {};
+                    EventPost(EVENT_CODE_APPLICATION_QUIT, 0, data);
+                }
+            } break;
+            default:
+                break;
+        }
+        free(event);
+    }
+    return true;
+}
+
+void* PlatformAllocate(u64 size, b8 aligned) {
+    PlatformAllocationHeader* header;
+    u64 total_size = size + sizeof(PlatformAllocationHeader);
+    if (total_size >= PLATFORM_MMAP_THRESHOLD) {
+        void* mapping = mmap(0, total_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED) {
+            return 0;
+        }
+        header = (PlatformAllocationHeader*)mapping;
+        header->mapped_size = total_size;
+    } else {
+        header = (PlatformAllocationHeader*)malloc(total_size);
+        if (!header) {
+            return 0;
+        }
+        header->mapped_size = 0;
+    }
+    return header + 1;
+}
+
+void PlatformFree(void* block, b8 aligned) {
+    if (!block) {
+        return;
+    }
+    PlatformAllocationHeader* header = (PlatformAllocationHeader*)block - 1;
+    if (header->mapped_size) {
+        munmap(header, header->mapped_size);
+    } else {
+        free(header);
+    }
+}
+
+void* PlatformZeroMemory(void* block, u64 size) {
+    return memset(block, 0, size);
+}
+
+void* PlatformCopyMemory(void* dest, void* source, u64 size) {
+    return memcpy(dest, source, size);
+}
+
+void* PlatformSetMemory(void* dest, i32 value, u64 size) {
+    return memset(dest, value, size);
+}
+
+void PlatformConsoleWrite(char* message, u8 color) {
+    //fatal, error, warn, info, debug, trace
+    char* color_strings[] = {"0;41", "1;31", "1;33", "1;32", "1;34", "1;30"};
+    fprintf(stdout, "\033[%sm%s\033[0m", color_strings[color], message);
+}
+
+void PlatformConsoleWriteError(char* message, u8 color) {
+    //fatal, error, warn, info, debug, trace
+    char* color_strings[] = {"0;41", "1;31", "1;33", "1;32", "1;34", "1;30"};
+    fprintf(stderr, "\033[%sm%s\033[0m", color_strings[color], message);
+}
+
+b8 FileSystemMap(char* path, FileAccessHint hint, FileMapping* out_mapping) {
+    out_mapping->data = 0;
+    out_mapping->size = 0;
+    i32 file = open(path, O_RDONLY | O_CLOEXEC);
+    if (file < 0) {
+        DERROR("FileSystemMap - unable to open '%s': %s", path, strerror(errno));
+        return false;
+    }
+    struct stat info;
+    if (fstat(file, &info) != 0) {
+        DERROR("FileSystemMap - unable to stat '%s': %s", path, strerror(errno));
+        close(file);
+        return false;
+    }
+    if (info.st_size == 0) {
+        //mmap refuses zero lengths, an empty view is still a successful map
+        close(file);
+        return true;
+    }
+    void* data = mmap(0, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    //the mapping holds its own reference to the file
+    close(file);
+    if (data == MAP_FAILED) {
+        DERROR("FileSystemMap - mmap of '%s' failed: %s", path, strerror(errno));
+        return false;
+    }
+    if (hint == FILE_ACCESS_SEQUENTIAL) {
+        madvise(data, (size_t)info.st_size, MADV_SEQUENTIAL);
+        madvise(data, (size_t)info.st_size, MADV_WILLNEED);
+    } else if (hint == FILE_ACCESS_RANDOM) {
+        madvise(data, (size_t)info.st_size, MADV_RANDOM);
+    }
+    out_mapping->data = data;
+    out_mapping->size = (u64)info.st_size;
+    return true;
+}
+
+void FileSystemUnmap(FileMapping* mapping) {
+    if (mapping->data) {
+        munmap(mapping->data, (size_t)mapping->size);
+    }
+    mapping->data = 0;
+    mapping->size = 0;
+}
+
+f64 PlatformGetAbsoluteTime() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 0.000000001;
+}
+
+u64 PlatformGetOsTicks() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (u64)now.tv_sec * 1000000000ULL + (u64)now.tv_nsec;
+}
+
+u64 PlatformGetOsTickFrequency() {
+    return 1000000000ULL;
+}
+
+void PlatformSleep(u64 ms) {
+    struct timespec remaining;
+    remaining.tv_sec = ms / 1000;
+    remaining.tv_nsec = (ms % 1000) * 1000 * 1000;
+    //a signal cuts the sleep short, keep going with whatever time is left
+    while (nanosleep(&remaining, &remaining) == -1 && errno == EINTR) {
+    }
+}
+
+b8 PlatformFutexWait(u32* address, u32 expected, u64 timeout_ms) {
+    struct timespec timeout;
+    struct timespec* timeout_ptr = 0;
+    if (timeout_ms != PLATFORM_WAIT_INFINITE) {
+        //FUTEX_WAIT takes a relative timeout
+        timeout.tv_sec = timeout_ms / 1000;
+        timeout.tv_nsec = (timeout_ms % 1000) * 1000 * 1000;
+        timeout_ptr = &timeout;
+    }
+    //private, the words are never shared with another process
+    long result = syscall(SYS_futex, address, FUTEX_WAIT_PRIVATE, expected, timeout_ptr, 0, 0);
+    return !(result == -1 && errno == ETIMEDOUT);
+}
+
+void PlatformFutexWake(u32* address, u32 count) {
+    syscall(SYS_futex, address, FUTEX_WAKE_PRIVATE, count > INT32_MAX ? INT32_MAX : count, 0, 0, 0);
+}
+
+b8 PlatformFileOpenRead(char* path, u64* out_handle, u64* out_size) {
+    i32 file = open(path, O_RDONLY | O_CLOEXEC);
+    if (file < 0) {
+        DERROR("PlatformFileOpenRead - unable to open '%s': %s", path, strerror(errno));
+        return false;
+    }
+    struct stat info;
+    if (fstat(file, &info) != 0) {
+        DERROR("PlatformFileOpenRead - unable to stat '%s': %s", path, strerror(errno));
+        close(file);
+        return false;
+    }
+    *out_handle = (u64)file;
+    *out_size = (u64)info.st_size;
+    return true;
+}
+
+void PlatformFileClose(u64 handle) {
+    close((i32)handle);
+}
+
+b8 PlatformFileReadAt(u64 handle, u64 offset, u64 size, void* destination, u64* out_bytes_read) {
+    u64 total = 0;
+    while (total < size) {
+        ssize_t result = pread((i32)handle, (u8*)destination + total, (size_t)(size - total), (off_t)(offset + total));
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            *out_bytes_read = total;
+            return false;
+        }
+        if (result == 0) {
+            break;
+        }
+        total += (u64)result;
+    }
+    *out_bytes_read = total;
+    return true;
+}
+
+/*
+io_uring through the raw syscalls, glibc has no wrappers and liburing would be a dependency for three calls.
+The submission and completion rings are shared memory with the kernel: the side that produces into a ring
+owns its tail, the consumer its head, each published with a release store and read with an acquire load.
+*/
+struct LinuxIoQueue {
+    i32 ring_fd;
+    u32 features;
+    void* ring_memory;
+    u64 ring_size;
+    void* cq_memory;
+    u64 cq_size;
+    io_uring_sqe* sqes;
+    u64 sqes_size;
+
+    u32* sq_head;
+    u32* sq_tail;
+    u32 sq_mask;
+    u32* sq_array;
+    //entries written up to here, published to the kernel by PlatformIoQueueSubmit
+    u32 sq_local_tail;
+
+    u32* cq_head;
+    u32* cq_tail;
+    u32 cq_mask;
+    io_uring_cqe* cqes;
+};
+
+static i32 IoUringEnter(i32 ring_fd, u32 to_submit, u32 min_complete, u32 flags, void* arg, u64 arg_size) {
+    return (i32)syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, arg, arg_size);
+}
+
+static b8 IoUringSupportsRead(i32 ring_fd) {
+    u64 probe_size = sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+    io_uring_probe* probe = (io_uring_probe*)PlatformAllocate(probe_size, false);
+    PlatformZeroMemory(probe, probe_size);
+    b8 supported = false;
+    //probing itself is 5.6, the same kernel that added IORING_OP_READ
+    if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PROBE, probe, 256) == 0) {
+        supported = probe->last_op >= IORING_OP_READ && (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED);
+    }
+    PlatformFree(probe, false);
+    return supported;
+}
+
+void PlatformIoQueueDestroy(void* queue) {
+    LinuxIoQueue* ring = (LinuxIoQueue*)queue;
+    if (!ring) {
+        return;
+    }
+    if (ring->sqes) {
+        munmap(ring->sqes, ring->sqes_size);
+    }
+    if (ring->cq_memory && ring->cq_memory != ring->ring_memory) {
+        munmap(ring->cq_memory, ring->cq_size);
+    }
+    if (ring->ring_memory) {
+        munmap(ring->ring_memory, ring->ring_size);
+    }
+    if (ring->ring_fd >= 0) {
+        close(ring->ring_fd);
+    }
+    PlatformFree(ring, false);
+}
+
+b8 PlatformIoQueueCreate(u32 entries, void** out_queue) {
+    *out_queue = 0;
+    io_uring_params params;
+    PlatformZeroMemory(&params, sizeof(params));
+    i32 ring_fd = (i32)syscall(__NR_io_uring_setup, entries, &params);
+    if (ring_fd < 0) {
+        //old kernels, seccomp filters and kernel.io_uring_disabled all end up here
+        DINFO("io_uring unavailable (%s).", strerror(errno));
+        return false;
+    }
+    LinuxIoQueue* ring = (LinuxIoQueue*)PlatformAllocate(sizeof(LinuxIoQueue), false);
+    PlatformZeroMemory(ring, sizeof(LinuxIoQueue));
+    ring->ring_fd = ring_fd;
+    ring->features = params.features;
+    if (!IoUringSupportsRead(ring_fd)) {
+        DINFO("io_uring has no IORING_OP_READ on this kernel.");
+        PlatformIoQueueDestroy(ring);
+        return false;
+    }
+
+    u64 sq_size = params.sq_off.array + params.sq_entries * sizeof(u32);
+    u64 cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    b8 single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    ring->ring_size = single_mmap ? Maximum(sq_size, cq_size) : sq_size;
+    ring->ring_memory = mmap(0, ring->ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+    if (ring->ring_memory == MAP_FAILED) {
+        ring->ring_memory = 0;
+        PlatformIoQueueDestroy(ring);
+        return false;
+    }
+    ring->cq_size = cq_size;
+    ring->cq_memory = ring->ring_memory;
+    if (!single_mmap) {
+        ring->cq_memory = mmap(0, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+        if (ring->cq_memory == MAP_FAILED) {
+            ring->cq_memory = 0;
+            PlatformIoQueueDestroy(ring);
+            return false;
+        }
+    }
+    ring->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    ring->sqes = (io_uring_sqe*)mmap(0, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        ring->sqes = 0;
+        PlatformIoQueueDestroy(ring);
+        return false;
+    }
+
+    u8* sq = (u8*)ring->ring_memory;
+    ring->sq_head = (u32*)(sq + params.sq_off.head);
+    ring->sq_tail = (u32*)(sq + params.sq_off.tail);
+    ring->sq_mask = *(u32*)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (u32*)(sq + params.sq_off.array);
+    ring->sq_local_tail = *ring->sq_tail;
+    u8* cq = (u8*)ring->cq_memory;
+    ring->cq_head = (u32*)(cq + params.cq_off.head);
+    ring->cq_tail = (u32*)(cq + params.cq_off.tail);
+    ring->cq_mask = *(u32*)(cq + params.cq_off.ring_mask);
+    ring->cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+    *out_queue = ring;
+    return true;
+}
+
+b8 PlatformIoQueueSubmitRead(void* queue, u64 handle, u64 offset, u32 size, void* destination, u64 user_data) {
+    LinuxIoQueue* ring = (LinuxIoQueue*)queue;
+    u32 tail = ring->sq_local_tail;
+    if (tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) > ring->sq_mask) {
+        return false;
+    }
+    u32 index = tail & ring->sq_mask;
+    io_uring_sqe* sqe = &ring->sqes[index];
+    PlatformZeroMemory(sqe, sizeof(io_uring_sqe));
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = (i32)handle;
+    sqe->off = offset;
+    sqe->addr = (u64)destination;
+    sqe->len = size;
+    sqe->user_data = user_data;
+    ring->sq_array[index] = index;
+    ring->sq_local_tail = tail + 1;
+    return true;
+}
+
+b8 PlatformIoQueueSubmit(void* queue) {
+    LinuxIoQueue* ring = (LinuxIoQueue*)queue;
+    //once published the entries are the kernel's, a failed enter leaves them queued for the next one
+    __atomic_store_n(ring->sq_tail, ring->sq_local_tail, __ATOMIC_RELEASE);
+    u32 pending = ring->sq_local_tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    if (!pending) {
+        return true;
+    }
+    i32 submitted;
+    do {
+        submitted = IoUringEnter(ring->ring_fd, pending, 0, 0, 0, 0);
+    } while (submitted < 0 && errno == EINTR);
+    if (submitted < 0) {
+        DWARN("PlatformIoQueueSubmit - io_uring_enter failed, retrying on the next submit: %s", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+u32 PlatformIoQueueReap(void* queue, PlatformIoCompletion* out_completions, u32 max_count, u64 timeout_ms) {
+    LinuxIoQueue* ring = (LinuxIoQueue*)queue;
+    u32 head = *ring->cq_head;
+    if (head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE) && timeout_ms && max_count) {
+        //anything still unsubmitted goes in with the wait, or it could wait on reads the kernel never got
+        u32 pending = *ring->sq_tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+        if (timeout_ms == PLATFORM_WAIT_INFINITE) {
+            IoUringEnter(ring->ring_fd, pending, 1, IORING_ENTER_GETEVENTS, 0, 0);
+        } else if (ring->features & IORING_FEAT_EXT_ARG) {
+            __kernel_timespec timeout;
+            timeout.tv_sec = (i64)(timeout_ms / 1000);
+            timeout.tv_nsec = (i64)(timeout_ms % 1000) * 1000000;
+            io_uring_getevents_arg arg;
+            PlatformZeroMemory(&arg, sizeof(arg));
+            arg.ts = (u64)&timeout;
+            IoUringEnter(ring->ring_fd, pending, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+        } else {
+            //before 5.11 a timed wait needs a timeout request of its own, a short nap does the job here
+            PlatformSleep(Minimum(timeout_ms, (u64)1));
+        }
+    }
+    u32 tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    u32 count = 0;
+    while (head != tail && count < max_count) {
+        io_uring_cqe* cqe = &ring->cqes[head & ring->cq_mask];
+        out_completions[count].user_data = cqe->user_data;
+        out_completions[count].result = cqe->res;
+        count++;
+        head++;
+    }
+    __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+    return count;
+}
+
+//pthreads start functions return void*, so the engine's start function and params ride along in this. It lives
+//on the creating thread's stack, which waits until the new thread has copied it and reported its id. A raw futex
+//rather than a Semaphore since signaling one still reads it after the waiter may have returned
+struct LinuxThreadStart {
+    PfnThreadStart start;
+    void* params;
+    u64 thread_id;
+    u32 started;
+};
+
+static void* LinuxThreadEntry(void* params) {
+    LinuxThreadStart* info = (LinuxThreadStart*)params;
+    PfnThreadStart start = info->start;
+    void* start_params = info->params;
+    info->thread_id = ThreadGetCurrentId();
+    AtomicStoreU32(&info->started, 1);
+    //waking only uses the address, info may already be gone
+    PlatformFutexWake(&info->started, 1);
+    return (void*)(u64)start(start_params);
+}
+
+b8 ThreadCreate(PfnThreadStart start, void* params, b8 auto_detach, Thread* out_thread) {
+    out_thread->handle = 0;
+    out_thread->thread_id = 0;
+    if (!start) {
+        return false;
+    }
+    LinuxThreadStart info = {};
+    info.start = start;
+    info.params = params;
+    pthread_t handle;
+    i32 result = pthread_create(&handle, 0, LinuxThreadEntry, &info);
+    if (result != 0) {
+        DERROR("ThreadCreate - pthread_create failed with %i.", result);
+        return false;
+    }
+    while (!AtomicLoadU32(&info.started)) {
+        PlatformFutexWait(&info.started, 0, PLATFORM_WAIT_INFINITE);
+    }
+    if (auto_detach) {
+        pthread_detach(handle);
+    } else {
+        out_thread->handle = (u64)handle;
+        out_thread->thread_id = info.thread_id;
+    }
+    return true;
+}
+
+b8 ThreadJoin(Thread* thread, u32* out_exit_code) {
+    if (!thread->handle) {
+        return false;
+    }
+    void* exit_code = 0;
+    i32 result = pthread_join((pthread_t)thread->handle, &exit_code);
+    thread->handle = 0;
+    if (out_exit_code) {
+        *out_exit_code = (u32)(u64)exit_code;
+    }
+    return result == 0;
+}
+
+void ThreadDetach(Thread* thread) {
+    if (thread->handle) {
+        pthread_detach((pthread_t)thread->handle);
+        thread->handle = 0;
+    }
+}
+
+b8 ThreadSetName(Thread* thread, char* name) {
+    if (thread && !thread->handle) {
+        DWARN("ThreadSetName - thread has no handle, auto detached threads have to name themselves.");
+        return false;
+    }
+    //the kernel limit is 16 bytes including the terminator, longer names fail outright so cut them here
+    char short_name[16];
+    u32 length = 0;
+    while (name[length] && length < sizeof(short_name) - 1) {
+        short_name[length] = name[length];
+        length++;
+    }
+    short_name[length] = 0;
+    return pthread_setname_np(thread ? (pthread_t)thread->handle : pthread_self(), short_name) == 0;
+}
+
+u64 ThreadGetCurrentId() {
+    return (u64)syscall(SYS_gettid);
+}
+
+void ThreadYield() {
+    sched_yield();
+}
+
+//Reads a small sysfs file into buffer (null terminated), returns the length read or 0
+static u32 LinuxReadSysFile(char* path, char* buffer, u32 capacity) {
+    i32 file = open(path, O_RDONLY);
+    if (file < 0) {
+        return 0;
+    }
+    ssize_t length = read(file, buffer, capacity - 1);
+    close(file);
+    if (length <= 0) {
+        return 0;
+    }
+    buffer[length] = 0;
+    return (u32)length;
+}
+
+//sysfs cpu lists look like "0-3,8,10-11"
+static void LinuxParseCpuList(char* text, CpuSet* out_set) {
+    CpuSetClear(out_set);
+    char* cursor = text;
+    while (*cursor >= '0' && *cursor <= '9') {
+        u32 first = (u32)strtoul(cursor, &cursor, 10);
+        u32 last = first;
+        if (*cursor == '-') {
+            last = (u32)strtoul(cursor + 1, &cursor, 10);
+        }
+        for (u32 cpu = first; cpu <= last && cpu < PLATFORM_MAX_CPUS; cpu++) {
+            CpuSetAdd(out_set, cpu);
+        }
+        if (*cursor == ',') {
+            cursor++;
+        }
+    }
+}
+
+b8 CpuGetTopology(CpuTopology* out_topology) {
+    PlatformZeroMemory(out_topology, sizeof(CpuTopology));
+    char path[128];
+    char buffer[256];
+
+    if (LinuxReadSysFile("/sys/devices/system/cpu/online", buffer, sizeof(buffer))) {
+        LinuxParseCpuList(buffer, &out_topology->online);
+    } else {
+        //no sysfs (some containers), assume every configured cpu is a core of its own on one node
+        i64 count = sysconf(_SC_NPROCESSORS_ONLN);
+        for (i64 cpu = 0; cpu < count && cpu < PLATFORM_MAX_CPUS; cpu++) {
+            CpuSetAdd(&out_topology->online, (u32)cpu);
+        }
+    }
+
+    u32 first_cpu = PLATFORM_MAX_CPUS;
+    for (u32 cpu = 0; cpu < PLATFORM_MAX_CPUS; cpu++) {
+        if (!CpuSetContains(&out_topology->online, cpu)) {
+            continue;
+        }
+        if (first_cpu == PLATFORM_MAX_CPUS) {
+            first_cpu = cpu;
+        }
+        out_topology->logical_cores++;
+        //smt siblings share a core, the lowest numbered online one stands for it. An offline sibling can still be
+        //listed and would never get a core index of its own
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/core_cpus_list", cpu);
+        u32 length = LinuxReadSysFile(path, buffer, sizeof(buffer));
+        if (!length) {
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/thread_siblings_list", cpu);
+            length = LinuxReadSysFile(path, buffer, sizeof(buffer));
+        }
+        u32 leader = cpu;
+        if (length) {
+            CpuSet siblings;
+            LinuxParseCpuList(buffer, &siblings);
+            for (u32 sibling = 0; sibling < cpu; sibling++) {
+                if (CpuSetContains(&siblings, sibling) && CpuSetContains(&out_topology->online, sibling)) {
+                    leader = sibling;
+                    break;
+                }
+            }
+        }
+        if (leader == cpu) {
+            out_topology->core_index[cpu] = (u16)out_topology->physical_cores++;
+        } else {
+            out_topology->core_index[cpu] = out_topology->core_index[leader];
+        }
+    }
+    if (!out_topology->logical_cores) {
+        return false;
+    }
+
+    for (u32 index = 0; index < 8; index++) {
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cache/index%u/level", first_cpu, index);
+        if (!LinuxReadSysFile(path, buffer, sizeof(buffer))) {
+            break;
+        }
+        u32 level = (u32)strtoul(buffer, 0, 10);
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cache/index%u/type", first_cpu, index);
+        LinuxReadSysFile(path, buffer, sizeof(buffer));
+        b8 instruction_only = strncmp(buffer, "Instruction", 11) == 0;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cache/index%u/size", first_cpu, index);
+        if (instruction_only || !LinuxReadSysFile(path, buffer, sizeof(buffer))) {
+            continue;
+        }
+        char* suffix;
+        u64 size = strtoull(buffer, &suffix, 10);
+        if (*suffix == 'K') {
+            size *= KiloBytes(1);
+        } else if (*suffix == 'M') {
+            size *= MegaBytes(1);
+        }
+        if (level == 1) {
+            out_topology->l1_data_cache_size = size;
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cache/index%u/coherency_line_size", first_cpu, index);
+            if (LinuxReadSysFile(path, buffer, sizeof(buffer))) {
+                out_topology->cache_line_size = (u32)strtoul(buffer, 0, 10);
+            }
+        } else if (level == 2) {
+            out_topology->l2_cache_size = size;
+        } else if (level == 3) {
+            out_topology->l3_cache_size = size;
+        }
+    }
+    if (!out_topology->cache_line_size) {
+        out_topology->cache_line_size = 64;
+    }
+
+    CpuSet nodes;
+    if (LinuxReadSysFile("/sys/devices/system/node/online", buffer, sizeof(buffer))) {
+        LinuxParseCpuList(buffer, &nodes);
+        for (u32 node = 0; node < PLATFORM_MAX_CPUS; node++) {
+            if (!CpuSetContains(&nodes, node)) {
+                continue;
+            }
+            out_topology->numa_nodes++;
+            snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", node);
+            if (LinuxReadSysFile(path, buffer, sizeof(buffer))) {
+                CpuSet node_cpus;
+                LinuxParseCpuList(buffer, &node_cpus);
+                for (u32 cpu = 0; cpu < PLATFORM_MAX_CPUS; cpu++) {
+                    if (CpuSetContains(&node_cpus, cpu)) {
+                        out_topology->numa_node[cpu] = (u16)node;
+                    }
+                }
+            }
+        }
+    }
+    if (!out_topology->numa_nodes) {
+        out_topology->numa_nodes = 1;
+    }
+    return true;
+}
+
+b8 ThreadSetAffinity(Thread* thread, CpuSet* cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (u32 cpu = 0; cpu < PLATFORM_MAX_CPUS && cpu < CPU_SETSIZE; cpu++) {
+        if (CpuSetContains(cpus, cpu)) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    //by kernel thread id, 0 is the calling thread
+    if (sched_setaffinity(thread ? (pid_t)thread->thread_id : 0, sizeof(set), &set) != 0) {
+        DWARN("ThreadSetAffinity failed: %s", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+b8 ThreadSetPriority(Thread* thread, ThreadPriority priority) {
+    //normal threads have no priority of their own on linux, the nice value is per thread though
+    i32 nice_values[] = {10, 0, -5, -10};
+    if (setpriority(PRIO_PROCESS, thread ? (id_t)thread->thread_id : 0, nice_values[priority]) != 0) {
+        //raising above normal needs CAP_SYS_NICE or a matching RLIMIT_NICE
+        DWARN("ThreadSetPriority failed: %s", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+STATIC_ASSERT(sizeof(pthread_mutex_t) <= sizeof(Mutex::internal_data), "Mutex storage too small for pthread_mutex_t");
+STATIC_ASSERT(sizeof(pthread_cond_t) <= sizeof(ConditionVariable::internal_data), "ConditionVariable storage too small for pthread_cond_t");
+
+b8 MutexCreate(Mutex* out_mutex) {
+    i32 result = pthread_mutex_init((pthread_mutex_t*)out_mutex->internal_data, 0);
+    if (result != 0) {
+        DERROR("MutexCreate - pthread_mutex_init failed with %i.", result);
+        return false;
+    }
+    return true;
+}
+
+void MutexDestroy(Mutex* mutex) {
+    pthread_mutex_destroy((pthread_mutex_t*)mutex->internal_data);
+}
+
+void MutexLock(Mutex* mutex) {
+    pthread_mutex_lock((pthread_mutex_t*)mutex->internal_data);
+}
+
+b8 MutexTryLock(Mutex* mutex) {
+    return pthread_mutex_trylock((pthread_mutex_t*)mutex->internal_data) == 0;
+}
+
+void MutexUnlock(Mutex* mutex) {
+    pthread_mutex_unlock((pthread_mutex_t*)mutex->internal_data);
+}
+
+b8 ConditionVariableCreate(ConditionVariable* out_condition) {
+    pthread_condattr_t attributes;
+    pthread_condattr_init(&attributes);
+    //timeouts against the same clock as PlatformGetAbsoluteTime, unaffected by wall clock changes
+    pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+    i32 result = pthread_cond_init((pthread_cond_t*)out_condition->internal_data, &attributes);
+    pthread_condattr_destroy(&attributes);
+    if (result != 0) {
+        DERROR("ConditionVariableCreate - pthread_cond_init failed with %i.", result);
+        return false;
+    }
+    return true;
+}
+
+void ConditionVariableDestroy(ConditionVariable* condition) {
+    pthread_cond_destroy((pthread_cond_t*)condition->internal_data);
+}
+
+b8 ConditionVariableWait(ConditionVariable* condition, Mutex* mutex, u64 timeout_ms) {
+    pthread_cond_t* cond = (pthread_cond_t*)condition->internal_data;
+    pthread_mutex_t* lock = (pthread_mutex_t*)mutex->internal_data;
+    if (timeout_ms == PLATFORM_WAIT_INFINITE) {
+        return pthread_cond_wait(cond, lock) == 0;
+    }
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (timeout_ms % 1000) * 1000 * 1000;
+    if (deadline.tv_nsec >= 1000 * 1000 * 1000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000 * 1000 * 1000;
+    }
+    return pthread_cond_timedwait(cond, lock, &deadline) == 0;
+}
+
+void ConditionVariableSignal(ConditionVariable* condition) {
+    pthread_cond_signal((pthread_cond_t*)condition->internal_data);
+}
+
+void ConditionVariableBroadcast(ConditionVariable* condition) {
+    pthread_cond_broadcast((pthread_cond_t*)condition->internal_data);
+}
+
+void PlatformGetRequiredExtensionNames(char*** names_darray) {
+    DarrayPush(*names_darray, (char*)"VK_KHR_xcb_surface");
+}
+
+b8 PlatformCreateVulkanSurface(VulkanContext* context) {
+    if (!platform_state_ptr || platform_state_ptr->headless) {
+        DFATAL("Vulkan surface needs a window, use the null renderer when headless.");
+        return false;
+    }
+    VkXcbSurfaceCreateInfoKHR create_info = {VK_STRUCTURE_TYPE_XCB_SURFACE_CREATE_INFO_KHR};
+    create_info.connection = platform_state_ptr->connection;
+    create_info.window = platform_state_ptr->window;
+
+    VkResult result = vkCreateXcbSurfaceKHR(context->instance, &create_info, context->allocator, &platform_state_ptr->surface);
+    if (result != VK_SUCCESS) {
+        DFATAL("Vulkan surface creation failed.");
+        return false;
+    }
+
+    context->surface = platform_state_ptr->surface;
+    return true;
+}
+
+//Maps an X key symbol onto the engine's (windows virtual key based) codes, KEYS_MAX_KEYS when there is no match
+Keys TranslateKeycode(u32 x_keycode) {
+    if (x_keycode >= XK_a && x_keycode <= XK_z) {
+        return (Keys)(KEY_A + (x_keycode - XK_a));
+    }
+    if (x_keycode >= XK_A && x_keycode <= XK_Z) {
+        return (Keys)(KEY_A + (x_keycode - XK_A));
+    }
+    if (x_keycode >= XK_0 && x_keycode <= XK_9) {
+        return (Keys)('0' + (x_keycode - XK_0));
+    }
+    if (x_keycode >= XK_F1 && x_keycode <= XK_F24) {
+        return (Keys)(KEY_F1 + (x_keycode - XK_F1));
+    }
+    if (x_keycode >= XK_KP_0 && x_keycode <= XK_KP_9) {
+        return (Keys)(KEY_NUMPAD0 + (x_keycode - XK_KP_0));
+    }
+    switch (x_keycode) {
+        case XK_BackSpace: return KEY_BACKSPACE;
+        case XK_Return: return KEY_ENTER;
+        case XK_Tab: return KEY_TAB;
+        case XK_Pause: return KEY_PAUSE;
+        case XK_Caps_Lock: return KEY_CAPITAL;
+        case XK_Escape: return KEY_ESCAPE;
+        case XK_Mode_switch: return KEY_MODECHANGE;
+        case XK_space: return KEY_SPACE;
+        case XK_Prior: return KEY_PRIOR;
+        case XK_Next: return KEY_NEXT;
+        case XK_End: return KEY_END;
+        case XK_Home: return KEY_HOME;
+        case XK_Left: return KEY_LEFT;
+        case XK_Up: return KEY_UP;
+        case XK_Right: return KEY_RIGHT;
+        case XK_Down: return KEY_DOWN;
+        case XK_Select: return KEY_SELECT;
+        case XK_Print: return KEY_PRINT;
+        case XK_Execute: return KEY_EXECUTE;
+        case XK_Insert: return KEY_INSERT;
+        case XK_Delete: return KEY_DELETE;
+        case XK_Help: return KEY_HELP;
+        case XK_Super_L: return KEY_LWIN;
+        case XK_Super_R: return KEY_RWIN;
+        case XK_Menu: return KEY_APPS;
+        case XK_KP_Multiply: return KEY_MULTIPLY;
+        case XK_KP_Add: return KEY_ADD;
+        case XK_KP_Separator: return KEY_SEPARATOR;
+        case XK_KP_Subtract: return KEY_SUBTRACT;
+        case XK_KP_Decimal: return KEY_DECIMAL;
+        case XK_KP_Divide: return KEY_DIVIDE;
+        case XK_KP_Equal: return KEY_NUMPAD_EQUAL;
+        case XK_KP_Enter: return KEY_ENTER;
+        case XK_Num_Lock: return KEY_NUMLOCK;
+        case XK_Scroll_Lock: return KEY_SCROLL;
+        case XK_Shift_L: return KEY_LSHIFT;
+        case XK_Shift_R: return KEY_RSHIFT;
+        case XK_Control_L: return KEY_LCONTROL;
+        case XK_Control_R: return KEY_RCONTROL;
+        case XK_Alt_L: return KEY_LALT;
+        case XK_Alt_R: return KEY_RALT;
+        case XK_semicolon: return KEY_SEMICOLON;
+        case XK_equal: return KEY_PLUS;
+        case XK_plus: return KEY_PLUS;
+        case XK_comma: return KEY_COMMA;
+        case XK_minus: return KEY_MINUS;
+        case XK_period: return KEY_PERIOD;
+        case XK_slash: return KEY_SLASH;
+        case XK_grave: return KEY_GRAVE;
+        default: return KEYS_MAX_KEYS;
+    }
+}
+#endif
@@ -1,4 +1,6 @@
 #include "platform/platform.h"
+#include "platform/threading.h"
+#include "platform/filesystem.h"
 
 #if DPLATFORM_WINDOWS
 #include <core/logger.h>
@@ -16,6 +18,7 @@ struct PlatformState{
     HINSTANCE hInstance;
     HWND hwnd;
     VkSurfaceKHR surface;
+    b8 headless;
 };
 
 static f64 clock_frequency;
@@ -32,13 +35,18 @@ void ClockSetup() {
 
 LRESULT CALLBACK Win32ProcessMessage(HWND hwnd, u32 msg, WPARAM w_param, LPARAM l_param);
 
-b8 PlatformSystemStartup(u64* memory_requirement, void* state, char* appName, i32 x, i32 y, i32 width, i32 height){
+b8 PlatformSystemStartup(u64* memory_requirement, void* state, char* appName, i32 x, i32 y, i32 width, i32 height, b8 headless){
     *memory_requirement = sizeof(PlatformState);
     if (state == 0) {
         return true;
     }
     platform_state_ptr = (PlatformState*)state;
     platform_state_ptr->hInstance = GetModuleHandleA(0);
+    platform_state_ptr->headless = headless;
+    if (headless) {
+        ClockSetup();
+        return true;
+    }
 
     HICON icon = LoadIcon(platform_state_ptr->hInstance, IDI_APPLICATION);
     WNDCLASSA wc = {};
@@ -114,7 +122,7 @@ void PlatformSystemShutdown(void* state) {
 }
 
 b8 PlatformPumpMessages() {
-    if (platform_state_ptr) {
+    if (platform_state_ptr && !platform_state_ptr->headless) {
         MSG message;
         while (PeekMessageA(&message, NULL, 0, 0, PM_REMOVE)) {
             TranslateMessage(&message);
@@ -168,6 +176,63 @@ void PlatformConsoleWriteError(char* message, u8 color) {
     WriteConsoleA(GetStdHandle(STD_ERROR_HANDLE), message, (DWORD)length, numberWritten, 0);
 }
 
+b8 FileSystemMap(char* path, FileAccessHint hint, FileMapping* out_mapping) {
+    out_mapping->data = 0;
+    out_mapping->size = 0;
+    DWORD flags = FILE_ATTRIBUTE_NORMAL;
+    if (hint == FILE_ACCESS_SEQUENTIAL) {
+        flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+    } else if (hint == FILE_ACCESS_RANDOM) {
+        flags |= FILE_FLAG_RANDOM_ACCESS;
+    }
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, flags, 0);
+    if (file == INVALID_HANDLE_VALUE) {
+        DERROR("FileSystemMap - unable to open '%s', error %u.", path, GetLastError());
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        DERROR("FileSystemMap - unable to size '%s', error %u.", path, GetLastError());
+        CloseHandle(file);
+        return false;
+    }
+    if (size.QuadPart == 0) {
+        //CreateFileMapping refuses empty files, an empty view is still a successful map
+        CloseHandle(file);
+        return true;
+    }
+    HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+    CloseHandle(file);
+    if (!mapping) {
+        DERROR("FileSystemMap - CreateFileMapping of '%s' failed with %u.", path, GetLastError());
+        return false;
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    //the view keeps the mapping and file alive until it is unmapped
+    CloseHandle(mapping);
+    if (!data) {
+        DERROR("FileSystemMap - MapViewOfFile of '%s' failed with %u.", path, GetLastError());
+        return false;
+    }
+    if (hint == FILE_ACCESS_SEQUENTIAL) {
+        WIN32_MEMORY_RANGE_ENTRY range;
+        range.VirtualAddress = data;
+        range.NumberOfBytes = (SIZE_T)size.QuadPart;
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+    out_mapping->data = data;
+    out_mapping->size = (u64)size.QuadPart;
+    return true;
+}
+
+void FileSystemUnmap(FileMapping* mapping) {
+    if (mapping->data) {
+        UnmapViewOfFile(mapping->data);
+    }
+    mapping->data = 0;
+    mapping->size = 0;
+}
+
 f64 PlatformGetAbsoluteTime() {
     if (!clock_frequency) {
         ClockSetup();
@@ -177,16 +242,317 @@ f64 PlatformGetAbsoluteTime() {
     return (f64)curr_time.QuadPart * clock_frequency;
 }
 
+u64 PlatformGetOsTicks() {
+    LARGE_INTEGER curr_time;
+    QueryPerformanceCounter(&curr_time);
+    return (u64)curr_time.QuadPart;
+}
+
+u64 PlatformGetOsTickFrequency() {
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    return (u64)frequency.QuadPart;
+}
+
 void PlatformSleep(u64 ms) {
     Sleep(ms);
 }
 
+b8 PlatformFutexWait(u32* address, u32 expected, u64 timeout_ms) {
+    DWORD timeout = timeout_ms == PLATFORM_WAIT_INFINITE ? INFINITE : (DWORD)Minimum(timeout_ms, (u64)0xFFFFFFFE);
+    if (!WaitOnAddress(address, &expected, sizeof(u32), timeout)) {
+        return GetLastError() != ERROR_TIMEOUT;
+    }
+    return true;
+}
+
+void PlatformFutexWake(u32* address, u32 count) {
+    if (count == 1) {
+        WakeByAddressSingle(address);
+    } else {
+        WakeByAddressAll(address);
+    }
+}
+
+b8 PlatformFileOpenRead(char* path, u64* out_handle, u64* out_size) {
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if (file == INVALID_HANDLE_VALUE) {
+        DERROR("PlatformFileOpenRead - unable to open '%s', error %u.", path, GetLastError());
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        DERROR("PlatformFileOpenRead - unable to size '%s', error %u.", path, GetLastError());
+        CloseHandle(file);
+        return false;
+    }
+    *out_handle = (u64)file;
+    *out_size = (u64)size.QuadPart;
+    return true;
+}
+
+void PlatformFileClose(u64 handle) {
+    CloseHandle((HANDLE)handle);
+}
+
+b8 PlatformFileReadAt(u64 handle, u64 offset, u64 size, void* destination, u64* out_bytes_read) {
+    u64 total = 0;
+    while (total < size) {
+        //the offset in the OVERLAPPED makes it a positional read even on a synchronous handle
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = (DWORD)(offset + total);
+        overlapped.OffsetHigh = (DWORD)((offset + total) >> 32);
+        DWORD chunk = (DWORD)Minimum(size - total, (u64)0x80000000);
+        DWORD read = 0;
+        if (!ReadFile((HANDLE)handle, (u8*)destination + total, chunk, &read, &overlapped)) {
+            if (GetLastError() == ERROR_HANDLE_EOF) {
+                break;
+            }
+            *out_bytes_read = total;
+            return false;
+        }
+        if (read == 0) {
+            break;
+        }
+        total += read;
+    }
+    *out_bytes_read = total;
+    return true;
+}
+
+//No kernel queue used on windows yet, async_io.cpp falls back to its worker threads
+b8 PlatformIoQueueCreate(u32 entries, void** out_queue) {
+    *out_queue = 0;
+    return false;
+}
+
+void PlatformIoQueueDestroy(void* queue) {
+}
+
+b8 PlatformIoQueueSubmitRead(void* queue, u64 handle, u64 offset, u32 size, void* destination, u64 user_data) {
+    return false;
+}
+
+b8 PlatformIoQueueSubmit(void* queue) {
+    return false;
+}
+
+u32 PlatformIoQueueReap(void* queue, PlatformIoCompletion* out_completions, u32 max_count, u64 timeout_ms) {
+    return 0;
+}
+
+struct Win32ThreadStart {
+    PfnThreadStart start;
+    void* params;
+};
+
+static DWORD WINAPI Win32ThreadEntry(LPVOID params) {
+    Win32ThreadStart info = *(Win32ThreadStart*)params;
+    PlatformFree(params, false);
+    return info.start(info.params);
+}
+
+b8 ThreadCreate(PfnThreadStart start, void* params, b8 auto_detach, Thread* out_thread) {
+    out_thread->handle = 0;
+    out_thread->thread_id = 0;
+    if (!start) {
+        return false;
+    }
+    Win32ThreadStart* info = (Win32ThreadStart*)PlatformAllocate(sizeof(Win32ThreadStart), false);
+    info->start = start;
+    info->params = params;
+    DWORD thread_id = 0;
+    HANDLE handle = CreateThread(0, 0, Win32ThreadEntry, info, 0, &thread_id);
+    if (!handle) {
+        DERROR("ThreadCreate - CreateThread failed with %u.", GetLastError());
+        PlatformFree(info, false);
+        return false;
+    }
+    if (auto_detach) {
+        CloseHandle(handle);
+    } else {
+        out_thread->handle = (u64)handle;
+        out_thread->thread_id = thread_id;
+    }
+    return true;
+}
+
+b8 ThreadJoin(Thread* thread, u32* out_exit_code) {
+    if (!thread->handle) {
+        return false;
+    }
+    HANDLE handle = (HANDLE)thread->handle;
+    b8 result = WaitForSingleObject(handle, INFINITE) == WAIT_OBJECT_0;
+    if (out_exit_code) {
+        DWORD exit_code = 0;
+        GetExitCodeThread(handle, &exit_code);
+        *out_exit_code = exit_code;
+    }
+    CloseHandle(handle);
+    thread->handle = 0;
+    return result;
+}
+
+void ThreadDetach(Thread* thread) {
+    if (thread->handle) {
+        CloseHandle((HANDLE)thread->handle);
+        thread->handle = 0;
+    }
+}
+
+b8 ThreadSetName(Thread* thread, char* name) {
+    if (thread && !thread->handle) {
+        DWARN("ThreadSetName - thread has no handle, auto detached threads have to name themselves.");
+        return false;
+    }
+    wchar_t wide_name[64];
+    u32 length = 0;
+    while (name[length] && length < ArrayCount(wide_name) - 1) {
+        wide_name[length] = (wchar_t)name[length];
+        length++;
+    }
+    wide_name[length] = 0;
+    return SUCCEEDED(SetThreadDescription(thread ? (HANDLE)thread->handle : GetCurrentThread(), wide_name));
+}
+
+u64 ThreadGetCurrentId() {
+    return GetCurrentThreadId();
+}
+
+void ThreadYield() {
+    SwitchToThread();
+}
+
+b8 CpuGetTopology(CpuTopology* out_topology) {
+    PlatformZeroMemory(out_topology, sizeof(CpuTopology));
+    DWORD length = 0;
+    GetLogicalProcessorInformationEx(RelationAll, 0, &length);
+    if (GetLastError() != ERROR_INSUFFICIENT_BUFFER) {
+        return false;
+    }
+    u8* buffer = (u8*)PlatformAllocate(length, false);
+    if (!GetLogicalProcessorInformationEx(RelationAll, (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)buffer, &length)) {
+        PlatformFree(buffer, false);
+        return false;
+    }
+    //only processor group 0 is looked at, which is every cpu on machines with 64 or fewer
+    for (DWORD offset = 0; offset < length;) {
+        SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* info = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)(buffer + offset);
+        if (info->Relationship == RelationProcessorCore) {
+            GROUP_AFFINITY* group = &info->Processor.GroupMask[0];
+            if (group->Group == 0) {
+                for (u32 cpu = 0; cpu < 64; cpu++) {
+                    if (group->Mask & (1ULL << cpu)) {
+                        CpuSetAdd(&out_topology->online, cpu);
+                        out_topology->core_index[cpu] = (u16)out_topology->physical_cores;
+                        out_topology->logical_cores++;
+                    }
+                }
+                out_topology->physical_cores++;
+            }
+        } else if (info->Relationship == RelationCache) {
+            CACHE_RELATIONSHIP* cache = &info->Cache;
+            //every core reports its own l1/l2, they're the same size so the last one seen is fine
+            if (cache->Level == 1 && cache->Type != CacheInstruction) {
+                out_topology->l1_data_cache_size = cache->CacheSize;
+                out_topology->cache_line_size = cache->LineSize;
+            } else if (cache->Level == 2) {
+                out_topology->l2_cache_size = cache->CacheSize;
+            } else if (cache->Level == 3) {
+                out_topology->l3_cache_size = cache->CacheSize;
+            }
+        } else if (info->Relationship == RelationNumaNode) {
+            NUMA_NODE_RELATIONSHIP* node = &info->NumaNode;
+            if (node->GroupMask.Group == 0) {
+                for (u32 cpu = 0; cpu < 64; cpu++) {
+                    if (node->GroupMask.Mask & (1ULL << cpu)) {
+                        out_topology->numa_node[cpu] = (u16)node->NodeNumber;
+                    }
+                }
+            }
+            out_topology->numa_nodes++;
+        }
+        offset += info->Size;
+    }
+    PlatformFree(buffer, false);
+    if (!out_topology->cache_line_size) {
+        out_topology->cache_line_size = 64;
+    }
+    if (!out_topology->numa_nodes) {
+        out_topology->numa_nodes = 1;
+    }
+    return out_topology->logical_cores > 0;
+}
+
+b8 ThreadSetAffinity(Thread* thread, CpuSet* cpus) {
+    if (!SetThreadAffinityMask(thread ? (HANDLE)thread->handle : GetCurrentThread(), (DWORD_PTR)cpus->bits[0])) {
+        DWARN("ThreadSetAffinity failed with %u.", GetLastError());
+        return false;
+    }
+    return true;
+}
+
+b8 ThreadSetPriority(Thread* thread, ThreadPriority priority) {
+    i32 priorities[] = {THREAD_PRIORITY_BELOW_NORMAL, THREAD_PRIORITY_NORMAL, THREAD_PRIORITY_ABOVE_NORMAL, THREAD_PRIORITY_HIGHEST};
+    if (!SetThreadPriority(thread ? (HANDLE)thread->handle : GetCurrentThread(), priorities[priority])) {
+        DWARN("ThreadSetPriority failed with %u.", GetLastError());
+        return false;
+    }
+    return true;
+}
+
+//SRW locks so the condition variables below can sleep on them, neither needs destroying
+STATIC_ASSERT(sizeof(SRWLOCK) <= sizeof(Mutex::internal_data), "Mutex storage too small for SRWLOCK");
+STATIC_ASSERT(sizeof(CONDITION_VARIABLE) <= sizeof(ConditionVariable::internal_data), "ConditionVariable storage too small");
+
+b8 MutexCreate(Mutex* out_mutex) {
+    InitializeSRWLock((SRWLOCK*)out_mutex->internal_data);
+    return true;
+}
+
+void MutexDestroy(Mutex* mutex) {
+}
+
+void MutexLock(Mutex* mutex) {
+    AcquireSRWLockExclusive((SRWLOCK*)mutex->internal_data);
+}
+
+b8 MutexTryLock(Mutex* mutex) {
+    return TryAcquireSRWLockExclusive((SRWLOCK*)mutex->internal_data) != 0;
+}
+
+void MutexUnlock(Mutex* mutex) {
+    ReleaseSRWLockExclusive((SRWLOCK*)mutex->internal_data);
+}
+
+b8 ConditionVariableCreate(ConditionVariable* out_condition) {
+    InitializeConditionVariable((CONDITION_VARIABLE*)out_condition->internal_data);
+    return true;
+}
+
+void ConditionVariableDestroy(ConditionVariable* condition) {
+}
+
+b8 ConditionVariableWait(ConditionVariable* condition, Mutex* mutex, u64 timeout_ms) {
+    DWORD timeout = timeout_ms == PLATFORM_WAIT_INFINITE ? INFINITE : (DWORD)Minimum(timeout_ms, (u64)0xFFFFFFFE);
+    return SleepConditionVariableSRW((CONDITION_VARIABLE*)condition->internal_data, (SRWLOCK*)mutex->internal_data, timeout, 0) != 0;
+}
+
+void ConditionVariableSignal(ConditionVariable* condition) {
+    WakeConditionVariable((CONDITION_VARIABLE*)condition->internal_data);
+}
+
+void ConditionVariableBroadcast(ConditionVariable* condition) {
+    WakeAllConditionVariable((CONDITION_VARIABLE*)condition->internal_data);
+}
+
 void PlatformGetRequiredExtensionNames(char*** names_darray) {
     DarrayPush(*names_darray, (char*)"VK_KHR_win32_surface");
 }
 
 b8 PlatformCreateVulkanSurface(VulkanContext* context) {
-    if (!platform_state_ptr) {
+    if (!platform_state_ptr || platform_state_ptr->headless) {
+        DFATAL("Vulkan surface needs a window, use the null renderer when headless.");
         return false;
     }
     VkWin32SurfaceCreateInfoKHR create_info = {VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR};
@@ -228,7 +594,7 @@ LRESULT CALLBACK Win32ProcessMessage(HWND hwnd, u32 msg, WPARAM w_param, LPARAM
             return 1;
         case WM_CLOSE:{
             EventContext data = {};
-            EventFire(EVENT_CODE_APPLICATION_QUIT, 0, data);
+            EventPost(EVENT_CODE_APPLICATION_QUIT, 0, data);
         } return 0;
         case WM_DESTROY: {
             PostQuitMessage(0);
@@ -243,7 +609,7 @@ LRESULT CALLBACK Win32ProcessMessage(HWND hwnd, u32 msg, WPARAM w_param, LPARAM
             EventContext context = {};
             context.data.u16[0] = (u16)width;
             context.data.u16[1] = (u16)height;
-            EventFire(EVENT_CODE_RESIZED, 0, context);
+            EventPost(EVENT_CODE_RESIZED, 0, context);
         } break;
         case WM_KEYDOWN:
         case WM_SYSKEYDOWN:
@@ -0,0 +1,54 @@
+#include "platform/threading.h"
+
+#include "platform/platform.h"
+#include "core/datomic.h"
+
+void SemaphoreCreate(u32 initial_count, Semaphore* out_semaphore) {
+    out_semaphore->count = initial_count;
+    out_semaphore->waiters = 0;
+}
+
+void SemaphoreDestroy(Semaphore* semaphore) {
+    //nothing held outside the struct
+    semaphore->count = 0;
+    semaphore->waiters = 0;
+}
+
+void SemaphoreSignal(Semaphore* semaphore, u32 count) {
+    AtomicFetchAddU32(&semaphore->count, count);
+    //read with an atomic add so it can't be ordered before the count above, a waiter registering concurrently
+    //either shows up here or is guaranteed to see the new count when the futex checks it
+    if (AtomicFetchAddU32(&semaphore->waiters, 0)) {
+        PlatformFutexWake(&semaphore->count, count);
+    }
+}
+
+b8 SemaphoreWait(Semaphore* semaphore, u64 timeout_ms) {
+    u32 count = AtomicLoadU32(&semaphore->count);
+    f64 deadline = 0;
+    for (;;) {
+        while (count > 0) {
+            if (AtomicCompareExchangeU32(&semaphore->count, &count, count - 1)) {
+                return true;
+            }
+        }
+
+        u64 wait_ms = PLATFORM_WAIT_INFINITE;
+        if (timeout_ms != PLATFORM_WAIT_INFINITE) {
+            //only read the clock once there is actually a wait to time
+            f64 now = PlatformGetAbsoluteTime();
+            if (deadline == 0) {
+                deadline = now + timeout_ms / 1000.0;
+            }
+            if (now >= deadline) {
+                return false;
+            }
+            wait_ms = (u64)((deadline - now) * 1000.0) + 1;
+        }
+
+        AtomicFetchAddU32(&semaphore->waiters, 1);
+        PlatformFutexWait(&semaphore->count, 0, wait_ms);
+        AtomicFetchSubU32(&semaphore->waiters, 1);
+        count = AtomicLoadU32(&semaphore->count);
+    }
+}
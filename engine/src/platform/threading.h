@@ -0,0 +1,141 @@
+#pragma once
+
+#include "defines.h"
+
+//Wait forever in the timeout_ms parameters below
+#define PLATFORM_WAIT_INFINITE 0xFFFFFFFFFFFFFFFFULL
+
+//Return value is the exit code handed to ThreadJoin
+typedef u32 (*PfnThreadStart)(void* params);
+
+struct Thread{
+    u64 handle;
+    u64 thread_id;
+};
+
+//Storage for the platform's own lock and condition types, kept inline so creating one never allocates
+struct Mutex{
+    u64 internal_data[8];
+};
+
+struct ConditionVariable{
+    u64 internal_data[8];
+};
+
+/*
+Counting semaphore that stays in user space unless a thread actually has to sleep: signal and wait are one
+atomic each when uncontended, the kernel (futex, WaitOnAddress on windows) is only entered to block or to wake
+a sleeper. Can be zero initialized instead of created.
+*/
+struct Semaphore{
+    u32 count;
+    u32 waiters;
+};
+
+/*
+Starts start(params) on a new thread. An auto detached thread cleans up after itself and can't be joined,
+otherwise ThreadJoin or ThreadDetach must be called once.
+*/
+DAPI b8 ThreadCreate(PfnThreadStart start, void* params, b8 auto_detach, Thread* out_thread);
+DAPI b8 ThreadJoin(Thread* thread, u32* out_exit_code);
+DAPI void ThreadDetach(Thread* thread);
+
+/*
+Shows up in debuggers and profilers. Linux keeps the first 15 characters. A null thread names the calling one.
+Auto detached, joined and detached threads have no handle left to name by, so those fail: they can name
+themselves with a null thread from inside their start function.
+*/
+DAPI b8 ThreadSetName(Thread* thread, char* name);
+//The OS id (what perf, top or task manager show), not a pthread handle
+DAPI u64 ThreadGetCurrentId();
+DAPI void ThreadYield();
+
+//Highest logical cpu index the topology and affinity calls know about
+#define PLATFORM_MAX_CPUS 256
+
+//Bit per logical cpu, by the OS's cpu index
+struct CpuSet{
+    u64 bits[PLATFORM_MAX_CPUS / 64];
+};
+
+DINLINE void CpuSetClear(CpuSet* set) {
+    for (u32 i = 0; i < PLATFORM_MAX_CPUS / 64; i++) {
+        set->bits[i] = 0;
+    }
+}
+
+DINLINE void CpuSetAdd(CpuSet* set, u32 cpu) {
+    set->bits[cpu / 64] |= 1ULL << (cpu % 64);
+}
+
+DINLINE b8 CpuSetContains(CpuSet* set, u32 cpu) {
+    return (set->bits[cpu / 64] >> (cpu % 64)) & 1;
+}
+
+DINLINE u32 CpuSetCount(CpuSet* set) {
+    u32 count = 0;
+    for (u32 i = 0; i < PLATFORM_MAX_CPUS / 64; i++) {
+        for (u64 bits = set->bits[i]; bits; bits &= bits - 1) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/*
+What the machine looks like to the scheduler, for sizing worker pools and keeping threads that share data on
+cores that share caches. Physical cores count SMT siblings once. Cache sizes are what the first online cpu sees,
+l3 is shared by (at least) the cores of its package. Per cpu arrays are indexed by logical cpu and only
+meaningful for cpus in online.
+*/
+struct CpuTopology{
+    u32 logical_cores;
+    u32 physical_cores;
+    u32 numa_nodes;
+    u32 cache_line_size;
+    u64 l1_data_cache_size;
+    u64 l2_cache_size;
+    u64 l3_cache_size;
+    //0 based physical core a logical cpu belongs to, SMT siblings share one
+    u16 core_index[PLATFORM_MAX_CPUS];
+    u16 numa_node[PLATFORM_MAX_CPUS];
+    CpuSet online;
+};
+
+//Falls back to one core per logical cpu on a single node when the OS won't say more. False if nothing is known
+DAPI b8 CpuGetTopology(CpuTopology* out_topology);
+
+//Not named THREAD_PRIORITY_* to stay clear of the windows macros
+enum ThreadPriority {
+    THREAD_PRIO_LOW,
+    THREAD_PRIO_NORMAL,
+    THREAD_PRIO_HIGH,
+    THREAD_PRIO_HIGHEST
+};
+
+/*
+Both take 0 for the calling thread. Affinity restricts the thread to the cpus in the set (windows only honors
+the first 64, processor group 0). Raising priority above normal usually needs privileges on linux, these
+return false and leave the thread as it was when the OS refuses.
+*/
+DAPI b8 ThreadSetAffinity(Thread* thread, CpuSet* cpus);
+DAPI b8 ThreadSetPriority(Thread* thread, ThreadPriority priority);
+
+DAPI b8 MutexCreate(Mutex* out_mutex);
+DAPI void MutexDestroy(Mutex* mutex);
+DAPI void MutexLock(Mutex* mutex);
+DAPI b8 MutexTryLock(Mutex* mutex);
+DAPI void MutexUnlock(Mutex* mutex);
+
+DAPI void SemaphoreCreate(u32 initial_count, Semaphore* out_semaphore);
+DAPI void SemaphoreDestroy(Semaphore* semaphore);
+DAPI void SemaphoreSignal(Semaphore* semaphore, u32 count);
+//Returns false if timeout_ms passed first, 0 only takes a count that is already there
+DAPI b8 SemaphoreWait(Semaphore* semaphore, u64 timeout_ms);
+
+DAPI b8 ConditionVariableCreate(ConditionVariable* out_condition);
+DAPI void ConditionVariableDestroy(ConditionVariable* condition);
+//mutex must be locked and is locked again on return. Returns false on timeout, wakeups can be spurious
+DAPI b8 ConditionVariableWait(ConditionVariable* condition, Mutex* mutex, u64 timeout_ms);
+DAPI void ConditionVariableSignal(ConditionVariable* condition);
+DAPI void ConditionVariableBroadcast(ConditionVariable* condition);
@@ -0,0 +1,120 @@
+#include "null_backend.h"
+
+#include "core/logger.h"
+
+struct NullRendererState {
+    NullRendererStats stats;
+    b8 initialized;
+    b8 in_frame;
+};
+
+//no allocations and nothing to hand back, so unlike the vulkan context this is plain static storage
+static NullRendererState null_state;
+
+//stored in internal_data so DestroyTexture can tell its own textures from garbage and double frees
+static u32 null_texture_tag;
+
+static void NullValidationError(char* message) {
+    null_state.stats.validation_errors++;
+    DERROR("Null renderer: %s", message);
+}
+
+b8 NullRendererBackendInitialize(RendererBackend* backend, char* application_name) {
+    null_state.stats.initialize_calls++;
+    if (null_state.initialized) {
+        NullValidationError("Initialize called twice.");
+        return false;
+    }
+    null_state.initialized = true;
+    null_state.in_frame = false;
+    DINFO("Null renderer initialized for '%s'.", application_name);
+    return true;
+}
+
+void NullRendererBackendShutdown(RendererBackend* backend) {
+    null_state.stats.shutdown_calls++;
+    if (!null_state.initialized) {
+        NullValidationError("Shutdown called without Initialize.");
+        return;
+    }
+    if (null_state.in_frame) {
+        NullValidationError("Shutdown called inside a frame.");
+    }
+    if (null_state.stats.live_textures) {
+        DWARN("Null renderer: %u textures still alive at shutdown.", null_state.stats.live_textures);
+    }
+    null_state.initialized = false;
+    null_state.in_frame = false;
+}
+
+void NullRendererBackendOnResized(RendererBackend* backend, u16 width, u16 height) {
+    null_state.stats.resized_calls++;
+    if (width == 0 || height == 0) {
+        NullValidationError("Resized to a zero size, the application should be suspended instead.");
+    }
+}
+
+b8 NullRendererBackendBeginFrame(RendererBackend* backend, f32 delta_time) {
+    null_state.stats.begin_frame_calls++;
+    if (!null_state.initialized || null_state.in_frame) {
+        NullValidationError("BeginFrame called before Initialize or inside another frame.");
+        return false;
+    }
+    null_state.in_frame = true;
+    return true;
+}
+
+void NullRendererBackendUpdateGlobalState(Mat4 projection, Mat4 view, Vec3 view_position, Vec4 ambient_color, i32 mode) {
+    null_state.stats.update_global_state_calls++;
+    if (!null_state.in_frame) {
+        NullValidationError("UpdateGlobalState called outside a frame.");
+    }
+}
+
+b8 NullRendererBackendEndFrame(RendererBackend* backend, f32 delta_time) {
+    null_state.stats.end_frame_calls++;
+    if (!null_state.in_frame) {
+        NullValidationError("EndFrame called without BeginFrame.");
+        return false;
+    }
+    null_state.in_frame = false;
+    return true;
+}
+
+void NullRendererBackendUpdateObject(GeometryRenderData data) {
+    null_state.stats.update_object_calls++;
+    if (!null_state.in_frame) {
+        NullValidationError("UpdateObject called outside a frame.");
+    }
+}
+
+void NullRendererCreateTexture(char* name, b8 auto_release, i32 width, i32 height, i32 channel_count,
+                               u8* pixels, b8 has_transparency, Texture* out_texture) {
+    null_state.stats.create_texture_calls++;
+    if (!null_state.initialized || !pixels || width <= 0 || height <= 0 || channel_count < 1 || channel_count > 4) {
+        NullValidationError("CreateTexture called before Initialize or with invalid pixels.");
+        return;
+    }
+    out_texture->width = width;
+    out_texture->height = height;
+    out_texture->channel_count = (u8)channel_count;
+    out_texture->has_transparency = has_transparency;
+    //nothing to upload, so it is immediately on its first generation
+    out_texture->generation = 0;
+    out_texture->internal_data = &null_texture_tag;
+    null_state.stats.live_textures++;
+}
+
+void NullRendererDestroyTexture(Texture* texture) {
+    null_state.stats.destroy_texture_calls++;
+    if (texture->internal_data != &null_texture_tag) {
+        NullValidationError("DestroyTexture called on a texture it didn't create or already destroyed.");
+        return;
+    }
+    texture->internal_data = 0;
+    null_state.stats.live_textures--;
+}
+
+void NullRendererGetStats(NullRendererStats* out_stats) {
+    *out_stats = null_state.stats;
+}
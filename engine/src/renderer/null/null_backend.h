@@ -0,0 +1,44 @@
+#pragma once
+
+#include "renderer/renderer_backend.h"
+
+/*
+Backend that draws nothing. It checks that the frontend drives the function table in a valid order (initialized,
+frames begun and ended in pairs, per frame updates only inside a frame, textures destroyed once) and counts every
+call, so the full frame loop can run and be profiled on machines with no display or GPU.
+*/
+struct NullRendererStats {
+    u64 initialize_calls;
+    u64 shutdown_calls;
+    u64 resized_calls;
+    u64 begin_frame_calls;
+    u64 end_frame_calls;
+    u64 update_global_state_calls;
+    u64 update_object_calls;
+    u64 create_texture_calls;
+    u64 destroy_texture_calls;
+    //calls that broke one of the rules above, each one is also logged
+    u64 validation_errors;
+    u32 live_textures;
+};
+
+b8 NullRendererBackendInitialize(RendererBackend* backend, char* application_name);
+
+void NullRendererBackendShutdown(RendererBackend* backend);
+
+void NullRendererBackendOnResized(RendererBackend* backend, u16 width, u16 height);
+
+b8 NullRendererBackendBeginFrame(RendererBackend* backend, f32 delta_time);
+
+void NullRendererBackendUpdateGlobalState(Mat4 projection, Mat4 view, Vec3 view_position, Vec4 ambient_color, i32 mode);
+
+b8 NullRendererBackendEndFrame(RendererBackend* backend, f32 delta_time);
+
+void NullRendererBackendUpdateObject(GeometryRenderData data);
+
+void NullRendererCreateTexture(char* name, b8 auto_release, i32 width, i32 height, i32 channel_count,
+                               u8* pixels, b8 has_transparency, Texture* out_texture);
+
+void NullRendererDestroyTexture(Texture* texture);
+
+DAPI void NullRendererGetStats(NullRendererStats* out_stats);
@@ -1,5 +1,6 @@
 #include "renderer_backend.h"
 #include "vulkan/vulkan_backend.h"
+#include "null/null_backend.h"
 
 b8 RendererBackendCreate(RendererBackendType type, RendererBackend* out_renderer_backend){
     if (type == RENDERER_BACKEND_TYPE_VULKAN) {
@@ -13,6 +14,17 @@ b8 RendererBackendCreate(RendererBackendType type, RendererBackend* out_renderer
         out_renderer_backend->CreateTexture = VulkanRendererCreateTexture;
         out_renderer_backend->DestroyTexture = VulkanRendererDestroyTexture;
         return true;
+    } else if (type == RENDERER_BACKEND_TYPE_NULL) {
+        out_renderer_backend->Initialize = NullRendererBackendInitialize;
+        out_renderer_backend->Shutdown = NullRendererBackendShutdown;
+        out_renderer_backend->BeginFrame = NullRendererBackendBeginFrame;
+        out_renderer_backend->UpdateGlobalState = NullRendererBackendUpdateGlobalState;
+        out_renderer_backend->EndFrame = NullRendererBackendEndFrame;
+        out_renderer_backend->Resized = NullRendererBackendOnResized;
+        out_renderer_backend->UpdateObject = NullRendererBackendUpdateObject;
+        out_renderer_backend->CreateTexture = NullRendererCreateTexture;
+        out_renderer_backend->DestroyTexture = NullRendererDestroyTexture;
+        return true;
     }
     return false;
 }
@@ -2,6 +2,7 @@
 #include "renderer_backend.h"
 #include "core/logger.h"
 #include "core/dmemory.h"
+#include "core/dstring.h"
 #include "math/dmath.h"
 #include "resources/resource_types.h"
 
@@ -17,14 +18,17 @@ struct RendererSystemState {
 
 static RendererSystemState* renderer_state_ptr;
 
-b8 RendererSystemInitialize(u64* memory_requirement, void* state, char* application_name) {
+b8 RendererSystemInitialize(u64* memory_requirement, void* state, char* application_name, RendererBackendType backend_type) {
     *memory_requirement = sizeof(RendererSystemState);
     if (state == 0) {
         return true;
     }
     renderer_state_ptr = (RendererSystemState*)state;
 
-    RendererBackendCreate(RENDERER_BACKEND_TYPE_VULKAN, &renderer_state_ptr->backend);
+    if (!RendererBackendCreate(backend_type, &renderer_state_ptr->backend)) {
+        DFATAL("Renderer backend type %i is not supported.", backend_type);
+        return false;
+    }
     renderer_state_ptr->backend.frame_number = 0;
 
     if (!renderer_state_ptr->backend.Initialize(&renderer_state_ptr->backend, application_name)) {
@@ -132,8 +136,10 @@ void RendererSetView(Mat4 view) {
 void RendererCreateTexture(char* name, b8 auto_release, i32 width, i32 height, i32 channel_count,
                       u8* pixels, b8 has_transparency, Texture* out_texture) {
     renderer_state_ptr->backend.CreateTexture(name, auto_release, width, height, channel_count, pixels, has_transparency, out_texture);
+    DStringCreate(name, 0, &out_texture->name);
 }
 
 void RendererDestroyTexture(Texture* texture) {
+    DStringDestroy(&texture->name);
     renderer_state_ptr->backend.DestroyTexture(texture);
 }
\ No newline at end of file
@@ -2,7 +2,7 @@
 
 #include "renderer_types.inl"
 
-b8 RendererSystemInitialize(u64* memory_requirement, void* state, char* application_name);
+b8 RendererSystemInitialize(u64* memory_requirement, void* state, char* application_name, RendererBackendType backend_type);
 void RendererSystemShutdown(void* state);
 
 void RendererOnResized(u16 width, u16 height);
@@ -7,7 +7,9 @@
 enum RendererBackendType{
     RENDERER_BACKEND_TYPE_VULKAN,
     RENDERER_BACKEND_TYPE_OPENGL,
-    RENDERER_BACKEND_TYPE_DIRECTX
+    RENDERER_BACKEND_TYPE_DIRECTX,
+    //no GPU work, validates and counts calls (headless runs)
+    RENDERER_BACKEND_TYPE_NULL
 };
 
 struct GlobalUniformObject {
@@ -14,22 +14,15 @@ b8 CreateShaderModule(VulkanContext* context, char* name, char* type_str,
     DZeroMemory(&shader_stages[stage_index].create_info, sizeof(VkShaderModuleCreateInfo));
     shader_stages[stage_index].create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
 
-    FileHandle handle = {};
-    if (!FileSystemOpen(file_name, FILE_MODE_READ, true, &handle)) {
-        DERROR("Unable to open read shader module: %s.", file_name);
+    //the driver copies the code into the module, so it is read straight from the pack or the mapped file
+    AssetData asset = {};
+    if (!FileSystemOpenAsset(file_name, FILE_ACCESS_SEQUENTIAL, &asset)) {
+        DERROR("Unable to open shader module: %s.", file_name);
         return false;
     }
 
-    u64 size = 0;
-    u8* file_buffer = 0;
-    if (!FileSystemReadAllBytes(&handle, &file_buffer, &size)) {
-        DERROR("Unable to binary read shader module: %s.", file_name);
-        return false;
-    }
-
-    shader_stages[stage_index].create_info.codeSize = size;
-    shader_stages[stage_index].create_info.pCode = (u32*)file_buffer;
-    FileSystemClose(&handle);
+    shader_stages[stage_index].create_info.codeSize = asset.size;
+    shader_stages[stage_index].create_info.pCode = (u32*)asset.data;
 
     VK_CHECK(vkCreateShaderModule(context->device.logical_device, 
                                   &shader_stages[stage_index].create_info,
@@ -43,10 +36,7 @@ b8 CreateShaderModule(VulkanContext* context, char* name, char* type_str,
     //below is the entry point into the shader so just has to match whatever you have as the entry point in the shader
     shader_stages[stage_index].shader_stage_create_info.pName = "main";    
 
-    if(file_buffer){
-        DFree(file_buffer, sizeof(u8) * size, MEMORY_TAG_STRING);
-        file_buffer = 0;
-    }
+    FileSystemCloseAsset(&asset);
 
     return true;
 }
\ No newline at end of file
@@ -2,8 +2,10 @@
 
 #include "defines.h"
 #include "math/math_types.h"
+#include "core/dstring.h"
 
 struct Texture {
+    DString name;
     u32 id;
     u32 width;
     u32 height;
@@ -1,11 +1,15 @@
 //core
 #include "core/clock.cpp"
+#include "core/compression.cpp"
+#include "core/frame_limiter.cpp"
 #include "core/logger.cpp"
 #include "containers/darray.cpp"
 #include "core/dmemory.cpp"
 #include "core/dstring.cpp"
 #include "core/event.cpp"
 #include "core/input.cpp"
+#include "core/input_recording.cpp"
+#include "core/input_actions.cpp"
 #include "core/application.cpp"
 
 //math
@@ -16,7 +20,11 @@
 
 //platform
 #include "platform/filesystem.cpp"
+#include "platform/threading.cpp"
+#include "platform/async_io.cpp"
+#include "platform/asset_pack.cpp"
 #include "platform/platform_win32.cpp"
+#include "platform/platform_linux.cpp"
 
 //renderer
 #include "renderer/vulkan/shaders/vulkan_object_shader.cpp"
@@ -32,5 +40,6 @@
 #include "renderer/vulkan/vulkan_shader_utils.cpp"
 #include "renderer/vulkan/vulkan_swapchain.cpp"
 #include "renderer/vulkan/vulkan_utils.cpp"
+#include "renderer/null/null_backend.cpp"
 #include "renderer/renderer_backend.cpp"
 #include "renderer/renderer_frontend.cpp"
\ No newline at end of file
@@ -0,0 +1,17 @@
+#!/bin/bash
+# Build script for the asset packer
+set -e
+
+mkdir -p ../bin
+
+filenames=$(find . -type f -name "*.cpp")
+
+assembly="packer"
+compilerFlags="-g -fPIC -Wno-missing-braces -Wno-c++11-compat-deprecated-writable-strings -Wno-writable-strings"
+# -Wall -Werror -save-temps=obj -O0
+includeFlags="-Isrc -I../engine/src/"
+linkerFlags="-L../bin/ -lengine -Wl,-rpath,. -pthread"
+defines="-D_DEBUG -DDIMPORT"
+
+echo "Building $assembly..."
+clang++ $filenames $compilerFlags -o ../bin/$assembly $defines $includeFlags $linkerFlags
@@ -0,0 +1,58 @@
+#include <core/logger.h>
+#include <core/dmemory.h>
+#include <core/dstring.h>
+#include <platform/filesystem.h>
+#include <platform/asset_pack.h>
+
+/*
+Packs loose asset files into one archive the engine mounts with FileSystemMountPack.
+Run it from the directory the game runs from, each file is stored under the path it is given on the command
+line, which is the path the engine asks for. -c compresses every file that shrinks. A compressed entry is
+decoded into a fresh buffer on every open instead of being used in place from the mapped pack, and decoding is
+no faster than reading from the page cache, so -c only pays for large assets on slow disks. Shaders and other
+small files are better left stored.
+    packer [-c] assets.dpak assets/shaders/Builtin.ObjectShader.vert.spv assets/shaders/Builtin.ObjectShader.frag.spv
+*/
+int main(int argc, char** argv){
+    AssetPackCompression compression = ASSET_PACK_COMPRESSION_NONE;
+    if (argc > 1 && StringsEqual(argv[1], "-c")) {
+        compression = ASSET_PACK_COMPRESSION_LZ;
+        argc--;
+        argv++;
+    }
+    if (argc < 3) {
+        DERROR("Usage: packer [-c] <output.dpak> <file>...");
+        return 1;
+    }
+    u32 file_count = (u32)(argc - 2);
+    FileMapping* mappings = (FileMapping*)DAllocate(sizeof(FileMapping) * file_count, MEMORY_TAG_ARRAY);
+    AssetPackSource* sources = (AssetPackSource*)DAllocate(sizeof(AssetPackSource) * file_count, MEMORY_TAG_ARRAY);
+    b8 result = true;
+    u64 total_size = 0;
+    for (u32 i = 0; i < file_count; i++) {
+        if (!FileSystemMap(argv[i + 2], FILE_ACCESS_SEQUENTIAL, &mappings[i])) {
+            result = false;
+            break;
+        }
+        sources[i].name = argv[i + 2];
+        sources[i].data = mappings[i].data;
+        sources[i].size = mappings[i].size;
+        sources[i].compression = compression;
+        total_size += mappings[i].size;
+    }
+    if (result) {
+        result = AssetPackWrite(argv[1], sources, file_count);
+    }
+    if (result) {
+        FileMapping packed;
+        u64 packed_size = FileSystemMap(argv[1], FILE_ACCESS_NORMAL, &packed) ? packed.size : 0;
+        FileSystemUnmap(&packed);
+        DINFO("Packed %u files, %llu bytes, into '%s', %llu bytes.", file_count, total_size, argv[1], packed_size);
+    }
+    for (u32 i = 0; i < file_count; i++) {
+        FileSystemUnmap(&mappings[i]);
+    }
+    DFree(mappings, sizeof(FileMapping) * file_count, MEMORY_TAG_ARRAY);
+    DFree(sources, sizeof(AssetPackSource) * file_count, MEMORY_TAG_ARRAY);
+    return result ? 0 : 1;
+}
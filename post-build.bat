@@ -17,4 +17,12 @@ echo "Copying assets..."
 echo xcopy "assets" "bin\assets" /h /i /c /k /e /r /y
 xcopy "assets" "bin\assets" /h /i /c /k /e /r /y
 
+echo "Packing assets..."
+REM names in the pack are relative to bin, where the game runs from
+REM stored uncompressed so shaders are read straight from the mapped pack, -c only pays for large assets
+PUSHD bin
+packer.exe assets.dpak assets/shaders/Builtin.ObjectShader.vert.spv assets/shaders/Builtin.ObjectShader.frag.spv
+POPD
+IF %ERRORLEVEL% NEQ 0 (echo Error: %ERRORLEVEL% && exit)
+
 echo "Done."
\ No newline at end of file
@@ -0,0 +1,18 @@
+#!/bin/bash
+# Build script for testbed
+set -e
+
+mkdir -p ../bin
+
+# Get a list of all .cpp files
+cFilenames=$(find . -type f -name "*.cpp")
+
+assembly="testbed"
+compilerFlags="-g -fPIC -Wno-c++11-compat-deprecated-writable-strings -Wno-writable-strings"
+# -Wall -Werror
+includeFlags="-Isrc -I../engine/src/"
+linkerFlags="-L../bin/ -lengine -Wl,-rpath,."
+defines="-D_DEBUG -DDIMPORT"
+
+echo "Building $assembly..."
+clang++ $cFilenames $compilerFlags -o ../bin/$assembly $defines $includeFlags $linkerFlags
@@ -8,6 +8,8 @@ b8 CreateGame(Game* outGame){
     outGame->appConfig.startWidth = 1280;
     outGame->appConfig.startHeight = 720;
     outGame->appConfig.name = "Dulce Engine Testbed";
+    outGame->appConfig.targetFrameRate = 60;
+    outGame->appConfig.assetPackPath = "assets.dpak";
     outGame->Update = GameUpdate;
     outGame->Render = GameRender;
     outGame->Initialize = GameInitialize;
@@ -1,12 +1,29 @@
 #include "game.h"
 #include <core/logger.h>
 #include <core/input.h>
+#include <core/input_actions.h>
 #include <core/dmemory.h>
 #include <math/dmath.h>
 
 //temp include
 #include <renderer/renderer_frontend.h>
 
+//Compiled in, the engine has no config files yet. Same text format InputActionsLoadBindings reads from anywhere
+static char* default_bindings =
+    "camera_yaw A 1\n"
+    "camera_yaw LEFT 1\n"
+    "camera_yaw D -1\n"
+    "camera_yaw RIGHT -1\n"
+    "camera_pitch UP 1\n"
+    "camera_pitch DOWN -1\n"
+    "move_forward W 1\n"
+    "move_forward S -1\n"
+    "move_right E 1\n"
+    "move_right Q -1\n"
+    "move_up SPACE 1\n"
+    "move_up X -1\n"
+    "debug_allocations M\n";
+
 void RecalculateViewMatrix(GameState* state) {
     if (state->camera_view_dirty) {
         Mat4 rotation = Mat4EulerXyz(state->camera_euler.x, state->camera_euler.y, state->camera_euler.z);
@@ -41,6 +58,17 @@ b8 GameInitialize(Game* game_inst) {
     state->view = Mat4Translation(state->camera_position);
     state->view = Mat4Inverse(state->view);
     state->camera_view_dirty = true;
+
+    state->action_camera_yaw = InputActionRegister("camera_yaw", INPUT_ACTION_AXIS);
+    state->action_camera_pitch = InputActionRegister("camera_pitch", INPUT_ACTION_AXIS);
+    state->action_move_forward = InputActionRegister("move_forward", INPUT_ACTION_AXIS);
+    state->action_move_right = InputActionRegister("move_right", INPUT_ACTION_AXIS);
+    state->action_move_up = InputActionRegister("move_up", INPUT_ACTION_AXIS);
+    state->action_debug_allocations = InputActionRegister("debug_allocations", INPUT_ACTION_BUTTON);
+    if (!InputActionsLoadBindings(default_bindings)) {
+        DERROR("Failed to load the default input bindings.");
+        return false;
+    }
     return true;
 }
 
@@ -49,50 +77,28 @@ b8 GameUpdate(Game* game_inst, f32 delta_time) {
     u64 prev_alloc_count = alloc_count;
     alloc_count = GetMemoryAllocCount();
 
-    if (InputIsKeyUp(KEY_M) && InputWasKeyDown(KEY_M)) {
+    GameState* state = (GameState*)game_inst->state;
+    InputActionState* actions = InputActionsGetStates();
+
+    if (actions[state->action_debug_allocations].released) {
         DDEBUG("Allocations: %llu (%llu this frame)", alloc_count, alloc_count - prev_alloc_count);
     }
 
-    GameState* state = (GameState*)game_inst->state;
-
     //HACK: camera move
-    if (InputIsKeyDown(KEY_A) || InputIsKeyDown(KEY_LEFT)) {
-        CameraYaw(state, 1.0f * delta_time);
-    }
-    if (InputIsKeyDown(KEY_D) || InputIsKeyDown(KEY_RIGHT)) {
-        CameraYaw(state, -1.0f * delta_time);
+    f32 yaw = actions[state->action_camera_yaw].value;
+    if (yaw != 0.0f) {
+        CameraYaw(state, yaw * delta_time);
     }
-    if (InputIsKeyDown(KEY_UP)) {
-        CameraPitch(state, 1.0f * delta_time);
-    }
-    if (InputIsKeyDown(KEY_DOWN)) {
-        CameraPitch(state, -1.0f * delta_time);
+    f32 pitch = actions[state->action_camera_pitch].value;
+    if (pitch != 0.0f) {
+        CameraPitch(state, pitch * delta_time);
     }
 
     f32 temp_move_speed = 50.0f;
     Vec3 velocity = {};
-    if (InputIsKeyDown(KEY_W)) {
-        Vec3 forward = Mat4Forward(state->view);
-        velocity += forward;
-    }
-    if (InputIsKeyDown(KEY_S)) {
-        Vec3 backward = Mat4Backward(state->view);
-        velocity += backward;
-    }
-    if (InputIsKeyDown(KEY_Q)) {
-        Vec3 left = Mat4Left(state->view);
-        velocity += left;
-    }
-    if (InputIsKeyDown(KEY_E)) {
-        Vec3 right = Mat4Right(state->view);
-        velocity += right;
-    }
-    if (InputIsKeyDown(KEY_SPACE)) {
-        velocity.y += 1.0f;
-    }
-    if (InputIsKeyDown(KEY_X)) {
-        velocity.y -= 1.0f;
-    }
+    velocity += Mat4Forward(state->view) * actions[state->action_move_forward].value;
+    velocity += Mat4Right(state->view) * actions[state->action_move_right].value;
+    velocity.y += actions[state->action_move_up].value;
 
     Vec3 z = {};
     if (!Vec3Compare(z, velocity, 0.0002f)) {
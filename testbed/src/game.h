@@ -11,6 +11,13 @@ struct GameState{
     Vec3 camera_position;
     Vec3 camera_euler;
     b8 camera_view_dirty;
+
+    u16 action_camera_yaw;
+    u16 action_camera_pitch;
+    u16 action_move_forward;
+    u16 action_move_right;
+    u16 action_move_up;
+    u16 action_debug_allocations;
 };
 
 b8 GameInitialize(Game* game_inst);
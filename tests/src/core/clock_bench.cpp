@@ -0,0 +1,42 @@
+#include "clock_bench.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <core/clock.h>
+#include <core/logger.h>
+#include <core/dstring.h>
+#include <platform/platform.h>
+
+//Cost of taking one timestamp, ticks against the converted OS time instrumentation used before
+
+#define BENCH_CLOCK_SAMPLES 2000000
+
+u8 ClockBench_SampleCost(){
+    u64 sink = 0;
+    u64 start = ClockGetTicks();
+    for(u32 i = 0; i < BENCH_CLOCK_SAMPLES; i++){
+        sink += ClockGetTicks();
+    }
+    f64 tick_seconds = ClockTicksToSeconds(ClockGetTicks() - start);
+
+    f64 time_sink = 0;
+    start = ClockGetTicks();
+    for(u32 i = 0; i < BENCH_CLOCK_SAMPLES; i++){
+        time_sink += PlatformGetAbsoluteTime();
+    }
+    f64 os_seconds = ClockTicksToSeconds(ClockGetTicks() - start);
+
+    char tick_ns[STRING_NUMBER_MAX_LENGTH];
+    char os_ns[STRING_NUMBER_MAX_LENGTH];
+    StringFromF64Fixed(tick_ns, tick_seconds * 1000000000.0 / BENCH_CLOCK_SAMPLES, 1);
+    StringFromF64Fixed(os_ns, os_seconds * 1000000000.0 / BENCH_CLOCK_SAMPLES, 1);
+    DINFO("Timestamp cost (%s): ClockGetTicks %s ns, PlatformGetAbsoluteTime %s ns",
+          ClockTicksUseTsc() ? "TSC" : "OS counter", tick_ns, os_ns);
+    ExpectTrue(sink != 0 && time_sink != 0);
+    return true;
+}
+
+void ClockRegisterBenchmarks(){
+    RegisterTest(ClockBench_SampleCost, "ClockBench_SampleCost");
+}
@@ -0,0 +1,54 @@
+#include "clock_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <core/clock.h>
+#include <platform/platform.h>
+
+u8 Clock_TicksAgreeWithOsClock(){
+    ExpectTrue(ClockTicksPerSecond() > 0);
+    f64 os_start = PlatformGetAbsoluteTime();
+    u64 tick_start = ClockGetTicks();
+    PlatformSleep(30);
+    u64 tick_end = ClockGetTicks();
+    f64 os_elapsed = PlatformGetAbsoluteTime() - os_start;
+    f64 tick_elapsed = ClockTicksToSeconds(tick_end - tick_start);
+    ExpectTrue(tick_end > tick_start);
+    //calibration error is well under a percent, the rest is the two reads not being simultaneous
+    ExpectTrue(tick_elapsed > os_elapsed * 0.98 - 0.0001);
+    ExpectTrue(tick_elapsed < os_elapsed * 1.02 + 0.0001);
+    return true;
+}
+
+u8 Clock_TicksNeverGoBackwards(){
+    u64 previous = ClockGetTicks();
+    for(u32 i = 0; i < 100000; i++){
+        u64 now = ClockGetTicks();
+        ExpectTrue(now >= previous);
+        previous = now;
+    }
+    return true;
+}
+
+u8 Clock_MeasuresElapsedAndStops(){
+    Clock clock = {};
+    ClockUpdate(&clock);
+    ExpectFloatEquals(0.0f, (f32)clock.elapsed);
+    ClockStart(&clock);
+    PlatformSleep(5);
+    ClockUpdate(&clock);
+    ExpectTrue(clock.elapsed >= 0.004);
+    f64 stopped_at = clock.elapsed;
+    ClockStop(&clock);
+    PlatformSleep(2);
+    ClockUpdate(&clock);
+    ExpectFloatEquals((f32)stopped_at, (f32)clock.elapsed);
+    return true;
+}
+
+void ClockRegisterTests(){
+    RegisterTest(Clock_TicksAgreeWithOsClock, "Clock_TicksAgreeWithOsClock");
+    RegisterTest(Clock_TicksNeverGoBackwards, "Clock_TicksNeverGoBackwards");
+    RegisterTest(Clock_MeasuresElapsedAndStops, "Clock_MeasuresElapsedAndStops");
+}
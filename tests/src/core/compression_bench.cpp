@@ -0,0 +1,160 @@
+#include "compression_bench.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <core/compression.h>
+#include <core/clock.h>
+#include <core/dmemory.h>
+#include <core/dstring.h>
+#include <core/logger.h>
+#include <platform/filesystem.h>
+#include <platform/threading.h>
+
+#include <stdio.h>
+
+//Loading texture sized pixel data: plain FileSystemReadAllBytes against reading the compressed stream and
+//decoding it, and the codec on its own. The files were just written, so reads come from the OS file cache,
+//the case that favours the uncompressed path the most
+
+#define BENCH_RAW_PATH "compression_bench_raw.bin"
+#define BENCH_COMPRESSED_PATH "compression_bench_compressed.bin"
+#define BENCH_TEXTURE_WIDTH 2048
+#define BENCH_TEXTURE_HEIGHT 2048
+#define BENCH_REPEATS 5
+
+static b8 WriteBenchFile(char* path, void* data, u64 size){
+    FileHandle handle;
+    if(!FileSystemOpen(path, FILE_MODE_WRITE, true, &handle)){
+        return false;
+    }
+    u64 written = 0;
+    b8 result = FileSystemWrite(&handle, size, data, &written);
+    FileSystemClose(&handle);
+    return result;
+}
+
+//GB/s of texture content, whatever was actually read
+static void FormatRate(char* out, u64 bytes, f64 seconds){
+    StringFromF64Fixed(out, bytes / seconds / 1000000000.0, 2);
+}
+
+u8 CompressionBench_TextureLoad(){
+    u64 size = (u64)BENCH_TEXTURE_WIDTH * BENCH_TEXTURE_HEIGHT * 4;
+    u8* pixels = (u8*)DAllocate(size, MEMORY_TAG_TEXTURE);
+    //64x64 tiles of the kinds of content a painted texture has: flat color, smooth gradients, gradients with a
+    //bit of noise, and some detail that is noise all the way through and won't compress
+    u32 noise = 1;
+    for(u32 y = 0; y < BENCH_TEXTURE_HEIGHT; y++){
+        for(u32 x = 0; x < BENCH_TEXTURE_WIDTH; x++){
+            noise = noise * 1664525 + 1013904223;
+            u8* pixel = pixels + ((u64)y * BENCH_TEXTURE_WIDTH + x) * 4;
+            u32 kind = ((x / 64) * 7 + (y / 64) * 3) % 4;
+            if(kind == 0){
+                pixel[0] = (u8)(x / 64 * 16);
+                pixel[1] = (u8)(y / 64 * 16);
+                pixel[2] = 96;
+            } else if(kind == 1){
+                pixel[0] = (u8)(x / 4);
+                pixel[1] = (u8)(y / 4);
+                pixel[2] = (u8)((x + y) / 8);
+            } else if(kind == 2){
+                pixel[0] = (u8)(x / 4 + ((noise >> 29) & 1));
+                pixel[1] = (u8)(y / 4);
+                pixel[2] = (u8)((x + y) / 8);
+            } else {
+                pixel[0] = (u8)(noise >> 24);
+                pixel[1] = (u8)(noise >> 16);
+                pixel[2] = (u8)(noise >> 8);
+            }
+            pixel[3] = 255;
+        }
+    }
+    CpuTopology topology = {};
+    u32 threads = CpuGetTopology(&topology) ? topology.logical_cores : 1;
+
+    u64 capacity = CompressStreamBound(size);
+    u8* compressed = (u8*)DAllocate(capacity, MEMORY_TAG_ARRAY);
+    u8* out = (u8*)DAllocate(size, MEMORY_TAG_TEXTURE);
+    u64 compressed_size = 0;
+    Clock timer = {};
+    f64 compress_seconds = 1e9;
+    for(u32 i = 0; i < BENCH_REPEATS; i++){
+        ClockStart(&timer);
+        compressed_size = CompressStream(pixels, size, compressed, capacity, 1);
+        ClockUpdate(&timer);
+        compress_seconds = Minimum(compress_seconds, timer.elapsed);
+    }
+    ExpectTrue(compressed_size > 0);
+    ExpectTrue(WriteBenchFile(BENCH_RAW_PATH, pixels, size));
+    ExpectTrue(WriteBenchFile(BENCH_COMPRESSED_PATH, compressed, compressed_size));
+
+    f64 raw_seconds = 1e9;
+    f64 packed_seconds = 1e9;
+    f64 decode_seconds = 1e9;
+    f64 threaded_seconds = 1e9;
+    for(u32 i = 0; i < BENCH_REPEATS; i++){
+        FileHandle handle;
+        u8* bytes = 0;
+        u64 bytes_read = 0;
+        ExpectTrue(FileSystemOpen(BENCH_RAW_PATH, FILE_MODE_READ, true, &handle));
+        ClockStart(&timer);
+        ExpectTrue(FileSystemReadAllBytes(&handle, &bytes, &bytes_read));
+        ClockUpdate(&timer);
+        raw_seconds = Minimum(raw_seconds, timer.elapsed);
+        FileSystemClose(&handle);
+        ExpectIntEquals(size, bytes_read);
+        DFree(bytes, bytes_read, MEMORY_TAG_STRING);
+
+        ExpectTrue(FileSystemOpen(BENCH_COMPRESSED_PATH, FILE_MODE_READ, true, &handle));
+        ClockStart(&timer);
+        ExpectTrue(FileSystemReadAllBytes(&handle, &bytes, &bytes_read));
+        ExpectTrue(DecompressStream(bytes, bytes_read, out, size, 1));
+        ClockUpdate(&timer);
+        packed_seconds = Minimum(packed_seconds, timer.elapsed);
+        FileSystemClose(&handle);
+        DFree(bytes, bytes_read, MEMORY_TAG_STRING);
+
+        ClockStart(&timer);
+        ExpectTrue(DecompressStream(compressed, compressed_size, out, size, 1));
+        ClockUpdate(&timer);
+        decode_seconds = Minimum(decode_seconds, timer.elapsed);
+
+        ClockStart(&timer);
+        ExpectTrue(DecompressStream(compressed, compressed_size, out, size, threads));
+        ClockUpdate(&timer);
+        threaded_seconds = Minimum(threaded_seconds, timer.elapsed);
+    }
+    u32 mismatches = 0;
+    for(u64 i = 0; i < size; i++){
+        mismatches += out[i] != pixels[i];
+    }
+    ExpectIntEquals(0, mismatches);
+    remove(BENCH_RAW_PATH);
+    remove(BENCH_COMPRESSED_PATH);
+
+    char ratio[STRING_NUMBER_MAX_LENGTH];
+    char raw_rate[STRING_NUMBER_MAX_LENGTH];
+    char packed_rate[STRING_NUMBER_MAX_LENGTH];
+    char decode_rate[STRING_NUMBER_MAX_LENGTH];
+    char threaded_rate[STRING_NUMBER_MAX_LENGTH];
+    char compress_rate[STRING_NUMBER_MAX_LENGTH];
+    StringFromF64Fixed(ratio, (f64)compressed_size / size * 100.0, 1);
+    FormatRate(raw_rate, size, raw_seconds);
+    FormatRate(packed_rate, size, packed_seconds);
+    FormatRate(decode_rate, size, decode_seconds);
+    FormatRate(threaded_rate, size, threaded_seconds);
+    FormatRate(compress_rate, size, compress_seconds);
+    DINFO("%llu byte texture compressed to %s%%. ReadAllBytes %s GB/s, ReadAllBytes + decompress %s GB/s, "
+          "decompress %s GB/s on 1 thread, %s GB/s on %u, compress %s GB/s",
+          size, ratio, raw_rate, packed_rate, decode_rate, threaded_rate, threads, compress_rate);
+
+    DFree(pixels, size, MEMORY_TAG_TEXTURE);
+    DFree(compressed, capacity, MEMORY_TAG_ARRAY);
+    DFree(out, size, MEMORY_TAG_TEXTURE);
+    return true;
+}
+
+void CompressionRegisterBenchmarks(){
+    RegisterTest(CompressionBench_TextureLoad, "CompressionBench_TextureLoad");
+}
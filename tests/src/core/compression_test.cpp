@@ -0,0 +1,206 @@
+#include "compression_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <core/compression.h>
+#include <core/dmemory.h>
+#include <core/logger.h>
+
+#define COMPRESSION_TEST_SIZE (KiloBytes(64) * 5 + 1234)
+
+static u32 test_random_state = 12345;
+
+static u32 TestRandom(){
+    test_random_state = test_random_state * 1664525 + 1013904223;
+    return test_random_state >> 8;
+}
+
+//Image like data: runs of one color, gradients, and some noise
+static void FillCompressible(u8* data, u64 size){
+    for(u64 i = 0; i < size; i++){
+        u64 region = (i / 4096) % 3;
+        if(region == 0){
+            data[i] = (u8)(i % 4 == 3 ? 255 : 40);
+        } else if(region == 1){
+            data[i] = (u8)(i / 64);
+        } else {
+            data[i] = (u8)(TestRandom() & 7);
+        }
+    }
+}
+
+static b8 BlockRoundTrips(u8* data, u64 size){
+    u64 capacity = CompressBlockBound(size);
+    u8* compressed = (u8*)DAllocate(capacity, MEMORY_TAG_ARRAY);
+    u8* decompressed = (u8*)DAllocate(size + 1, MEMORY_TAG_ARRAY);
+    u64 compressed_size = CompressBlock(data, size, compressed, capacity);
+    b8 result = compressed_size != 0 && DecompressBlock(compressed, compressed_size, decompressed, size);
+    for(u64 i = 0; i < size && result; i++){
+        result = decompressed[i] == data[i];
+    }
+    DFree(compressed, capacity, MEMORY_TAG_ARRAY);
+    DFree(decompressed, size + 1, MEMORY_TAG_ARRAY);
+    return result;
+}
+
+u8 Compression_BlockRoundTripsAllKindsOfData(){
+    static u8 data[KiloBytes(64)];
+    //shorter than the smallest match the format allows
+    data[0] = 'a';
+    ExpectTrue(BlockRoundTrips(data, 0));
+    ExpectTrue(BlockRoundTrips(data, 1));
+    for(u32 i = 0; i < 12; i++){
+        data[i] = 'x';
+    }
+    ExpectTrue(BlockRoundTrips(data, 12));
+
+    //one byte repeated, every match overlaps itself by all but one byte
+    for(u32 i = 0; i < sizeof(data); i++){
+        data[i] = 7;
+    }
+    ExpectTrue(BlockRoundTrips(data, sizeof(data)));
+    //a destination too small for it is refused
+    u8 tiny[8];
+    u64 compressed_size = CompressBlock(data, sizeof(data), tiny, sizeof(tiny));
+    ExpectIntEquals(0, compressed_size);
+
+    //short periods, each hits the overlapping copy differently
+    for(u32 period = 2; period <= 9; period++){
+        for(u32 i = 0; i < 1000; i++){
+            data[i] = (u8)(i % period);
+        }
+        ExpectTrue(BlockRoundTrips(data, 1000));
+    }
+
+    FillCompressible(data, sizeof(data));
+    ExpectTrue(BlockRoundTrips(data, sizeof(data)));
+
+    for(u32 i = 0; i < sizeof(data); i++){
+        data[i] = (u8)TestRandom();
+    }
+    ExpectTrue(BlockRoundTrips(data, sizeof(data)));
+    return true;
+}
+
+u8 Compression_DecodesReferenceBlockAndRejectsCorruptOnes(){
+    //written by hand to the LZ4 block format: literals "abc", a match 3 back for 6, then the 5 final literals
+    u8 block[] = {0x32, 'a', 'b', 'c', 0x03, 0x00, 0x50, 'x', 'y', 'z', 'z', 'y'};
+    char expected[] = "abcabcabcxyzzy";
+    char out[32];
+    ExpectTrue(DecompressBlock(block, sizeof(block), out, 14));
+    for(u32 i = 0; i < 14; i++){
+        ExpectIntEquals(expected[i], out[i]);
+    }
+
+    //wrong size either way
+    ExpectFalse(DecompressBlock(block, sizeof(block), out, 13));
+    ExpectFalse(DecompressBlock(block, sizeof(block), out, 15));
+    //cut off in the middle
+    ExpectFalse(DecompressBlock(block, 5, out, 14));
+    //an offset reaching back before the start of the output
+    block[4] = 0x04;
+    ExpectFalse(DecompressBlock(block, sizeof(block), out, 14));
+    block[4] = 0x00;
+    ExpectFalse(DecompressBlock(block, sizeof(block), out, 14));
+    return true;
+}
+
+u8 Compression_StreamMatchesAcrossThreadCounts(){
+    u8* data = (u8*)DAllocate(COMPRESSION_TEST_SIZE, MEMORY_TAG_ARRAY);
+    FillCompressible(data, COMPRESSION_TEST_SIZE);
+    //an incompressible block in the middle gets stored as is
+    for(u64 i = KiloBytes(64) * 2; i < KiloBytes(64) * 3; i++){
+        data[i] = (u8)TestRandom();
+    }
+    u64 capacity = CompressStreamBound(COMPRESSION_TEST_SIZE);
+    u8* single = (u8*)DAllocate(capacity, MEMORY_TAG_ARRAY);
+    u8* threaded = (u8*)DAllocate(capacity, MEMORY_TAG_ARRAY);
+    u8* out = (u8*)DAllocate(COMPRESSION_TEST_SIZE, MEMORY_TAG_ARRAY);
+
+    u64 single_size = CompressStream(data, COMPRESSION_TEST_SIZE, single, capacity, 1);
+    u64 threaded_size = CompressStream(data, COMPRESSION_TEST_SIZE, threaded, capacity, 4);
+    ExpectTrue(single_size > 0);
+    ExpectTrue(single_size < COMPRESSION_TEST_SIZE);
+    //blocks are independent, so the thread count can't change the output
+    ExpectIntEquals(single_size, threaded_size);
+    u32 mismatches = 0;
+    for(u64 i = 0; i < single_size; i++){
+        mismatches += single[i] != threaded[i];
+    }
+    ExpectIntEquals(0, mismatches);
+    ExpectIntEquals(COMPRESSION_TEST_SIZE, CompressStreamContentSize(single, single_size));
+
+    for(u32 threads = 1; threads <= 3; threads++){
+        DZeroMemory(out, COMPRESSION_TEST_SIZE);
+        ExpectTrue(DecompressStream(single, single_size, out, COMPRESSION_TEST_SIZE, threads));
+        for(u64 i = 0; i < COMPRESSION_TEST_SIZE; i++){
+            mismatches += out[i] != data[i];
+        }
+        ExpectIntEquals(0, mismatches);
+    }
+
+    DDEBUG("Note: The following error is intentionally caused by this test.");
+    ExpectFalse(DecompressStream(single, single_size - 1, out, COMPRESSION_TEST_SIZE, 2));
+    DDEBUG("Note: The following error is intentionally caused by this test.");
+    ExpectFalse(DecompressStream(data, single_size, out, COMPRESSION_TEST_SIZE, 1));
+
+    //too small a destination is refused rather than overrun
+    DDEBUG("Note: The following error is intentionally caused by this test.");
+    ExpectIntEquals(0, CompressStream(data, COMPRESSION_TEST_SIZE, single, capacity - 1, 1));
+
+    DFree(data, COMPRESSION_TEST_SIZE, MEMORY_TAG_ARRAY);
+    DFree(single, capacity, MEMORY_TAG_ARRAY);
+    DFree(threaded, capacity, MEMORY_TAG_ARRAY);
+    DFree(out, COMPRESSION_TEST_SIZE, MEMORY_TAG_ARRAY);
+    return true;
+}
+
+u8 Compression_StreamDecodesIncrementally(){
+    u8* data = (u8*)DAllocate(COMPRESSION_TEST_SIZE, MEMORY_TAG_ARRAY);
+    FillCompressible(data, COMPRESSION_TEST_SIZE);
+    u64 capacity = CompressStreamBound(COMPRESSION_TEST_SIZE);
+    u8* compressed = (u8*)DAllocate(capacity, MEMORY_TAG_ARRAY);
+    u64 compressed_size = CompressStream(data, COMPRESSION_TEST_SIZE, compressed, capacity, 1);
+
+    //the stream arrives a piece at a time, and is decoded through a staging buffer of two blocks
+    static u8 staging[KiloBytes(64) * 2];
+    DecompressStreamState state;
+    ExpectTrue(DecompressStreamBegin(compressed, 100, &state));
+    ExpectIntEquals(COMPRESSION_TEST_SIZE, state.content_size);
+    u64 arrived = 100;
+    u64 produced = 0;
+    u32 mismatches = 0;
+    u32 calls = 0;
+    while(state.produced < state.content_size){
+        u64 written = 0;
+        ExpectTrue(DecompressStreamNext(&state, staging, sizeof(staging), &written));
+        for(u64 i = 0; i < written; i++){
+            mismatches += staging[i] != data[produced + i];
+        }
+        produced += written;
+        arrived = arrived + 7000 < compressed_size ? arrived + 7000 : compressed_size;
+        state.source_size = arrived;
+        calls++;
+        ExpectTrue(calls < 1000);
+    }
+    ExpectIntEquals(0, mismatches);
+    ExpectIntEquals(COMPRESSION_TEST_SIZE, produced);
+
+    //a staging buffer too small for a block makes no progress but isn't an error
+    ExpectTrue(DecompressStreamBegin(compressed, compressed_size, &state));
+    u64 written = 1;
+    ExpectTrue(DecompressStreamNext(&state, staging, 100, &written));
+    ExpectIntEquals(0, written);
+
+    DFree(data, COMPRESSION_TEST_SIZE, MEMORY_TAG_ARRAY);
+    DFree(compressed, capacity, MEMORY_TAG_ARRAY);
+    return true;
+}
+
+void CompressionRegisterTests(){
+    RegisterTest(Compression_BlockRoundTripsAllKindsOfData, "Compression_BlockRoundTripsAllKindsOfData");
+    RegisterTest(Compression_DecodesReferenceBlockAndRejectsCorruptOnes, "Compression_DecodesReferenceBlockAndRejectsCorruptOnes");
+    RegisterTest(Compression_StreamMatchesAcrossThreadCounts, "Compression_StreamMatchesAcrossThreadCounts");
+    RegisterTest(Compression_StreamDecodesIncrementally, "Compression_StreamDecodesIncrementally");
+}
@@ -0,0 +1,128 @@
+#include "dstring_bench.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <core/dstring.h>
+#include <core/dmemory.h>
+#include <core/clock.h>
+#include <core/logger.h>
+
+#include <string.h>
+
+//Compares the dstring scanning routines against the closest libc call over a few megabytes of OBJ-like text.
+//The length and compare calls are libc themselves, so only the routines with their own scans are here
+
+#define BENCH_TEXT_SIZE MegaBytes(16)
+#define BENCH_REPEATS 4
+
+static char* GenerateText(u64 size){
+    char* text = (char*)DAllocate(size + 1, MEMORY_TAG_STRING);
+    u64 seed = 12345;
+    u64 offset = 0;
+    while(offset + 64 < size){
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        u32 r = (u32)(seed >> 33);
+        StringBuilder line;
+        StringBuilderCreateFromBuffer(text + offset, size - offset, &line);
+        StringBuilderAppend(&line, (r & 3) ? "v " : "f ");
+        StringBuilderAppendF64Fixed(&line, (r % 20000) / 1000.0, 6);
+        StringBuilderAppendChar(&line, ' ');
+        StringBuilderAppendF64Fixed(&line, (r % 7919) / 100.0, 6);
+        StringBuilderAppendChar(&line, ' ');
+        StringBuilderAppendU64(&line, r % 100000);
+        StringBuilderAppendChar(&line, '\n');
+        offset += line.length;
+    }
+    DSetMemory(text + offset, 'x', size - offset);
+    text[size] = 0;
+    //one untimed pass so neither side pays for the first touch of the buffer
+    volatile u64 warm = strlen(text);
+    (void)warm;
+    return text;
+}
+
+static void ReportThroughput(char* name, u64 bytes, f64 seconds){
+    char rate[STRING_NUMBER_MAX_LENGTH];
+    StringFromF64Fixed(rate, seconds > 0 ? (bytes / (f64)MegaBytes(1)) / seconds : 0, 1);
+    DINFO("  %s: %s MB/s", name, rate);
+}
+
+u8 StringBench_SplitLines(){
+    char* text = GenerateText(BENCH_TEXT_SIZE);
+    u64 lines_engine = 0;
+    u64 lines_libc = 0;
+
+    Clock timer = {};
+    ClockStart(&timer);
+    for(u32 i = 0; i < BENCH_REPEATS; i++){
+        StringView remaining = StringViewCreate(text, BENCH_TEXT_SIZE);
+        StringView line;
+        while(StringSplitNextLine(&remaining, &line)){
+            lines_engine++;
+        }
+    }
+    ClockUpdate(&timer);
+    f64 engine_seconds = timer.elapsed;
+
+    ClockStart(&timer);
+    for(u32 i = 0; i < BENCH_REPEATS; i++){
+        char* p = text;
+        char* end = text + BENCH_TEXT_SIZE;
+        while(p < end){
+            char* newline = (char*)memchr(p, '\n', end - p);
+            lines_libc++;
+            p = newline ? newline + 1 : end;
+        }
+    }
+    ClockUpdate(&timer);
+
+    ReportThroughput("StringSplitNextLine", BENCH_TEXT_SIZE * BENCH_REPEATS, engine_seconds);
+    ReportThroughput("memchr lines       ", BENCH_TEXT_SIZE * BENCH_REPEATS, timer.elapsed);
+    DFree(text, BENCH_TEXT_SIZE + 1, MEMORY_TAG_STRING);
+    ExpectIntEquals(lines_libc, lines_engine);
+    return true;
+}
+
+u8 StringBench_SplitWhitespace(){
+    char* text = GenerateText(BENCH_TEXT_SIZE);
+    u64 tokens_engine = 0;
+    u64 tokens_libc = 0;
+
+    Clock timer = {};
+    ClockStart(&timer);
+    for(u32 i = 0; i < BENCH_REPEATS; i++){
+        StringView remaining = StringViewCreate(text, BENCH_TEXT_SIZE);
+        StringView token;
+        while(StringSplitNextWhitespace(&remaining, &token)){
+            tokens_engine++;
+        }
+    }
+    ClockUpdate(&timer);
+    f64 engine_seconds = timer.elapsed;
+
+    ClockStart(&timer);
+    for(u32 i = 0; i < BENCH_REPEATS; i++){
+        char* p = text;
+        for(;;){
+            p += strspn(p, " \t\r\n\v\f");
+            if(!*p){
+                break;
+            }
+            p += strcspn(p, " \t\r\n\v\f");
+            tokens_libc++;
+        }
+    }
+    ClockUpdate(&timer);
+
+    ReportThroughput("StringSplitNextWhitespace", BENCH_TEXT_SIZE * BENCH_REPEATS, engine_seconds);
+    ReportThroughput("strspn/strcspn tokens    ", BENCH_TEXT_SIZE * BENCH_REPEATS, timer.elapsed);
+    DFree(text, BENCH_TEXT_SIZE + 1, MEMORY_TAG_STRING);
+    ExpectIntEquals(tokens_libc, tokens_engine);
+    return true;
+}
+
+void StringRegisterBenchmarks(){
+    RegisterTest(StringBench_SplitLines, "StringBench_SplitLines");
+    RegisterTest(StringBench_SplitWhitespace, "StringBench_SplitWhitespace");
+}
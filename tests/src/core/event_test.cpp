@@ -0,0 +1,553 @@
+#include "event_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <core/event.h>
+#include <core/dmemory.h>
+#include <core/logger.h>
+
+#include <chrono>
+#include <thread>
+
+#define TEST_EVENT_CODE_A 0x100
+#define TEST_EVENT_CODE_B 0x101
+
+struct EventRecorder{
+    u32 count;
+    u16 codes[32];
+    i32 values[32];
+    b8 consume;
+};
+
+static void* event_test_state;
+static u64 event_test_state_size;
+
+static void StartEventSystem(){
+    EventSystemInitialize(&event_test_state_size, 0);
+    event_test_state = DAllocate(event_test_state_size, MEMORY_TAG_APPLICATION);
+    EventSystemInitialize(&event_test_state_size, event_test_state);
+}
+
+static void StopEventSystem(){
+    EventSystemShutdown(event_test_state);
+    DFree(event_test_state, event_test_state_size, MEMORY_TAG_APPLICATION);
+    event_test_state = 0;
+}
+
+static b8 RecordEvent(u16 code, void* sender, void* listener_inst, EventContext context){
+    EventRecorder* recorder = (EventRecorder*)listener_inst;
+    if(recorder->count < 32){
+        recorder->codes[recorder->count] = code;
+        recorder->values[recorder->count] = context.data.i32[0];
+    }
+    recorder->count++;
+    return recorder->consume;
+}
+
+//Posts a follow up event from inside dispatch, which has to wait for the next dispatch
+static b8 PostFromListener(u16 code, void* sender, void* listener_inst, EventContext context){
+    EventContext follow_up = {};
+    follow_up.data.i32[0] = context.data.i32[0] + 100;
+    EventPost(TEST_EVENT_CODE_B, 0, follow_up);
+    return false;
+}
+
+u8 Event_PostIsDeferredUntilDispatch(){
+    StartEventSystem();
+    EventRecorder recorder = {};
+    EventRegister(TEST_EVENT_CODE_A, &recorder, RecordEvent, EVENT_PRIORITY_NORMAL);
+
+    EventContext context = {};
+    for(i32 i = 0; i < 3; i++){
+        context.data.i32[0] = i;
+        EventPost(TEST_EVENT_CODE_A, 0, context);
+    }
+    ExpectIntEquals(0, recorder.count);
+
+    ExpectIntEquals(3, EventDispatchQueued());
+    ExpectIntEquals(3, recorder.count);
+    ExpectIntEquals(0, recorder.values[0]);
+    ExpectIntEquals(2, recorder.values[2]);
+
+    ExpectIntEquals(0, EventDispatchQueued());
+    StopEventSystem();
+    return true;
+}
+
+u8 Event_PostFromListenerWaitsAFrame(){
+    StartEventSystem();
+    EventRecorder recorder = {};
+    EventRegister(TEST_EVENT_CODE_A, 0, PostFromListener, EVENT_PRIORITY_NORMAL);
+    EventRegister(TEST_EVENT_CODE_B, &recorder, RecordEvent, EVENT_PRIORITY_NORMAL);
+
+    EventContext context = {};
+    context.data.i32[0] = 7;
+    EventPost(TEST_EVENT_CODE_A, 0, context);
+    ExpectIntEquals(1, EventDispatchQueued());
+    ExpectIntEquals(0, recorder.count);
+
+    ExpectIntEquals(1, EventDispatchQueued());
+    ExpectIntEquals(1, recorder.count);
+    ExpectIntEquals(107, recorder.values[0]);
+    StopEventSystem();
+    return true;
+}
+
+u8 Event_CoalescePoliciesMergeQueuedPosts(){
+    StartEventSystem();
+    EventRecorder latest = {};
+    EventRecorder summed = {};
+    EventRecorder all = {};
+    EventRegister(TEST_EVENT_CODE_A, &latest, RecordEvent, EVENT_PRIORITY_NORMAL);
+    EventRegister(TEST_EVENT_CODE_B, &summed, RecordEvent, EVENT_PRIORITY_NORMAL);
+    EventRegister(EVENT_CODE_KEY_PRESSED, &all, RecordEvent, EVENT_PRIORITY_NORMAL);
+    EventSetCoalescePolicy(TEST_EVENT_CODE_A, EVENT_COALESCE_LATEST);
+    EventSetCoalescePolicy(TEST_EVENT_CODE_B, EVENT_COALESCE_ACCUMULATE);
+
+    EventContext context = {};
+    for(i32 i = 1; i <= 4; i++){
+        context.data.i32[0] = i;
+        EventPost(TEST_EVENT_CODE_A, 0, context);
+        EventPost(TEST_EVENT_CODE_B, 0, context);
+        EventPost(EVENT_CODE_KEY_PRESSED, 0, context);
+    }
+    ExpectIntEquals(6, EventDispatchQueued());
+    ExpectIntEquals(1, latest.count);
+    ExpectIntEquals(4, latest.values[0]);
+    ExpectIntEquals(1, summed.count);
+    ExpectIntEquals(10, summed.values[0]);
+    ExpectIntEquals(4, all.count);
+
+    //merging only spans a single frame's queue
+    context.data.i32[0] = -3;
+    EventPost(TEST_EVENT_CODE_B, 0, context);
+    ExpectIntEquals(1, EventDispatchQueued());
+    ExpectIntEquals(2, summed.count);
+    ExpectIntEquals(-3, summed.values[1]);
+    StopEventSystem();
+    return true;
+}
+
+static b8 UnregisterSelf(u16 code, void* sender, void* listener_inst, EventContext context){
+    EventRecorder* recorder = (EventRecorder*)listener_inst;
+    recorder->count++;
+    EventUnregister(code, listener_inst, UnregisterSelf);
+    return false;
+}
+
+u8 Event_RegistrationTableGrowsAndRemovesInOrder(){
+    StartEventSystem();
+    //enough codes and listeners to force table growth and range relocation inside the pool
+    EventRecorder recorders[8] = {};
+    for(u16 code = 0x100; code < 0x100 + 200; code++){
+        for(u32 i = 0; i < 8; i++){
+            ExpectTrue(EventRegister(code, &recorders[i], RecordEvent, EVENT_PRIORITY_NORMAL));
+        }
+    }
+    DDEBUG("Note: The following warning is intentionally caused by this test.");
+    ExpectFalse(EventRegister(0x100, &recorders[3], RecordEvent, EVENT_PRIORITY_NORMAL));
+
+    EventContext context = {};
+    for(u16 code = 0x100; code < 0x100 + 200; code++){
+        EventFire(code, 0, context);
+    }
+    for(u32 i = 0; i < 8; i++){
+        ExpectIntEquals(200, recorders[i].count);
+    }
+
+    ExpectTrue(EventUnregister(0x150, &recorders[0], RecordEvent));
+    ExpectFalse(EventUnregister(0x150, &recorders[0], RecordEvent));
+    ExpectTrue(EventUnregister(0x150, &recorders[5], RecordEvent));
+    EventFire(0x150, 0, context);
+    ExpectIntEquals(200, recorders[0].count);
+    ExpectIntEquals(200, recorders[5].count);
+    ExpectIntEquals(201, recorders[7].count);
+    //removal shifts instead of swapping, so the survivors still run in registration order
+    recorders[1].consume = true;
+    EventFire(0x150, 0, context);
+    ExpectIntEquals(202, recorders[1].count);
+    ExpectIntEquals(201, recorders[2].count);
+    ExpectIntEquals(201, recorders[7].count);
+    StopEventSystem();
+    return true;
+}
+
+u8 Event_UnregisterDuringFireReachesEveryone(){
+    StartEventSystem();
+    EventRecorder self_removing[4] = {};
+    EventRecorder stays = {};
+    for(u32 i = 0; i < 4; i++){
+        EventRegister(TEST_EVENT_CODE_A, &self_removing[i], UnregisterSelf, EVENT_PRIORITY_NORMAL);
+    }
+    EventRegister(TEST_EVENT_CODE_A, &stays, RecordEvent, EVENT_PRIORITY_NORMAL);
+
+    EventContext context = {};
+    EventFire(TEST_EVENT_CODE_A, 0, context);
+    for(u32 i = 0; i < 4; i++){
+        ExpectIntEquals(1, self_removing[i].count);
+    }
+    ExpectIntEquals(1, stays.count);
+
+    EventFire(TEST_EVENT_CODE_A, 0, context);
+    ExpectIntEquals(1, self_removing[0].count);
+    ExpectIntEquals(2, stays.count);
+    StopEventSystem();
+    return true;
+}
+
+#define WORKER_THREAD_COUNT 4
+#define WORKER_POST_COUNT 50
+
+static void PostFromWorker(i32 worker){
+    EventContext context = {};
+    for(i32 i = 0; i < WORKER_POST_COUNT; i++){
+        context.data.i32[0] = worker * 1000 + i;
+        EventPost(TEST_EVENT_CODE_A, 0, context);
+    }
+}
+
+static b8 SumValues(u16 code, void* sender, void* listener_inst, EventContext context){
+    i64* sum = (i64*)listener_inst;
+    __atomic_add_fetch(sum, context.data.i32[0], __ATOMIC_RELAXED);
+    return false;
+}
+
+u8 Event_PostFromWorkerThreadsDrainsOnDispatch(){
+    StartEventSystem();
+    i64 sum = 0;
+    EventRegister(TEST_EVENT_CODE_A, &sum, SumValues, EVENT_PRIORITY_NORMAL);
+
+    std::thread workers[WORKER_THREAD_COUNT];
+    for(i32 i = 0; i < WORKER_THREAD_COUNT; i++){
+        workers[i] = std::thread(PostFromWorker, i);
+    }
+    for(i32 i = 0; i < WORKER_THREAD_COUNT; i++){
+        workers[i].join();
+    }
+    ExpectIntEquals(0, sum);
+
+    i64 expected = 0;
+    for(i32 worker = 0; worker < WORKER_THREAD_COUNT; worker++){
+        for(i32 i = 0; i < WORKER_POST_COUNT; i++){
+            expected += worker * 1000 + i;
+        }
+    }
+    ExpectIntEquals(WORKER_THREAD_COUNT * WORKER_POST_COUNT, EventDispatchQueued());
+    ExpectIntEquals(expected, sum);
+    StopEventSystem();
+    return true;
+}
+
+static void FireFromWorker(u32* stop){
+    EventContext context = {};
+    context.data.i32[0] = 1;
+    while(!__atomic_load_n(stop, __ATOMIC_ACQUIRE)){
+        EventFire(TEST_EVENT_CODE_A, 0, context);
+    }
+}
+
+u8 Event_FireFromWorkersWhileRegistering(){
+    StartEventSystem();
+    i64 sum = 0;
+    EventRegister(TEST_EVENT_CODE_A, &sum, SumValues, EVENT_PRIORITY_NORMAL);
+
+    u32 stop = 0;
+    std::thread workers[WORKER_THREAD_COUNT];
+    for(i32 i = 0; i < WORKER_THREAD_COUNT; i++){
+        workers[i] = std::thread(FireFromWorker, &stop);
+    }
+    while(!__atomic_load_n(&sum, __ATOMIC_ACQUIRE)){
+        std::this_thread::yield();
+    }
+    //keep growing the table and moving ranges around underneath the workers
+    EventRecorder recorders[4] = {};
+    for(u16 code = 0x200; code < 0x200 + 300; code++){
+        for(u32 i = 0; i < 4; i++){
+            EventRegister(code, &recorders[i], RecordEvent, EVENT_PRIORITY_NORMAL);
+        }
+        EventRegister(TEST_EVENT_CODE_A, &recorders[code & 3], RecordEvent, EVENT_PRIORITY_NORMAL);
+        EventUnregister(TEST_EVENT_CODE_A, &recorders[code & 3], RecordEvent);
+        EventDispatchQueued();
+    }
+    __atomic_store_n(&stop, 1, __ATOMIC_RELEASE);
+    for(i32 i = 0; i < WORKER_THREAD_COUNT; i++){
+        workers[i].join();
+    }
+
+    i64 fired = __atomic_load_n(&sum, __ATOMIC_ACQUIRE);
+    EventContext context = {};
+    context.data.i32[0] = 1;
+    EventFire(TEST_EVENT_CODE_A, 0, context);
+    ExpectIntEquals(fired + 1, sum);
+    StopEventSystem();
+    return true;
+}
+
+struct SlowListener{
+    u32 entered;
+    u32 finished;
+};
+
+static b8 SlowCallback(u16 code, void* sender, void* listener_inst, EventContext context){
+    SlowListener* listener = (SlowListener*)listener_inst;
+    __atomic_add_fetch(&listener->entered, 1, __ATOMIC_SEQ_CST);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    __atomic_add_fetch(&listener->finished, 1, __ATOMIC_SEQ_CST);
+    return false;
+}
+
+static void FireOnce(){
+    EventContext context = {};
+    EventFire(TEST_EVENT_CODE_A, 0, context);
+}
+
+u8 Event_UnregisterWaitsForFiresOnOtherThreads(){
+    StartEventSystem();
+    SlowListener listener = {};
+    EventRegister(TEST_EVENT_CODE_A, &listener, SlowCallback, EVENT_PRIORITY_NORMAL);
+    std::thread worker(FireOnce);
+    while(!__atomic_load_n(&listener.entered, __ATOMIC_SEQ_CST)){
+        std::this_thread::yield();
+    }
+    //the callback is still sleeping on the worker, unregistering has to wait it out
+    ExpectTrue(EventUnregister(TEST_EVENT_CODE_A, &listener, SlowCallback));
+    ExpectIntEquals(1, __atomic_load_n(&listener.finished, __ATOMIC_SEQ_CST));
+    worker.join();
+
+    std::thread late_worker(FireOnce);
+    late_worker.join();
+    ExpectIntEquals(1, listener.entered);
+    StopEventSystem();
+    return true;
+}
+
+#define MANY_LISTENER_COUNT 80
+
+struct CountingListener{
+    u32 calls;
+    //set on one listener, which holds the fire until the main thread releases it
+    u32* reached;
+    u32* release;
+};
+
+static b8 CountCall(u16 code, void* sender, void* listener_inst, EventContext context){
+    CountingListener* listener = (CountingListener*)listener_inst;
+    listener->calls++;
+    if(listener->reached){
+        __atomic_store_n(listener->reached, 1, __ATOMIC_SEQ_CST);
+        while(!__atomic_load_n(listener->release, __ATOMIC_SEQ_CST)){
+            std::this_thread::yield();
+        }
+    }
+    return false;
+}
+
+u8 Event_FireFromWorkerReachesEveryListener(){
+    StartEventSystem();
+    CountingListener listeners[MANY_LISTENER_COUNT] = {};
+    for(u32 i = 0; i < MANY_LISTENER_COUNT; i++){
+        EventRegister(TEST_EVENT_CODE_A, &listeners[i], CountCall, EVENT_PRIORITY_NORMAL);
+    }
+    //blanked but not yet swept, they must not take up room in a copied chunk
+    for(u32 i = 0; i < MANY_LISTENER_COUNT; i += 4){
+        EventUnregister(TEST_EVENT_CODE_A, &listeners[i], CountCall);
+    }
+    std::thread worker(FireOnce);
+    worker.join();
+    for(u32 i = 0; i < MANY_LISTENER_COUNT; i++){
+        u32 expected = i % 4 ? 1 : 0;
+        ExpectIntEquals(expected, listeners[i].calls);
+        listeners[i].calls = 0;
+    }
+
+    //a registration between chunks shifts the range, the fire carries on after the last listener it called
+    u32 reached = 0;
+    u32 release = 0;
+    u32 last_of_first_chunk = 42; //the 32nd live listener
+    listeners[last_of_first_chunk].reached = &reached;
+    listeners[last_of_first_chunk].release = &release;
+    CountingListener front = {};
+    std::thread held_worker(FireOnce);
+    while(!__atomic_load_n(&reached, __ATOMIC_SEQ_CST)){
+        std::this_thread::yield();
+    }
+    EventRegister(TEST_EVENT_CODE_A, &front, CountCall, EVENT_PRIORITY_HIGH);
+    __atomic_store_n(&release, 1, __ATOMIC_SEQ_CST);
+    held_worker.join();
+    ExpectIntEquals(0, front.calls);
+    for(u32 i = 0; i < MANY_LISTENER_COUNT; i++){
+        u32 expected = i % 4 ? 1 : 0;
+        ExpectIntEquals(expected, listeners[i].calls);
+    }
+    StopEventSystem();
+    return true;
+}
+
+struct PriorityLog{
+    u32 count;
+    i32 order[8];
+};
+
+struct PriorityListener{
+    PriorityLog* log;
+    i32 id;
+    b8 consume;
+};
+
+static b8 LogPriority(u16 code, void* sender, void* listener_inst, EventContext context){
+    PriorityListener* listener = (PriorityListener*)listener_inst;
+    listener->log->order[listener->log->count++] = listener->id;
+    return listener->consume;
+}
+
+u8 Event_ListenersRunInPriorityOrder(){
+    StartEventSystem();
+    PriorityLog log = {};
+    PriorityListener gameplay = {&log, 1, false};
+    PriorityListener late = {&log, 2, false};
+    PriorityListener ui = {&log, 3, false};
+    PriorityListener gameplay_second = {&log, 4, false};
+    EventRegister(TEST_EVENT_CODE_A, &gameplay, LogPriority, EVENT_PRIORITY_NORMAL);
+    EventRegister(TEST_EVENT_CODE_A, &late, LogPriority, EVENT_PRIORITY_LOW);
+    EventRegister(TEST_EVENT_CODE_A, &ui, LogPriority, EVENT_PRIORITY_UI);
+    EventRegister(TEST_EVENT_CODE_A, &gameplay_second, LogPriority, EVENT_PRIORITY_NORMAL);
+
+    EventContext context = {};
+    EventFire(TEST_EVENT_CODE_A, 0, context);
+    ExpectIntEquals(4, log.count);
+    ExpectIntEquals(3, log.order[0]);
+    ExpectIntEquals(1, log.order[1]);
+    ExpectIntEquals(4, log.order[2]);
+    ExpectIntEquals(2, log.order[3]);
+
+    //ui consuming means gameplay never sees it, and unregistering keeps the order of the rest
+    ui.consume = true;
+    log.count = 0;
+    ExpectTrue(EventFire(TEST_EVENT_CODE_A, 0, context));
+    ExpectIntEquals(1, log.count);
+
+    EventUnregister(TEST_EVENT_CODE_A, &ui, LogPriority);
+    EventUnregister(TEST_EVENT_CODE_A, &gameplay, LogPriority);
+    EventDispatchQueued();
+    EventRegister(TEST_EVENT_CODE_A, &gameplay, LogPriority, EVENT_PRIORITY_HIGH);
+    log.count = 0;
+    EventFire(TEST_EVENT_CODE_A, 0, context);
+    ExpectIntEquals(3, log.count);
+    ExpectIntEquals(1, log.order[0]);
+    ExpectIntEquals(4, log.order[1]);
+    ExpectIntEquals(2, log.order[2]);
+    StopEventSystem();
+    return true;
+}
+
+#define TEST_PAYLOAD_TYPE 7
+
+struct TestPayload{
+    char path[200];
+    u64 bytes;
+};
+
+static b8 ReadPayload(u16 code, void* sender, void* listener_inst, EventContext context){
+    TestPayload* payload = EventPayloadGet(context, TestPayload, TEST_PAYLOAD_TYPE);
+    TestPayload** seen = (TestPayload**)listener_inst;
+    *seen = payload;
+    return false;
+}
+
+u8 Event_PayloadsLiveInTheFrameArena(){
+    StartEventSystem();
+    TestPayload* seen = 0;
+    EventRegister(TEST_EVENT_CODE_A, &seen, ReadPayload, EVENT_PRIORITY_NORMAL);
+
+    EventContext context = {};
+    TestPayload* payload = (TestPayload*)EventPayloadAllocate(sizeof(TestPayload), TEST_PAYLOAD_TYPE, &context);
+    ExpectTrue(payload != 0);
+    ExpectIntEquals(0, (u64)payload & 15);
+    ExpectIntEquals(sizeof(TestPayload), context.data.payload.size);
+    payload->bytes = 4096;
+    EventPost(TEST_EVENT_CODE_A, 0, context);
+    EventDispatchQueued();
+    //listener got the sender's memory itself, not a copy
+    ExpectTrue(seen == payload);
+    ExpectIntEquals(4096, seen->bytes);
+
+    //the next frame's payloads come from the other arena, then the first one is reused
+    EventContext next = {};
+    TestPayload* second = (TestPayload*)EventPayloadAllocate(sizeof(TestPayload), TEST_PAYLOAD_TYPE, &next);
+    ExpectTrue(second != payload);
+    EventDispatchQueued();
+    EventContext third = {};
+    ExpectTrue(EventPayloadAllocate(sizeof(TestPayload), TEST_PAYLOAD_TYPE, &third) == payload);
+
+    context.data.payload.type = TEST_PAYLOAD_TYPE + 1;
+    ExpectTrue(EventPayloadGet(context, TestPayload, TEST_PAYLOAD_TYPE) == 0);
+    ExpectTrue(EventPayloadAllocate(1 << 30, TEST_PAYLOAD_TYPE, &context) == 0);
+    StopEventSystem();
+    return true;
+}
+
+#if DEVENT_INSTRUMENTATION
+u8 Event_InstrumentationCountsFiresAndListeners(){
+    StartEventSystem();
+    EventRecorder first = {};
+    EventRecorder second = {};
+    EventRegister(TEST_EVENT_CODE_A, &first, RecordEvent, EVENT_PRIORITY_NORMAL);
+    EventRegister(TEST_EVENT_CODE_A, &second, RecordEvent, EVENT_PRIORITY_NORMAL);
+    EventRegister(TEST_EVENT_CODE_B, &first, RecordEvent, EVENT_PRIORITY_NORMAL);
+
+    EventContext context = {};
+    for(u32 i = 0; i < 5; i++){
+        EventFire(TEST_EVENT_CODE_A, 0, context);
+    }
+    EventPost(TEST_EVENT_CODE_B, 0, context);
+    //rolls this frame's five fires into last_frame_count, then fires the posted B
+    EventDispatchQueued();
+
+    EventCodeStats stats[8];
+    u32 count = EventGetCodeStats(stats, 8);
+    ExpectIntEquals(2, count);
+    ExpectIntEquals(count, EventGetCodeStats(0, 0));
+    for(u32 i = 0; i < count; i++){
+        if(stats[i].code == TEST_EVENT_CODE_A){
+            ExpectIntEquals(5, stats[i].last_frame_count);
+            ExpectIntEquals(5, stats[i].total_count);
+            ExpectIntEquals(2, stats[i].listener_count);
+        } else {
+            ExpectIntEquals(TEST_EVENT_CODE_B, stats[i].code);
+            ExpectIntEquals(0, stats[i].last_frame_count);
+            ExpectIntEquals(1, stats[i].total_count);
+        }
+    }
+
+    //re-registering keeps accumulating into the same record
+    EventUnregister(TEST_EVENT_CODE_A, &second, RecordEvent);
+    EventRegister(TEST_EVENT_CODE_A, &second, RecordEvent, EVENT_PRIORITY_NORMAL);
+    EventFire(TEST_EVENT_CODE_A, 0, context);
+    EventListenerStats listeners[8];
+    ExpectIntEquals(3, EventGetListenerStats(listeners, 8));
+    ExpectTrue(listeners[1].listener == &second);
+    ExpectIntEquals(6, listeners[1].calls);
+    ExpectTrue(listeners[1].seconds >= 0);
+    EventLogStats();
+    StopEventSystem();
+    return true;
+}
+#endif
+
+void EventRegisterTests(){
+    RegisterTest(Event_PostIsDeferredUntilDispatch, "Event_PostIsDeferredUntilDispatch");
+    RegisterTest(Event_PostFromListenerWaitsAFrame, "Event_PostFromListenerWaitsAFrame");
+    RegisterTest(Event_CoalescePoliciesMergeQueuedPosts, "Event_CoalescePoliciesMergeQueuedPosts");
+    RegisterTest(Event_RegistrationTableGrowsAndRemovesInOrder, "Event_RegistrationTableGrowsAndRemovesInOrder");
+    RegisterTest(Event_UnregisterDuringFireReachesEveryone, "Event_UnregisterDuringFireReachesEveryone");
+    RegisterTest(Event_PostFromWorkerThreadsDrainsOnDispatch, "Event_PostFromWorkerThreadsDrainsOnDispatch");
+    RegisterTest(Event_FireFromWorkersWhileRegistering, "Event_FireFromWorkersWhileRegistering");
+    RegisterTest(Event_UnregisterWaitsForFiresOnOtherThreads, "Event_UnregisterWaitsForFiresOnOtherThreads");
+    RegisterTest(Event_FireFromWorkerReachesEveryListener, "Event_FireFromWorkerReachesEveryListener");
+    RegisterTest(Event_ListenersRunInPriorityOrder, "Event_ListenersRunInPriorityOrder");
+    RegisterTest(Event_PayloadsLiveInTheFrameArena, "Event_PayloadsLiveInTheFrameArena");
+#if DEVENT_INSTRUMENTATION
+    RegisterTest(Event_InstrumentationCountsFiresAndListeners, "Event_InstrumentationCountsFiresAndListeners");
+#endif
+}
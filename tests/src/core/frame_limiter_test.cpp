@@ -0,0 +1,81 @@
+#include "frame_limiter_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <core/frame_limiter.h>
+#include <core/logger.h>
+#include <platform/platform.h>
+
+u8 FrameLimiter_PacesToTarget(){
+    FrameLimiter limiter;
+    FrameLimiterInit(&limiter, 200.0);
+    //the first wait only starts the schedule
+    FrameLimiterWait(&limiter);
+    f64 start = PlatformGetAbsoluteTime();
+    for(u32 i = 0; i < 40; i++){
+        FrameLimiterWait(&limiter);
+    }
+    f64 elapsed = PlatformGetAbsoluteTime() - start;
+
+    FrameLimiterStats stats;
+    FrameLimiterGetStats(&limiter, &stats);
+    DINFO("200 Hz limiter: frame time avg %.3f ms, jitter %.3f ms, worst wake %.3f ms late, %.3f s slept, %.3f s spun",
+          stats.mean_frame_seconds * 1000.0, stats.jitter_seconds * 1000.0, stats.max_pacing_error_seconds * 1000.0,
+          stats.sleep_seconds, stats.spin_seconds);
+    ExpectIntEquals(40, stats.frames);
+    //only lower bounds, a loaded machine can always wake later than asked. Deadlines are absolute, so the
+    //total is never short of the target and the mean is at most one early wake under it
+    ExpectTrue(elapsed >= 40 * 0.005 - 0.0001);
+    ExpectTrue(stats.mean_frame_seconds > 0.0045);
+    ExpectTrue(stats.sleep_seconds > 0);
+    return true;
+}
+
+u8 FrameLimiter_UnlimitedOnlyMeasures(){
+    FrameLimiter limiter;
+    FrameLimiterInit(&limiter, 0);
+    f64 start = PlatformGetAbsoluteTime();
+    for(u32 i = 0; i < 11; i++){
+        FrameLimiterWait(&limiter);
+    }
+    //unlimited never sleeps, the bound is only generous so a loaded machine doesn't fail it
+    ExpectTrue(PlatformGetAbsoluteTime() - start < 0.1);
+
+    FrameLimiterStats stats;
+    FrameLimiterGetStats(&limiter, &stats);
+    ExpectIntEquals(10, stats.frames);
+    ExpectFloatEquals(0.0f, (f32)stats.sleep_seconds);
+    ExpectFloatEquals(0.0f, (f32)stats.spin_seconds);
+    ExpectIntEquals(0, stats.missed_deadlines);
+
+    FrameLimiterResetStats(&limiter);
+    FrameLimiterGetStats(&limiter, &stats);
+    ExpectIntEquals(0, stats.frames);
+    return true;
+}
+
+u8 FrameLimiter_LateFrameDropsBacklog(){
+    FrameLimiter limiter;
+    FrameLimiterInit(&limiter, 500.0);
+    FrameLimiterWait(&limiter);
+    //a frame taking several targets is a miss, and the limiter shouldn't then run short frames to catch up
+    PlatformSleep(10);
+    FrameLimiterWait(&limiter);
+    f64 start = PlatformGetAbsoluteTime();
+    FrameLimiterWait(&limiter);
+    f64 waited = PlatformGetAbsoluteTime() - start;
+
+    FrameLimiterStats stats;
+    FrameLimiterGetStats(&limiter, &stats);
+    //at least the slow frame, a loaded machine can miss more
+    ExpectTrue(stats.missed_deadlines >= 1);
+    ExpectTrue(waited > 0.0015);
+    return true;
+}
+
+void FrameLimiterRegisterTests(){
+    RegisterTest(FrameLimiter_PacesToTarget, "FrameLimiter_PacesToTarget");
+    RegisterTest(FrameLimiter_UnlimitedOnlyMeasures, "FrameLimiter_UnlimitedOnlyMeasures");
+    RegisterTest(FrameLimiter_LateFrameDropsBacklog, "FrameLimiter_LateFrameDropsBacklog");
+}
@@ -0,0 +1,285 @@
+#include "input_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <core/input.h>
+#include <core/input_recording.h>
+#include <core/input_actions.h>
+#include <core/dmemory.h>
+
+static void* input_test_state;
+static u64 input_test_state_size;
+
+static void StartInputSystem(){
+    InputSystemInitialize(&input_test_state_size, 0);
+    input_test_state = DAllocate(input_test_state_size, MEMORY_TAG_APPLICATION);
+    InputSystemInitialize(&input_test_state_size, input_test_state);
+}
+
+static void StopInputSystem(){
+    InputSystemShutdown(input_test_state);
+    DFree(input_test_state, input_test_state_size, MEMORY_TAG_APPLICATION);
+    input_test_state = 0;
+}
+
+static void* recording_test_state;
+static u64 recording_test_state_size;
+
+static void StartInputRecording(){
+    StartInputSystem();
+    InputRecordingInitialize(&recording_test_state_size, 0);
+    recording_test_state = DAllocate(recording_test_state_size, MEMORY_TAG_APPLICATION);
+    InputRecordingInitialize(&recording_test_state_size, recording_test_state);
+}
+
+static void StopInputRecording(){
+    InputRecordingShutdown(recording_test_state);
+    DFree(recording_test_state, recording_test_state_size, MEMORY_TAG_APPLICATION);
+    recording_test_state = 0;
+    StopInputSystem();
+}
+
+static void* actions_test_state;
+static u64 actions_test_state_size;
+
+static void StartInputActions(){
+    StartInputSystem();
+    InputActionsInitialize(&actions_test_state_size, 0);
+    actions_test_state = DAllocate(actions_test_state_size, MEMORY_TAG_APPLICATION);
+    InputActionsInitialize(&actions_test_state_size, actions_test_state);
+}
+
+static void StopInputActions(){
+    InputActionsShutdown(actions_test_state);
+    DFree(actions_test_state, actions_test_state_size, MEMORY_TAG_APPLICATION);
+    actions_test_state = 0;
+    StopInputSystem();
+}
+
+u8 Input_TapWithinAFrameIsKeptInTheRing(){
+    StartInputSystem();
+    InputProcessKey(KEY_SPACE, true);
+    InputProcessMouseMove(10, 20);
+    InputProcessMouseMove(11, 22);
+    InputProcessKey(KEY_SPACE, false);
+
+    //the state snapshot never saw space down, the ring did
+    ExpectTrue(InputIsKeyUp(KEY_SPACE));
+    InputEventIterator iterator;
+    InputEvent event;
+    InputEventsBegin(&iterator);
+    ExpectTrue(InputEventsNext(&iterator, &event));
+    ExpectIntEquals(INPUT_EVENT_KEY_PRESSED, event.type);
+    ExpectIntEquals(KEY_SPACE, event.code);
+    f64 pressed_time = event.timestamp;
+    ExpectTrue(InputEventsNext(&iterator, &event));
+    ExpectIntEquals(INPUT_EVENT_MOUSE_MOVED, event.type);
+    ExpectIntEquals(10, event.x);
+    ExpectTrue(InputEventsNext(&iterator, &event));
+    ExpectIntEquals(22, event.y);
+    ExpectTrue(InputEventsNext(&iterator, &event));
+    ExpectIntEquals(INPUT_EVENT_KEY_RELEASED, event.type);
+    ExpectTrue(event.timestamp >= pressed_time);
+    ExpectFalse(InputEventsNext(&iterator, &event));
+
+    InputUpdate(0.016);
+    InputEventsBegin(&iterator);
+    ExpectFalse(InputEventsNext(&iterator, &event));
+    StopInputSystem();
+    return true;
+}
+
+u8 Input_StateCarriesOverUpdate(){
+    StartInputSystem();
+    InputProcessKey(KEY_W, true);
+    InputProcessButton(BUTTON_RIGHT, true);
+    ExpectTrue(InputIsKeyDown(KEY_W));
+    ExpectTrue(InputWasKeyUp(KEY_W));
+    ExpectTrue(InputIsKeyUp(KEY_A));
+
+    InputUpdate(0.016);
+    ExpectTrue(InputIsKeyDown(KEY_W));
+    ExpectTrue(InputWasKeyDown(KEY_W));
+    ExpectTrue(InputIsButtonDown(BUTTON_RIGHT));
+    ExpectTrue(InputWasButtonDown(BUTTON_RIGHT));
+    ExpectTrue(InputIsButtonUp(BUTTON_LEFT));
+
+    InputProcessKey(KEY_W, false);
+    ExpectTrue(InputIsKeyUp(KEY_W));
+    ExpectTrue(InputWasKeyDown(KEY_W));
+    StopInputSystem();
+    return true;
+}
+
+u8 Input_RingKeepsTheNewestEventsOnOverflow(){
+    StartInputSystem();
+    for(i16 i = 1; i <= INPUT_EVENT_RING_CAPACITY + 10; i++){
+        InputProcessMouseMove(i, 0);
+    }
+    InputEventIterator iterator;
+    InputEvent event;
+    InputEventsBegin(&iterator);
+    u32 count = 0;
+    i16 first_x = 0;
+    while(InputEventsNext(&iterator, &event)){
+        if(count == 0){
+            first_x = event.x;
+        }
+        count++;
+    }
+    ExpectIntEquals(INPUT_EVENT_RING_CAPACITY, count);
+    ExpectIntEquals(11, first_x);
+    ExpectIntEquals(INPUT_EVENT_RING_CAPACITY + 10, event.x);
+    StopInputSystem();
+    return true;
+}
+
+#define TEST_RECORDING_PATH "input_recording_test.dinp"
+
+u8 Input_RecordingPlaysBackFrameByFrame(){
+    StartInputRecording();
+    ExpectTrue(InputRecordingStart(TEST_RECORDING_PATH));
+    InputProcessKey(KEY_W, true);
+    InputProcessMouseMove(-5, 300);
+    InputRecordFrame(0, 0.016);
+    InputUpdate(0.016);
+    InputRecordFrame(1, 0.020);
+    InputUpdate(0.020);
+    InputProcessMouseWheel(-3);
+    InputProcessKey(KEY_W, false);
+    InputRecordFrame(2, 0.017);
+    InputRecordingStop();
+    StopInputRecording();
+
+    StartInputRecording();
+    ExpectTrue(InputPlaybackStart(TEST_RECORDING_PATH));
+    f64 delta = 0;
+    ExpectTrue(InputPlaybackFrame(&delta));
+    ExpectFloatEquals(0.016, delta);
+    ExpectTrue(InputIsKeyDown(KEY_W));
+    i32 x, y;
+    InputGetMousePosition(&x, &y);
+    ExpectIntEquals(-5, x);
+    ExpectIntEquals(300, y);
+    InputUpdate(delta);
+
+    //live input while muted, as the platform pump is during playback, never reaches the recorded frames
+    InputSetMuted(true);
+    InputProcessKey(KEY_A, true);
+    InputProcessMouseWheel(7);
+    InputSetMuted(false);
+    ExpectTrue(InputIsKeyUp(KEY_A));
+    ExpectTrue(InputPlaybackFrame(&delta));
+    ExpectFloatEquals(0.020, delta);
+    InputEventIterator iterator;
+    InputEvent event;
+    InputEventsBegin(&iterator);
+    ExpectFalse(InputEventsNext(&iterator, &event));
+    InputUpdate(delta);
+
+    ExpectTrue(InputPlaybackFrame(&delta));
+    ExpectTrue(InputIsKeyUp(KEY_W));
+    InputEventsBegin(&iterator);
+    ExpectTrue(InputEventsNext(&iterator, &event));
+    ExpectIntEquals(INPUT_EVENT_MOUSE_WHEEL, event.type);
+    ExpectIntEquals(-3, event.wheel_delta);
+
+    ExpectFalse(InputPlaybackFrame(&delta));
+    ExpectFalse(InputPlaybackIsActive());
+    InputPlaybackStop();
+    StopInputRecording();
+    return true;
+}
+
+u8 Input_ActionAxesSumAndClamp(){
+    StartInputActions();
+    u16 yaw = InputActionRegister("yaw", INPUT_ACTION_AXIS);
+    ExpectIntEquals(yaw, InputActionRegister("yaw", INPUT_ACTION_AXIS));
+    ExpectIntEquals(yaw, InputActionFind("yaw"));
+    ExpectIntEquals(INPUT_ACTION_INVALID, InputActionFind("pitch"));
+    InputActionBindKey(yaw, KEY_A, 1.0f);
+    InputActionBindKey(yaw, KEY_LEFT, 1.0f);
+    InputActionBindKey(yaw, KEY_D, -0.5f);
+    InputActionState* actions = InputActionsGetStates();
+
+    InputProcessKey(KEY_D, true);
+    InputActionsUpdate();
+    ExpectFloatEquals(-0.5f, actions[yaw].value);
+    ExpectTrue(actions[yaw].down);
+
+    InputProcessKey(KEY_A, true);
+    InputProcessKey(KEY_LEFT, true);
+    InputActionsUpdate();
+    ExpectFloatEquals(1.0f, actions[yaw].value);
+
+    InputActionUnbindAll(yaw);
+    InputActionsUpdate();
+    ExpectFloatEquals(0.0f, actions[yaw].value);
+    ExpectFalse(actions[yaw].down);
+    StopInputActions();
+    return true;
+}
+
+u8 Input_ActionChordsNeedEveryKey(){
+    StartInputActions();
+    u16 save = InputActionRegister("save", INPUT_ACTION_BUTTON);
+    Keys keys[] = {KEY_LCONTROL, KEY_S};
+    Buttons buttons[] = {BUTTON_RIGHT};
+    InputActionBind(save, keys, ArrayCount(keys), buttons, ArrayCount(buttons), 1.0f);
+    InputActionState* actions = InputActionsGetStates();
+
+    InputProcessKey(KEY_S, true);
+    InputProcessButton(BUTTON_RIGHT, true);
+    InputActionsUpdate();
+    ExpectFalse(actions[save].down);
+
+    InputProcessKey(KEY_LCONTROL, true);
+    InputActionsUpdate();
+    ExpectTrue(actions[save].down);
+    ExpectTrue(actions[save].pressed);
+    ExpectFloatEquals(1.0f, actions[save].value);
+
+    InputActionsUpdate();
+    ExpectTrue(actions[save].down);
+    ExpectFalse(actions[save].pressed);
+
+    InputProcessButton(BUTTON_RIGHT, false);
+    InputActionsUpdate();
+    ExpectFalse(actions[save].down);
+    ExpectTrue(actions[save].released);
+    StopInputActions();
+    return true;
+}
+
+u8 Input_ActionBindingsLoadFromText(){
+    StartInputActions();
+    u16 move = InputActionRegister("move", INPUT_ACTION_AXIS);
+    u16 fire = InputActionRegister("fire", INPUT_ACTION_BUTTON);
+    ExpectTrue(InputActionsLoadBindings("move W\r\n\nmove S -0.25\nfire MOUSE_LEFT+F2\n"));
+    ExpectFalse(InputActionsLoadBindings("move NOT_A_KEY\n"));
+    ExpectFalse(InputActionsLoadBindings("jump SPACE\n"));
+    InputActionState* actions = InputActionsGetStates();
+
+    InputProcessKey(KEY_S, true);
+    InputProcessKey(KEY_F2, true);
+    InputActionsUpdate();
+    ExpectFloatEquals(-0.25f, actions[move].value);
+    ExpectFalse(actions[fire].down);
+
+    InputProcessButton(BUTTON_LEFT, true);
+    InputActionsUpdate();
+    ExpectTrue(actions[fire].pressed);
+    StopInputActions();
+    return true;
+}
+
+void InputRegisterTests(){
+    RegisterTest(Input_TapWithinAFrameIsKeptInTheRing, "Input_TapWithinAFrameIsKeptInTheRing");
+    RegisterTest(Input_StateCarriesOverUpdate, "Input_StateCarriesOverUpdate");
+    RegisterTest(Input_RingKeepsTheNewestEventsOnOverflow, "Input_RingKeepsTheNewestEventsOnOverflow");
+    RegisterTest(Input_RecordingPlaysBackFrameByFrame, "Input_RecordingPlaysBackFrameByFrame");
+    RegisterTest(Input_ActionAxesSumAndClamp, "Input_ActionAxesSumAndClamp");
+    RegisterTest(Input_ActionChordsNeedEveryKey, "Input_ActionChordsNeedEveryKey");
+    RegisterTest(Input_ActionBindingsLoadFromText, "Input_ActionBindingsLoadFromText");
+}
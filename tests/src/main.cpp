@@ -1,12 +1,54 @@
 #include "test_manager.h"
 #include "memory/linear_allocator_tests.h"
+#include "core/dstring_tests.h"
+#include "core/dstring_bench.h"
+#include "core/event_tests.h"
+#include "core/input_tests.h"
+#include "core/frame_limiter_tests.h"
+#include "core/clock_tests.h"
+#include "core/clock_bench.h"
+#include "core/compression_tests.h"
+#include "core/compression_bench.h"
+#include "platform/threading_tests.h"
+#include "platform/threading_bench.h"
+#include "platform/filesystem_tests.h"
+#include "platform/filesystem_bench.h"
+#include "platform/async_io_tests.h"
+#include "platform/asset_pack_tests.h"
 
 #include <core/logger.h>
+#include <core/dstring.h>
+
+//Benchmarks take seconds and are mostly there to report numbers, they only run with --bench
+int main(int argc, char** argv){
+    b8 run_benchmarks = false;
+    for(int i = 1; i < argc; i++){
+        if(StringsEqual(argv[i], "--bench")){
+            run_benchmarks = true;
+        }
+    }
 
-int main(){
     TestManagerInit();
 
     LinearAllocatorRegisterTests();
+    StringRegisterTests();
+    EventRegisterTests();
+    InputRegisterTests();
+    FrameLimiterRegisterTests();
+    ClockRegisterTests();
+    CompressionRegisterTests();
+    ThreadingRegisterTests();
+    FileSystemRegisterTests();
+    AsyncIoRegisterTests();
+    AssetPackRegisterTests();
+
+    if(run_benchmarks){
+        StringRegisterBenchmarks();
+        ClockRegisterBenchmarks();
+        CompressionRegisterBenchmarks();
+        ThreadingRegisterBenchmarks();
+        FileSystemRegisterBenchmarks();
+    }
 
     DDEBUG("Starting test...");
 
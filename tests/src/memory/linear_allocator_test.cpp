@@ -91,10 +91,31 @@ u8 LinearAllocator_AllocateAllSpaceThenFree(){
 
 }
 
+u8 LinearAllocator_AlignedAllocatePadsStart(){
+    LinearAllocator alloc = {};
+    AllocatorCreate(64, 0, &alloc);
+
+    AllocatorAllocate(&alloc, 3);
+    void* block = AllocatorAllocateAligned(&alloc, 16, 16);
+    ExpectIntNotEquals(0, block);
+    ExpectIntEquals(0, ((u64)block - (u64)alloc.memory) % 16);
+    ExpectIntEquals(32, alloc.allocated);
+
+    //31 bytes would fit after this one, but not once the start is padded out to 48
+    AllocatorAllocate(&alloc, 1);
+    block = AllocatorAllocateAligned(&alloc, 31, 16);
+    ExpectIntEquals(0, block);
+    ExpectIntEquals(33, alloc.allocated);
+
+    AllocatorDestroy(&alloc);
+    return true;
+}
+
 void LinearAllocatorRegisterTests(){
     RegisterTest(LinearAllocator_ShouldCreateAndDestroy, "LinearAllocator_ShouldCreateAndDestroy");
     RegisterTest(LinearAllocator_SingleAllocateAllSpace, "LinearAllocator_SingleAllocateAllSpace");
     RegisterTest(LinearAllocator_MultiAllocateAllSpaceSuccess, "LinearAllocator_MultiAllocateAllSpaceSuccess");
     RegisterTest(LinearAllocator_OverAllocateShouldError, "LinearAllocator_OverAllocateShouldError");
     RegisterTest(LinearAllocator_AllocateAllSpaceThenFree, "LinearAllocator_AllocateAllSpaceThenFree");
+    RegisterTest(LinearAllocator_AlignedAllocatePadsStart, "LinearAllocator_AlignedAllocatePadsStart");
 }
\ No newline at end of file
@@ -0,0 +1,225 @@
+#include "asset_pack_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <platform/asset_pack.h>
+#include <platform/filesystem.h>
+#include <core/logger.h>
+#include <core/dstring.h>
+#include <core/dmemory.h>
+
+#include <stdio.h>
+
+#define ASSET_PACK_TEST_PATH "asset_pack_test.dpak"
+#define ASSET_PACK_TEST_LOOSE_PATH "asset_pack_test_loose.bin"
+
+static u8 asset_pack_test_data[3][300];
+
+static u32 WriteTestPack(){
+    for(u32 i = 0; i < 3; i++){
+        for(u32 j = 0; j < sizeof(asset_pack_test_data[i]); j++){
+            asset_pack_test_data[i][j] = (u8)(i * 91 + j);
+        }
+    }
+    AssetPackSource sources[3] = {};
+    sources[0].name = "assets/shaders/Builtin.ObjectShader.vert.spv";
+    sources[0].data = asset_pack_test_data[0];
+    sources[0].size = 300;
+    //stored normalized, found by either spelling
+    sources[1].name = "./assets\\textures\\grid.png";
+    sources[1].data = asset_pack_test_data[1];
+    sources[1].size = 77;
+    sources[2].name = "empty.txt";
+    sources[2].data = asset_pack_test_data[2];
+    sources[2].size = 0;
+    return AssetPackWrite(ASSET_PACK_TEST_PATH, sources, 3);
+}
+
+static b8 EntryMatches(AssetPack* pack, char* name, u8* expected, u64 size){
+    AssetPackEntry* entry = AssetPackFind(pack, name);
+    if(!entry || entry->size != size || entry->offset % ASSET_PACK_ALIGNMENT != 0){
+        return false;
+    }
+    u8* data = (u8*)AssetPackEntryData(pack, entry);
+    for(u64 i = 0; i < size; i++){
+        if(data[i] != expected[i]){
+            return false;
+        }
+    }
+    return true;
+}
+
+u8 AssetPack_WriteThenFindEveryEntry(){
+    ExpectTrue(WriteTestPack());
+    AssetPack pack;
+    ExpectTrue(AssetPackOpen(ASSET_PACK_TEST_PATH, &pack));
+    ExpectIntEquals(3, pack.header->entry_count);
+    ExpectIntEquals(0, pack.header->index_slot_count & (pack.header->index_slot_count - 1));
+    ExpectTrue(EntryMatches(&pack, "assets/shaders/Builtin.ObjectShader.vert.spv", asset_pack_test_data[0], 300));
+    ExpectTrue(EntryMatches(&pack, "assets/textures/grid.png", asset_pack_test_data[1], 77));
+    ExpectTrue(EntryMatches(&pack, "assets\\textures\\grid.png", asset_pack_test_data[1], 77));
+    ExpectTrue(EntryMatches(&pack, "empty.txt", asset_pack_test_data[2], 0));
+
+    ExpectTrue(AssetPackFind(&pack, "assets/textures/grid") == 0);
+    ExpectTrue(AssetPackFind(&pack, "assets/textures/grid.png2") == 0);
+    ExpectTrue(AssetPackFind(&pack, "") == 0);
+    AssetPackClose(&pack);
+    ExpectTrue(pack.header == 0);
+    ExpectTrue(AssetPackFind(&pack, "empty.txt") == 0);
+    remove(ASSET_PACK_TEST_PATH);
+    return true;
+}
+
+u8 AssetPack_RejectsDuplicatesAndCorruptFiles(){
+    u8 data[4] = {1, 2, 3, 4};
+    AssetPackSource sources[2] = {};
+    sources[0].name = "a/b.bin";
+    sources[0].data = data;
+    sources[0].size = 4;
+    sources[1].name = "./a\\b.bin";
+    sources[1].data = data;
+    sources[1].size = 4;
+    DDEBUG("Note: The following error is intentionally caused by this test.");
+    ExpectFalse(AssetPackWrite(ASSET_PACK_TEST_PATH, sources, 2));
+
+    //a truncated pack fails its bounds checks instead of handing out offsets past the end
+    ExpectTrue(WriteTestPack());
+    FileMapping mapping;
+    ExpectTrue(FileSystemMap(ASSET_PACK_TEST_PATH, FILE_ACCESS_NORMAL, &mapping));
+    u64 truncated_size = mapping.size - 100;
+    FileHandle handle;
+    ExpectTrue(FileSystemOpen(ASSET_PACK_TEST_LOOSE_PATH, FILE_MODE_WRITE, true, &handle));
+    u64 written = 0;
+    ExpectTrue(FileSystemWrite(&handle, truncated_size, mapping.data, &written));
+    FileSystemClose(&handle);
+    FileSystemUnmap(&mapping);
+    AssetPack pack;
+    DDEBUG("Note: The following error is intentionally caused by this test.");
+    ExpectFalse(AssetPackOpen(ASSET_PACK_TEST_LOOSE_PATH, &pack));
+
+    //and a file that isn't a pack at all
+    ExpectTrue(FileSystemOpen(ASSET_PACK_TEST_LOOSE_PATH, FILE_MODE_WRITE, true, &handle));
+    ExpectTrue(FileSystemWrite(&handle, sizeof(asset_pack_test_data[0]), asset_pack_test_data[0], &written));
+    FileSystemClose(&handle);
+    DDEBUG("Note: The following error is intentionally caused by this test.");
+    ExpectFalse(AssetPackOpen(ASSET_PACK_TEST_LOOSE_PATH, &pack));
+    ExpectTrue(pack.header == 0);
+
+    //an index with no empty slot left, lookups of missing names have to give up instead of probing forever
+    ExpectTrue(FileSystemMap(ASSET_PACK_TEST_PATH, FILE_ACCESS_NORMAL, &mapping));
+    u8* corrupt = (u8*)DAllocate(mapping.size, MEMORY_TAG_APPLICATION);
+    DCopyMemory(corrupt, mapping.data, mapping.size);
+    AssetPackHeader* header = (AssetPackHeader*)corrupt;
+    u32* index = (u32*)(corrupt + header->index_offset);
+    for(u32 i = 0; i < header->index_slot_count; i++){
+        index[i] = 1;
+    }
+    ExpectTrue(FileSystemOpen(ASSET_PACK_TEST_LOOSE_PATH, FILE_MODE_WRITE, true, &handle));
+    ExpectTrue(FileSystemWrite(&handle, mapping.size, corrupt, &written));
+    FileSystemClose(&handle);
+    DFree(corrupt, mapping.size, MEMORY_TAG_APPLICATION);
+    FileSystemUnmap(&mapping);
+    ExpectTrue(AssetPackOpen(ASSET_PACK_TEST_LOOSE_PATH, &pack));
+    ExpectTrue(AssetPackFind(&pack, "not/in/the/pack.bin") == 0);
+    AssetPackClose(&pack);
+
+    remove(ASSET_PACK_TEST_PATH);
+    remove(ASSET_PACK_TEST_LOOSE_PATH);
+    return true;
+}
+
+u8 AssetPack_OpenAssetPrefersPackThenLooseFiles(){
+    ExpectTrue(WriteTestPack());
+    u8 loose[5] = {9, 8, 7, 6, 5};
+    FileHandle handle;
+    ExpectTrue(FileSystemOpen(ASSET_PACK_TEST_LOOSE_PATH, FILE_MODE_WRITE, true, &handle));
+    u64 written = 0;
+    ExpectTrue(FileSystemWrite(&handle, sizeof(loose), loose, &written));
+    FileSystemClose(&handle);
+
+    ExpectTrue(FileSystemMountPack(ASSET_PACK_TEST_PATH));
+    AssetData asset;
+    ExpectTrue(FileSystemOpenAsset("assets/textures/grid.png", FILE_ACCESS_NORMAL, &asset));
+    ExpectIntEquals(77, asset.size);
+    ExpectIntEquals(asset_pack_test_data[1][76], ((u8*)asset.data)[76]);
+    //nothing to unmap, the bytes belong to the pack's mapping
+    ExpectTrue(asset.mapping.data == 0);
+    FileSystemCloseAsset(&asset);
+
+    ExpectTrue(FileSystemOpenAsset(ASSET_PACK_TEST_LOOSE_PATH, FILE_ACCESS_NORMAL, &asset));
+    ExpectIntEquals(5, asset.size);
+    ExpectIntEquals(6, ((u8*)asset.data)[3]);
+    ExpectTrue(asset.mapping.data == asset.data);
+    FileSystemCloseAsset(&asset);
+    ExpectTrue(asset.data == 0);
+
+    DDEBUG("Note: The following error is intentionally caused by this test.");
+    ExpectFalse(FileSystemOpenAsset("assets/missing.bin", FILE_ACCESS_NORMAL, &asset));
+    FileSystemUnmountPacks();
+
+    //once unmounted the pack's names aren't found anymore
+    DDEBUG("Note: The following error is intentionally caused by this test.");
+    ExpectFalse(FileSystemOpenAsset("assets/textures/grid.png", FILE_ACCESS_NORMAL, &asset));
+    remove(ASSET_PACK_TEST_PATH);
+    remove(ASSET_PACK_TEST_LOOSE_PATH);
+    return true;
+}
+
+u8 AssetPack_CompressedEntriesReadBack(){
+    static u8 data[KiloBytes(100)];
+    for(u32 i = 0; i < sizeof(data); i++){
+        data[i] = (u8)(i / 100);
+    }
+    u8 noise[64];
+    for(u32 i = 0; i < sizeof(noise); i++){
+        noise[i] = (u8)(i * 167 + 13);
+    }
+    AssetPackSource sources[2] = {};
+    sources[0].name = "assets/textures/gradient.raw";
+    sources[0].data = data;
+    sources[0].size = sizeof(data);
+    sources[0].compression = ASSET_PACK_COMPRESSION_LZ;
+    sources[1].name = "assets/noise.bin";
+    sources[1].data = noise;
+    sources[1].size = sizeof(noise);
+    sources[1].compression = ASSET_PACK_COMPRESSION_LZ;
+    ExpectTrue(AssetPackWrite(ASSET_PACK_TEST_PATH, sources, 2));
+
+    AssetPack pack;
+    ExpectTrue(AssetPackOpen(ASSET_PACK_TEST_PATH, &pack));
+    AssetPackEntry* entry = AssetPackFind(&pack, "assets/textures/gradient.raw");
+    ExpectTrue(entry != 0);
+    ExpectIntEquals(ASSET_PACK_COMPRESSION_LZ, entry->compression);
+    ExpectTrue(entry->stored_size < entry->size / 10);
+    //didn't shrink, so it went in as is
+    ExpectIntEquals(ASSET_PACK_COMPRESSION_NONE, AssetPackFind(&pack, "assets/noise.bin")->compression);
+
+    static u8 staging[KiloBytes(100)];
+    ExpectTrue(AssetPackEntryRead(&pack, entry, staging, sizeof(staging)));
+    u32 mismatches = 0;
+    for(u32 i = 0; i < sizeof(data); i++){
+        mismatches += staging[i] != data[i];
+    }
+    ExpectIntEquals(0, mismatches);
+    DDEBUG("Note: The following error is intentionally caused by this test.");
+    ExpectFalse(AssetPackEntryRead(&pack, entry, staging, sizeof(staging) - 1));
+    AssetPackClose(&pack);
+
+    ExpectTrue(FileSystemMountPack(ASSET_PACK_TEST_PATH));
+    AssetData asset;
+    ExpectTrue(FileSystemOpenAsset("assets/textures/gradient.raw", FILE_ACCESS_NORMAL, &asset));
+    ExpectIntEquals(sizeof(data), asset.size);
+    ExpectIntEquals(data[54321], ((u8*)asset.data)[54321]);
+    FileSystemCloseAsset(&asset);
+    FileSystemUnmountPacks();
+    remove(ASSET_PACK_TEST_PATH);
+    return true;
+}
+
+void AssetPackRegisterTests(){
+    RegisterTest(AssetPack_WriteThenFindEveryEntry, "AssetPack_WriteThenFindEveryEntry");
+    RegisterTest(AssetPack_RejectsDuplicatesAndCorruptFiles, "AssetPack_RejectsDuplicatesAndCorruptFiles");
+    RegisterTest(AssetPack_OpenAssetPrefersPackThenLooseFiles, "AssetPack_OpenAssetPrefersPackThenLooseFiles");
+    RegisterTest(AssetPack_CompressedEntriesReadBack, "AssetPack_CompressedEntriesReadBack");
+}
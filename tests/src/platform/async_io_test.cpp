@@ -0,0 +1,171 @@
+#include "async_io_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <platform/async_io.h>
+#include <platform/filesystem.h>
+#include <platform/threading.h>
+#include <core/dmemory.h>
+#include <core/event.h>
+
+#include <stdio.h>
+
+#define ASYNC_TEST_PATH "async_io_test.bin"
+#define ASYNC_TEST_FILE_SIZE (KiloBytes(256) + 100)
+#define ASYNC_TEST_CHUNK KiloBytes(16)
+#define ASYNC_TEST_EVENT_CODE 0x180
+
+static void* async_test_state;
+static u64 async_test_state_size;
+
+static u8 ExpectedByte(u64 position){
+    return (u8)(position * 13 + (position >> 9));
+}
+
+static b8 WriteAsyncTestFile(){
+    u8* data = (u8*)DAllocate(ASYNC_TEST_FILE_SIZE, MEMORY_TAG_APPLICATION);
+    for(u64 i = 0; i < ASYNC_TEST_FILE_SIZE; i++){
+        data[i] = ExpectedByte(i);
+    }
+    FileHandle handle;
+    u64 written = 0;
+    b8 result = FileSystemOpen(ASYNC_TEST_PATH, FILE_MODE_WRITE, true, &handle) &&
+                FileSystemWrite(&handle, ASYNC_TEST_FILE_SIZE, data, &written);
+    FileSystemClose(&handle);
+    DFree(data, ASYNC_TEST_FILE_SIZE, MEMORY_TAG_APPLICATION);
+    return result;
+}
+
+static void StartAsyncIo(AsyncIoBackendType backend){
+    AsyncIoInitialize(&async_test_state_size, 0, backend);
+    async_test_state = DAllocate(async_test_state_size, MEMORY_TAG_APPLICATION);
+    AsyncIoInitialize(&async_test_state_size, async_test_state, backend);
+}
+
+static void StopAsyncIo(){
+    AsyncIoShutdown(async_test_state);
+    DFree(async_test_state, async_test_state_size, MEMORY_TAG_APPLICATION);
+    async_test_state = 0;
+}
+
+//Reads the file in chunks, last one running past the end, and checks every byte lands where it belongs
+static u8 ReadChunksWith(AsyncIoBackendType backend){
+    ExpectTrue(WriteAsyncTestFile());
+    StartAsyncIo(backend);
+    if(backend != ASYNC_IO_BACKEND_AUTO){
+        ExpectIntEquals(backend, AsyncIoGetBackend());
+    }
+
+    AsyncFile file;
+    ExpectTrue(AsyncFileOpen(ASYNC_TEST_PATH, &file));
+    ExpectIntEquals(ASYNC_TEST_FILE_SIZE, file.size);
+    u32 chunk_count = (u32)((ASYNC_TEST_FILE_SIZE + ASYNC_TEST_CHUNK - 1) / ASYNC_TEST_CHUNK);
+    u8* destination = (u8*)DAllocate(chunk_count * ASYNC_TEST_CHUNK, MEMORY_TAG_APPLICATION);
+    for(u32 i = 0; i < chunk_count; i++){
+        //user data carries the chunk index
+        ExpectIntNotEquals(0, AsyncIoSubmitRead(&file, (u64)i * ASYNC_TEST_CHUNK, ASYNC_TEST_CHUNK,
+                                                destination + (u64)i * ASYNC_TEST_CHUNK, (void*)(u64)i, 0));
+    }
+    ExpectIntEquals(chunk_count, AsyncIoPendingCount());
+
+    u32 completed = 0;
+    u64 total_read = 0;
+    AsyncIoCompletion completions[8];
+    while(completed < chunk_count){
+        u32 count = AsyncIoWait(completions, ArrayCount(completions), 5000);
+        ExpectIntNotEquals(0, count);
+        for(u32 i = 0; i < count; i++){
+            ExpectTrue(completions[i].success);
+            u64 chunk = (u64)completions[i].user_data;
+            ExpectTrue(completions[i].destination == destination + chunk * ASYNC_TEST_CHUNK);
+            u64 expected = Minimum((u64)ASYNC_TEST_CHUNK, ASYNC_TEST_FILE_SIZE - chunk * ASYNC_TEST_CHUNK);
+            ExpectIntEquals(expected, completions[i].bytes_read);
+            total_read += completions[i].bytes_read;
+        }
+        completed += count;
+    }
+    ExpectIntEquals(ASYNC_TEST_FILE_SIZE, total_read);
+    ExpectIntEquals(0, AsyncIoPendingCount());
+    ExpectIntEquals(0, AsyncIoPoll(completions, ArrayCount(completions)));
+    u32 mismatches = 0;
+    for(u64 i = 0; i < ASYNC_TEST_FILE_SIZE; i++){
+        mismatches += destination[i] != ExpectedByte(i);
+    }
+    ExpectIntEquals(0, mismatches);
+
+    DFree(destination, chunk_count * ASYNC_TEST_CHUNK, MEMORY_TAG_APPLICATION);
+    AsyncFileClose(&file);
+    StopAsyncIo();
+    remove(ASYNC_TEST_PATH);
+    return true;
+}
+
+u8 AsyncIo_ReadsChunksWithWorkerThreads(){
+    return ReadChunksWith(ASYNC_IO_BACKEND_THREADS);
+}
+
+u8 AsyncIo_ReadsChunksWithDefaultBackend(){
+    return ReadChunksWith(ASYNC_IO_BACKEND_AUTO);
+}
+
+struct AsyncEventRecord{
+    u32 count;
+    u64 user_data;
+    u32 id;
+    b8 failed;
+    u32 bytes_read;
+};
+
+static b8 RecordAsyncEvent(u16 code, void* sender, void* listener_inst, EventContext context){
+    AsyncEventRecord* record = (AsyncEventRecord*)listener_inst;
+    record->count++;
+    record->user_data = context.data.u64[0];
+    record->id = context.data.u32[2] & ~ASYNC_IO_EVENT_FAILED;
+    record->failed = (context.data.u32[2] & ASYNC_IO_EVENT_FAILED) != 0;
+    record->bytes_read = context.data.u32[3];
+    return true;
+}
+
+u8 AsyncIo_CompletionPostsEvent(){
+    u64 event_state_size = 0;
+    EventSystemInitialize(&event_state_size, 0);
+    void* event_state = DAllocate(event_state_size, MEMORY_TAG_APPLICATION);
+    EventSystemInitialize(&event_state_size, event_state);
+    AsyncEventRecord record = {};
+    EventRegister(ASYNC_TEST_EVENT_CODE, &record, RecordAsyncEvent, EVENT_PRIORITY_NORMAL);
+
+    ExpectTrue(WriteAsyncTestFile());
+    StartAsyncIo(ASYNC_IO_BACKEND_AUTO);
+    AsyncFile file;
+    ExpectTrue(AsyncFileOpen(ASYNC_TEST_PATH, &file));
+    u8 destination[100];
+    u32 id = AsyncIoSubmitRead(&file, 1000, sizeof(destination), destination, (void*)0x1234, ASYNC_TEST_EVENT_CODE);
+    ExpectIntNotEquals(0, id);
+    //an event read is never handed out by wait, which returns once nothing is left in flight
+    AsyncIoCompletion completion;
+    ExpectIntEquals(0, AsyncIoWait(&completion, 1, 5000));
+    ExpectIntEquals(0, AsyncIoPendingCount());
+    ExpectIntEquals(0, record.count);
+    EventDispatchQueued();
+    ExpectIntEquals(1, record.count);
+    ExpectIntEquals(0x1234, record.user_data);
+    ExpectIntEquals(id, record.id);
+    ExpectFalse(record.failed);
+    ExpectIntEquals(sizeof(destination), record.bytes_read);
+    ExpectIntEquals(ExpectedByte(1000), destination[0]);
+    ExpectIntEquals(ExpectedByte(1099), destination[99]);
+
+    AsyncFileClose(&file);
+    StopAsyncIo();
+    remove(ASYNC_TEST_PATH);
+    EventSystemShutdown(event_state);
+    DFree(event_state, event_state_size, MEMORY_TAG_APPLICATION);
+    return true;
+}
+
+void AsyncIoRegisterTests(){
+    RegisterTest(AsyncIo_ReadsChunksWithWorkerThreads, "AsyncIo_ReadsChunksWithWorkerThreads");
+    RegisterTest(AsyncIo_ReadsChunksWithDefaultBackend, "AsyncIo_ReadsChunksWithDefaultBackend");
+    RegisterTest(AsyncIo_CompletionPostsEvent, "AsyncIo_CompletionPostsEvent");
+}
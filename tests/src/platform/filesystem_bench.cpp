@@ -0,0 +1,90 @@
+#include "filesystem_bench.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <platform/filesystem.h>
+#include <core/clock.h>
+#include <core/dmemory.h>
+#include <core/dstring.h>
+#include <core/logger.h>
+
+#include <stdio.h>
+
+//Line by line reading of a config sized text file, allocating per line against the block reader
+
+#define BENCH_LINES_PATH "filesystem_lines_bench.txt"
+#define BENCH_LINE_COUNT 200000
+
+u8 FileSystemBench_ReadLines(){
+    FileHandle handle;
+    ExpectTrue(FileSystemOpen(BENCH_LINES_PATH, FILE_MODE_WRITE, false, &handle));
+    char line[64];
+    for(u32 i = 0; i < BENCH_LINE_COUNT; i++){
+        StringFormatN(line, sizeof(line), "key_%u = value number %u, some padding", i, i * 7);
+        FileSystemWriteLine(&handle, line);
+    }
+    FileSystemClose(&handle);
+
+    Clock timer = {};
+    u64 characters = 0;
+    ExpectTrue(FileSystemOpen(BENCH_LINES_PATH, FILE_MODE_READ, false, &handle));
+    ClockStart(&timer);
+    char* allocated = 0;
+    u32 count = 0;
+    while(FileSystemReadLine(&handle, &allocated)){
+        u64 length = StringLength(allocated);
+        characters += length;
+        DFree(allocated, length + 1, MEMORY_TAG_STRING);
+        count++;
+    }
+    ClockUpdate(&timer);
+    f64 allocating_seconds = timer.elapsed;
+    FileSystemClose(&handle);
+    ExpectIntEquals(BENCH_LINE_COUNT, count);
+
+    static char buffer[KiloBytes(64)];
+    ExpectTrue(FileSystemOpen(BENCH_LINES_PATH, FILE_MODE_READ, true, &handle));
+    ClockStart(&timer);
+    FileLineReader reader;
+    FileLineReaderCreate(&handle, buffer, sizeof(buffer), &reader);
+    StringView view;
+    count = 0;
+    while(FileLineReaderNext(&reader, &view)){
+        characters += view.length;
+        count++;
+    }
+    ClockUpdate(&timer);
+    f64 reader_seconds = timer.elapsed;
+    FileSystemClose(&handle);
+    ExpectIntEquals(BENCH_LINE_COUNT, count);
+
+    FileMapping mapping;
+    ExpectTrue(FileSystemMap(BENCH_LINES_PATH, FILE_ACCESS_SEQUENTIAL, &mapping));
+    ClockStart(&timer);
+    FileLineReaderCreateFromView(StringViewCreate((char*)mapping.data, mapping.size), &reader);
+    count = 0;
+    while(FileLineReaderNext(&reader, &view)){
+        characters += view.length;
+        count++;
+    }
+    ClockUpdate(&timer);
+    f64 mapped_seconds = timer.elapsed;
+    FileSystemUnmap(&mapping);
+    ExpectIntEquals(BENCH_LINE_COUNT, count);
+    remove(BENCH_LINES_PATH);
+
+    char allocating_ms[STRING_NUMBER_MAX_LENGTH];
+    char reader_ms[STRING_NUMBER_MAX_LENGTH];
+    char mapped_ms[STRING_NUMBER_MAX_LENGTH];
+    StringFromF64Fixed(allocating_ms, allocating_seconds * 1000.0, 2);
+    StringFromF64Fixed(reader_ms, reader_seconds * 1000.0, 2);
+    StringFromF64Fixed(mapped_ms, mapped_seconds * 1000.0, 2);
+    DINFO("%u lines (%llu characters read): FileSystemReadLine %s ms, FileLineReader %s ms, over a mapping %s ms",
+          BENCH_LINE_COUNT, characters, allocating_ms, reader_ms, mapped_ms);
+    return true;
+}
+
+void FileSystemRegisterBenchmarks(){
+    RegisterTest(FileSystemBench_ReadLines, "FileSystemBench_ReadLines");
+}
@@ -0,0 +1,131 @@
+#include "filesystem_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <platform/filesystem.h>
+#include <core/logger.h>
+#include <core/dstring.h>
+
+#include <stdio.h>
+
+#define FILESYSTEM_TEST_PATH "filesystem_map_test.bin"
+
+static b8 WriteTestFile(u8* data, u64 size){
+    FileHandle handle;
+    if(!FileSystemOpen(FILESYSTEM_TEST_PATH, FILE_MODE_WRITE, true, &handle)){
+        return false;
+    }
+    u64 written = 0;
+    b8 result = size == 0 || FileSystemWrite(&handle, size, data, &written);
+    FileSystemClose(&handle);
+    return result && written == size;
+}
+
+u8 FileSystem_MapMatchesFileContents(){
+    //spans several pages so the view isn't just the first one
+    static u8 data[3 * 4096 + 123];
+    for(u32 i = 0; i < sizeof(data); i++){
+        data[i] = (u8)(i * 31 + 7);
+    }
+    ExpectTrue(WriteTestFile(data, sizeof(data)));
+
+    for(u32 hint = FILE_ACCESS_NORMAL; hint <= FILE_ACCESS_RANDOM; hint++){
+        FileMapping mapping;
+        ExpectTrue(FileSystemMap(FILESYSTEM_TEST_PATH, (FileAccessHint)hint, &mapping));
+        ExpectIntEquals(sizeof(data), mapping.size);
+        ExpectIntEquals(0, ((u64)mapping.data) % 4096);
+        u8* mapped = (u8*)mapping.data;
+        u32 mismatches = 0;
+        for(u32 i = 0; i < sizeof(data); i++){
+            mismatches += mapped[i] != data[i];
+        }
+        ExpectIntEquals(0, mismatches);
+        FileSystemUnmap(&mapping);
+        ExpectTrue(mapping.data == 0);
+        ExpectIntEquals(0, mapping.size);
+    }
+    remove(FILESYSTEM_TEST_PATH);
+    return true;
+}
+
+u8 FileSystem_MapEmptyAndMissingFiles(){
+    ExpectTrue(WriteTestFile(0, 0));
+    FileMapping mapping;
+    ExpectTrue(FileSystemMap(FILESYSTEM_TEST_PATH, FILE_ACCESS_NORMAL, &mapping));
+    ExpectTrue(mapping.data == 0);
+    ExpectIntEquals(0, mapping.size);
+    FileSystemUnmap(&mapping);
+    remove(FILESYSTEM_TEST_PATH);
+
+    DDEBUG("Note: The following error is intentionally caused by this test.");
+    ExpectFalse(FileSystemMap("this_file_does_not_exist.bin", FILE_ACCESS_NORMAL, &mapping));
+    ExpectTrue(mapping.data == 0);
+    return true;
+}
+
+//Reads every line of the test file through a buffer of capacity bytes into out_joined, each followed by '|'
+static u32 ReadLinesJoined(u64 capacity, char* out_joined, u32* out_partial_count){
+    char buffer[64];
+    FileHandle handle;
+    FileSystemOpen(FILESYSTEM_TEST_PATH, FILE_MODE_READ, true, &handle);
+    FileLineReader reader;
+    FileLineReaderCreate(&handle, buffer, capacity, &reader);
+    StringView line;
+    u32 count = 0;
+    u64 length = 0;
+    *out_partial_count = 0;
+    while(FileLineReaderNext(&reader, &line)){
+        for(u64 i = 0; i < line.length; i++){
+            out_joined[length++] = line.str[i];
+        }
+        out_joined[length++] = '|';
+        *out_partial_count += reader.partial;
+        count++;
+    }
+    out_joined[length] = 0;
+    FileSystemClose(&handle);
+    return count;
+}
+
+u8 FileSystem_LineReaderHandlesBlockBoundaries(){
+    char text[] = "first line\r\nsecond\n\nthis line is longer than sixteen\nlast without newline";
+    ExpectTrue(WriteTestFile((u8*)text, sizeof(text) - 1));
+    char joined[256];
+    u32 partial_count;
+
+    //every line fits in 64 bytes, the file doesn't, so the later lines straddle a refill
+    ExpectIntEquals(5, ReadLinesJoined(64, joined, &partial_count));
+    ExpectTrue(StringsEqual(joined, "first line|second||this line is longer than sixteen|last without newline|"));
+    ExpectIntEquals(0, partial_count);
+
+    //lines longer than the buffer come back in pieces, one ending right at a block leaves an empty last piece
+    ExpectIntEquals(8, ReadLinesJoined(16, joined, &partial_count));
+    ExpectTrue(StringsEqual(joined, "first line|second||this line is lon|ger than sixteen||last without new|line|"));
+    ExpectIntEquals(3, partial_count);
+
+    //the same lines from a mapped view
+    FileMapping mapping;
+    ExpectTrue(FileSystemMap(FILESYSTEM_TEST_PATH, FILE_ACCESS_SEQUENTIAL, &mapping));
+    FileLineReader reader;
+    FileLineReaderCreateFromView(StringViewCreate((char*)mapping.data, mapping.size), &reader);
+    StringView line;
+    u32 count = 0;
+    while(FileLineReaderNext(&reader, &line)){
+        count++;
+    }
+    ExpectIntEquals(5, count);
+    ExpectTrue(StringViewsEqual(line, StringViewFromCStr("last without newline")));
+    FileSystemUnmap(&mapping);
+
+    ExpectTrue(WriteTestFile(0, 0));
+    ExpectIntEquals(0, ReadLinesJoined(16, joined, &partial_count));
+    remove(FILESYSTEM_TEST_PATH);
+    return true;
+}
+
+void FileSystemRegisterTests(){
+    RegisterTest(FileSystem_MapMatchesFileContents, "FileSystem_MapMatchesFileContents");
+    RegisterTest(FileSystem_MapEmptyAndMissingFiles, "FileSystem_MapEmptyAndMissingFiles");
+    RegisterTest(FileSystem_LineReaderHandlesBlockBoundaries, "FileSystem_LineReaderHandlesBlockBoundaries");
+}
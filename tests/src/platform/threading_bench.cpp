@@ -0,0 +1,96 @@
+#include "threading_bench.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <platform/threading.h>
+#include <core/datomic.h>
+#include <core/clock.h>
+#include <core/logger.h>
+#include <core/dstring.h>
+
+//Cost of the sync primitives with nobody else around, and the round trip of waking another thread
+
+#define BENCH_UNCONTENDED_ITERATIONS 2000000
+#define BENCH_PING_PONG_ROUND_TRIPS 20000
+
+static void ReportNanoseconds(char* name, f64 seconds, u64 operations){
+    char time[STRING_NUMBER_MAX_LENGTH];
+    StringFromF64Fixed(time, seconds * 1000000000.0 / operations, 1);
+    DINFO("  %s: %s ns", name, time);
+}
+
+u8 ThreadingBench_Uncontended(){
+    Clock timer = {};
+
+    Mutex mutex;
+    MutexCreate(&mutex);
+    ClockStart(&timer);
+    for(u32 i = 0; i < BENCH_UNCONTENDED_ITERATIONS; i++){
+        MutexLock(&mutex);
+        MutexUnlock(&mutex);
+    }
+    ClockUpdate(&timer);
+    ReportNanoseconds("mutex lock/unlock      ", timer.elapsed, BENCH_UNCONTENDED_ITERATIONS);
+    MutexDestroy(&mutex);
+
+    Semaphore semaphore;
+    SemaphoreCreate(0, &semaphore);
+    ClockStart(&timer);
+    for(u32 i = 0; i < BENCH_UNCONTENDED_ITERATIONS; i++){
+        SemaphoreSignal(&semaphore, 1);
+        SemaphoreWait(&semaphore, PLATFORM_WAIT_INFINITE);
+    }
+    ClockUpdate(&timer);
+    ReportNanoseconds("semaphore signal/wait  ", timer.elapsed, BENCH_UNCONTENDED_ITERATIONS);
+    ExpectIntEquals(0, semaphore.count);
+    SemaphoreDestroy(&semaphore);
+
+    u32 counter = 0;
+    ClockStart(&timer);
+    for(u32 i = 0; i < BENCH_UNCONTENDED_ITERATIONS; i++){
+        AtomicFetchAddU32(&counter, 1);
+    }
+    ClockUpdate(&timer);
+    ReportNanoseconds("atomic fetch add       ", timer.elapsed, BENCH_UNCONTENDED_ITERATIONS);
+    ExpectIntEquals(BENCH_UNCONTENDED_ITERATIONS, counter);
+    return true;
+}
+
+struct PingPong{
+    Semaphore ping;
+    Semaphore pong;
+};
+
+static u32 Ponger(void* params){
+    PingPong* ping_pong = (PingPong*)params;
+    for(u32 i = 0; i < BENCH_PING_PONG_ROUND_TRIPS; i++){
+        SemaphoreWait(&ping_pong->ping, PLATFORM_WAIT_INFINITE);
+        SemaphoreSignal(&ping_pong->pong, 1);
+    }
+    return 0;
+}
+
+u8 ThreadingBench_SemaphorePingPong(){
+    PingPong ping_pong;
+    SemaphoreCreate(0, &ping_pong.ping);
+    SemaphoreCreate(0, &ping_pong.pong);
+    Thread thread;
+    ExpectTrue(ThreadCreate(Ponger, &ping_pong, false, &thread));
+
+    Clock timer = {};
+    ClockStart(&timer);
+    for(u32 i = 0; i < BENCH_PING_PONG_ROUND_TRIPS; i++){
+        SemaphoreSignal(&ping_pong.ping, 1);
+        SemaphoreWait(&ping_pong.pong, PLATFORM_WAIT_INFINITE);
+    }
+    ClockUpdate(&timer);
+    ThreadJoin(&thread, 0);
+    ReportNanoseconds("semaphore ping-pong round trip", timer.elapsed, BENCH_PING_PONG_ROUND_TRIPS);
+    return true;
+}
+
+void ThreadingRegisterBenchmarks(){
+    RegisterTest(ThreadingBench_Uncontended, "ThreadingBench_Uncontended");
+    RegisterTest(ThreadingBench_SemaphorePingPong, "ThreadingBench_SemaphorePingPong");
+}
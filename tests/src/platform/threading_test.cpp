@@ -0,0 +1,189 @@
+#include "threading_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+#include <platform/threading.h>
+#include <core/datomic.h>
+#include <core/logger.h>
+
+static u32 ReturnParam(void* params){
+    return (u32)(u64)params;
+}
+
+u8 Threading_JoinReturnsExitCode(){
+    Thread thread;
+    ExpectTrue(ThreadCreate(ReturnParam, (void*)42, false, &thread));
+    ThreadSetName(&thread, "a name longer than linux allows");
+    u32 exit_code = 0;
+    ExpectTrue(ThreadJoin(&thread, &exit_code));
+    ExpectIntEquals(42, exit_code);
+    ExpectFalse(ThreadJoin(&thread, &exit_code));
+    //nothing left to name once joined, the same as an auto detached thread
+    DDEBUG("Note: The following warning is intentionally caused by this test.");
+    ExpectFalse(ThreadSetName(&thread, "joined"));
+    return true;
+}
+
+struct CounterParams{
+    Mutex mutex;
+    u32 locked_count;
+    u32 atomic_count;
+};
+
+#define COUNTER_ITERATIONS 20000
+
+static u32 IncrementCounters(void* params){
+    CounterParams* counters = (CounterParams*)params;
+    for(u32 i = 0; i < COUNTER_ITERATIONS; i++){
+        MutexLock(&counters->mutex);
+        counters->locked_count++;
+        MutexUnlock(&counters->mutex);
+        AtomicFetchAddU32(&counters->atomic_count, 1);
+    }
+    return 0;
+}
+
+u8 Threading_MutexAndAtomicsCountEveryIncrement(){
+    CounterParams counters = {};
+    ExpectTrue(MutexCreate(&counters.mutex));
+    Thread threads[4];
+    for(u32 i = 0; i < ArrayCount(threads); i++){
+        ExpectTrue(ThreadCreate(IncrementCounters, &counters, false, &threads[i]));
+    }
+    for(u32 i = 0; i < ArrayCount(threads); i++){
+        ThreadJoin(&threads[i], 0);
+    }
+    ExpectIntEquals(COUNTER_ITERATIONS * ArrayCount(threads), counters.locked_count);
+    ExpectIntEquals(COUNTER_ITERATIONS * ArrayCount(threads), counters.atomic_count);
+
+    ExpectTrue(MutexTryLock(&counters.mutex));
+    MutexUnlock(&counters.mutex);
+    MutexDestroy(&counters.mutex);
+    return true;
+}
+
+u8 Threading_SemaphoreCountsAndTimesOut(){
+    Semaphore semaphore;
+    SemaphoreCreate(2, &semaphore);
+    ExpectTrue(SemaphoreWait(&semaphore, 0));
+    ExpectTrue(SemaphoreWait(&semaphore, PLATFORM_WAIT_INFINITE));
+    ExpectFalse(SemaphoreWait(&semaphore, 0));
+    ExpectFalse(SemaphoreWait(&semaphore, 5));
+    SemaphoreSignal(&semaphore, 1);
+    ExpectTrue(SemaphoreWait(&semaphore, 5));
+    SemaphoreDestroy(&semaphore);
+    return true;
+}
+
+struct HandoffParams{
+    Mutex mutex;
+    ConditionVariable condition;
+    Semaphore started;
+    u32 value;
+};
+
+static u32 WaitForValue(void* params){
+    HandoffParams* handoff = (HandoffParams*)params;
+    MutexLock(&handoff->mutex);
+    SemaphoreSignal(&handoff->started, 1);
+    while(handoff->value == 0){
+        ConditionVariableWait(&handoff->condition, &handoff->mutex, PLATFORM_WAIT_INFINITE);
+    }
+    u32 value = handoff->value;
+    MutexUnlock(&handoff->mutex);
+    return value;
+}
+
+u8 Threading_ConditionVariableWakesWaiter(){
+    HandoffParams handoff = {};
+    ExpectTrue(MutexCreate(&handoff.mutex));
+    ExpectTrue(ConditionVariableCreate(&handoff.condition));
+
+    MutexLock(&handoff.mutex);
+    ExpectFalse(ConditionVariableWait(&handoff.condition, &handoff.mutex, 1));
+    MutexUnlock(&handoff.mutex);
+
+    Thread thread;
+    ExpectTrue(ThreadCreate(WaitForValue, &handoff, false, &thread));
+    SemaphoreWait(&handoff.started, PLATFORM_WAIT_INFINITE);
+    MutexLock(&handoff.mutex);
+    handoff.value = 7;
+    ConditionVariableSignal(&handoff.condition);
+    MutexUnlock(&handoff.mutex);
+
+    u32 exit_code = 0;
+    ThreadJoin(&thread, &exit_code);
+    ExpectIntEquals(7, exit_code);
+    ConditionVariableDestroy(&handoff.condition);
+    MutexDestroy(&handoff.mutex);
+    return true;
+}
+
+u8 Threading_TopologyIsConsistent(){
+    CpuTopology topology;
+    ExpectTrue(CpuGetTopology(&topology));
+    DINFO("Cpu topology: %u logical, %u physical, %u numa nodes, l1d %llu, l2 %llu, l3 %llu, line %u", topology.logical_cores,
+          topology.physical_cores, topology.numa_nodes, topology.l1_data_cache_size, topology.l2_cache_size,
+          topology.l3_cache_size, topology.cache_line_size);
+    ExpectTrue(topology.logical_cores >= 1);
+    ExpectTrue(topology.physical_cores >= 1 && topology.physical_cores <= topology.logical_cores);
+    ExpectTrue(topology.numa_nodes >= 1);
+    ExpectIntEquals(topology.logical_cores, CpuSetCount(&topology.online));
+    for (u32 cpu = 0; cpu < PLATFORM_MAX_CPUS; cpu++) {
+        if (CpuSetContains(&topology.online, cpu)) {
+            ExpectTrue(topology.core_index[cpu] < topology.physical_cores);
+            ExpectTrue(topology.numa_node[cpu] < PLATFORM_MAX_CPUS);
+        }
+    }
+    return true;
+}
+
+static u32 WaitForRelease(void* params){
+    SemaphoreWait((Semaphore*)params, PLATFORM_WAIT_INFINITE);
+    return 0;
+}
+
+//Pins the calling thread, on a thread of its own so the test runner keeps whatever affinity it was given
+static u32 PinSelf(void* params){
+    return ThreadSetAffinity(0, (CpuSet*)params) ? 1 : 0;
+}
+
+u8 Threading_AffinityAndPriorityApply(){
+    CpuTopology topology;
+    ExpectTrue(CpuGetTopology(&topology));
+    u32 first_cpu = 0;
+    while (!CpuSetContains(&topology.online, first_cpu)) {
+        first_cpu++;
+    }
+    CpuSet single;
+    CpuSetClear(&single);
+    CpuSetAdd(&single, first_cpu);
+    Thread pinned;
+    ExpectTrue(ThreadCreate(PinSelf, &single, false, &pinned));
+    u32 pinned_self = 0;
+    ExpectTrue(ThreadJoin(&pinned, &pinned_self));
+    ExpectIntEquals(1, pinned_self);
+
+    Semaphore release;
+    SemaphoreCreate(0, &release);
+    Thread thread;
+    ExpectTrue(ThreadCreate(WaitForRelease, &release, false, &thread));
+    ExpectIntNotEquals(0, thread.thread_id);
+    ExpectTrue(ThreadSetAffinity(&thread, &single));
+    //lowering is always allowed, raising may not be so it isn't checked
+    ExpectTrue(ThreadSetPriority(&thread, THREAD_PRIO_LOW));
+    SemaphoreSignal(&release, 1);
+    ExpectTrue(ThreadJoin(&thread, 0));
+    SemaphoreDestroy(&release);
+    return true;
+}
+
+void ThreadingRegisterTests(){
+    RegisterTest(Threading_JoinReturnsExitCode, "Threading_JoinReturnsExitCode");
+    RegisterTest(Threading_MutexAndAtomicsCountEveryIncrement, "Threading_MutexAndAtomicsCountEveryIncrement");
+    RegisterTest(Threading_SemaphoreCountsAndTimesOut, "Threading_SemaphoreCountsAndTimesOut");
+    RegisterTest(Threading_ConditionVariableWakesWaiter, "Threading_ConditionVariableWakesWaiter");
+    RegisterTest(Threading_TopologyIsConsistent, "Threading_TopologyIsConsistent");
+    RegisterTest(Threading_AffinityAndPriorityApply, "Threading_AffinityAndPriorityApply");
+}
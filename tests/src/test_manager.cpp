@@ -14,6 +14,7 @@ static TestEntry* tests;
 
 void TestManagerInit(){
     tests = (TestEntry*)DarrayCreate(TestEntry);
+    ClockCalibrateTicks();
 }
 
 void RegisterTest(u8 (*PFN_test)(), char* desc){
@@ -48,9 +49,13 @@ void RunTests(){
             failed++;
         }
         char status[20];
-        StringFormat(status, failed ? (char*)"*** %d FAILED ***" : (char*)"SUCCESS", failed);
+        StringFormatN(status, sizeof(status), failed ? (char*)"*** %d FAILED ***" : (char*)"SUCCESS", failed);
         ClockUpdate(&totalTime);
-        DINFO("Executed %d of %d (skipped %d) %s (%.6f sec / %.6f sec total)", i+1, count, skipped, status, testTime.elapsed, totalTime.elapsed);
+        char testSeconds[STRING_NUMBER_MAX_LENGTH];
+        char totalSeconds[STRING_NUMBER_MAX_LENGTH];
+        StringFromF64Fixed(testSeconds, testTime.elapsed, 6);
+        StringFromF64Fixed(totalSeconds, totalTime.elapsed, 6);
+        DINFO("Executed %d of %d (skipped %d) %s (%s sec / %s sec total)", i+1, count, skipped, status, testSeconds, totalSeconds);
     }
 
     ClockStop(&totalTime);